@@ -0,0 +1,112 @@
+#!/bin/bash
+# Copyright (C) 2026 Free Software Foundation
+#
+# Measure how the time taken by cc1plus to look up names grows with
+# the size of the scopes, on generated sources.
+#
+# See usage() below.
+
+usage () {
+    cat <<EOF >&2
+Usage:
+    cp-lookup-bench.sh [-n <runs>] [-s <sizes>] <cc1plus>...
+    For each kind of scope below and each of the <sizes> (a quoted
+    list, "1000 4000 16000" by default), generate a source in which
+    names are declared in and looked up from a scope of that size, and
+    compile it with -fsyntax-only using each <cc1plus>, <runs> times
+    (3 by default).  The best user time of the runs is printed.
+      namespaces  the same names declared in <size> namespaces
+      fields      a class with <size> data members
+      methods     a class with <size> member functions
+      typedefs    a class with <size> member typedefs
+      bases       a chain of <size>/40 classes with 40 members each
+EOF
+}
+
+runs=3
+sizes="1000 4000 16000"
+while test $# -gt 0; do
+    case "$1" in
+	-n) runs=$2; shift 2 ;;
+	-s) sizes=$2; shift 2 ;;
+	*) break ;;
+    esac
+done
+
+if test $# -eq 0; then
+    usage
+    exit 1
+fi
+
+# Generate the source for the scope KIND of size N on stdout.
+generate () {
+    awk -v kind=$1 -v n=$2 'BEGIN {
+	if (kind == "namespaces") {
+	    for (i = 0; i < n; i++)
+		printf "namespace n%d { int x; int y; }\n", i;
+	    print "int f () { int s = 0;";
+	    for (i = 0; i < 20000; i++)
+		printf " s += n%d::x + n%d::y;\n", i * 7 % n, i * 13 % n;
+	    print " return s; }";
+	} else if (kind == "fields" || kind == "methods") {
+	    print "struct S {";
+	    for (i = 0; i < n; i++)
+		printf (kind == "fields" ? " int m%d;\n" : " int m%d ();\n"), i;
+	    print " int f (); };";
+	    print "int S::f () { int s = 0;";
+	    for (i = 0; i < 20000; i++)
+		printf (kind == "fields" ? " s += m%d;\n" : " s += m%d ();\n"),
+		       i * 7 % n;
+	    print " return s; }";
+	} else if (kind == "typedefs") {
+	    print "struct S {";
+	    for (i = 0; i < n; i++)
+		printf " typedef int t%d;\n", i;
+	    print "};";
+	} else if (kind == "bases") {
+	    d = int (n / 40);
+	    for (i = 0; i < d; i++) {
+		printf "struct B%d", i;
+		if (i)
+		    printf " : B%d", i - 1;
+		printf " {";
+		for (j = 0; j < 40; j++)
+		    printf " int m%d_%d;", i, j;
+		print " };";
+	    }
+	    printf "struct D : B%d {\n", d - 1;
+	    for (i = 0; i < 200; i++) {
+		printf " int f%d () { return 0", i;
+		for (j = 0; j < 20; j++)
+		    printf " + m%d_%d", (i + j) % d, j;
+		print "; }";
+	    }
+	    print "};";
+	}
+    }'
+}
+
+src=`mktemp /tmp/cp-lookup-bench.XXXXXX.cc` || exit 1
+trap 'rm -f "$src"' 0
+
+TIMEFORMAT=%U
+for kind in namespaces fields methods typedefs bases; do
+    for size in $sizes; do
+	generate $kind $size > "$src"
+	declare -A best=()
+	for run in `seq $runs`; do
+	    for cc1 in "$@"; do
+		t=`{ time "$cc1" -quiet -fsyntax-only "$src" -o /dev/null \
+			 || exit 1; } 2>&1 >/dev/null | tail -n 1`
+		if test -z "${best[$cc1]}" \
+		    || awk "BEGIN { exit !($t < ${best[$cc1]}) }"; then
+		    best[$cc1]=$t
+		fi
+	    done
+	done
+	for cc1 in "$@"; do
+	    printf "%-10s %6d %8ss  %s\n" $kind $size "${best[$cc1]}" "$cc1"
+	done
+	unset best
+    done
+done
@@ -0,0 +1,72 @@
+#!/bin/bash
+# Copyright (C) 2026 Free Software Foundation
+#
+# Compare the time taken by compilers proper to preprocess and to
+# compile a corpus of (large) files, typically sources including many
+# system headers, or the headers themselves.
+#
+# See usage() below.
+
+usage () {
+    cat <<EOF >&2
+Usage:
+    cpp-lexer-bench.sh [-n <runs>] [-c] <cc1>... -- [<flag>...] -- <file>...
+    Each <cc1> (cc1, cc1plus, ...) preprocesses every <file> with -E,
+    passing it the <flag>s, <runs> times (5 by default).  With -c, it
+    also compiles every <file> with -fsyntax-only.
+    The best user time of the runs is printed for each <cc1> and test.
+    The compilers are run in turn, to spread any noise on all of them.
+EOF
+}
+
+runs=5
+compile=no
+while test $# -gt 0; do
+    case "$1" in
+	-n) runs=$2; shift 2 ;;
+	-c) compile=yes; shift ;;
+	*) break ;;
+    esac
+done
+
+compilers=()
+while test $# -gt 0 && test "$1" != "--"; do
+    compilers+=("$1")
+    shift
+done
+test $# -gt 0 && shift
+flags=()
+while test $# -gt 0 && test "$1" != "--"; do
+    flags+=("$1")
+    shift
+done
+test $# -gt 0 && shift
+
+if test ${#compilers[@]} -eq 0 || test $# -eq 0; then
+    usage
+    exit 1
+fi
+
+tests="-E"
+test $compile = yes && tests="$tests -fsyntax-only"
+
+TIMEFORMAT=%U
+for test in $tests; do
+    declare -A best=()
+    for run in `seq $runs`; do
+	for cc1 in "${compilers[@]}"; do
+	    t=`{ time for file in "$@"; do
+		     "$cc1" -quiet "${flags[@]}" $test "$file" -o /dev/null \
+			 || exit 1
+		 done; } 2>&1 >/dev/null | tail -n 1`
+	    if test -z "${best[$cc1]}" \
+		|| awk "BEGIN { exit !($t < ${best[$cc1]}) }"; then
+		best[$cc1]=$t
+	    fi
+	done
+    done
+    for cc1 in "${compilers[@]}"; do
+	printf "%-14s %8ss  %s\n" "$test" "${best[$cc1]}" "$cc1"
+    done
+    unset best
+done
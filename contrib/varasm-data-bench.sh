@@ -0,0 +1,103 @@
+#!/bin/bash
+# Copyright (C) 2026 Free Software Foundation
+#
+# Measure the time taken by cc1 and by the assembler to output large
+# constant arrays, with and without the byte run output of varasm.
+#
+# See usage() below.
+
+usage () {
+    cat <<EOF2 >&2
+Usage:
+    varasm-data-bench.sh [-n <runs>] [-s <size>] <cc1>
+    For each kind of table below, generate a C source with a constant
+    array of <size> bytes (8 MB by default) and compile it at -O2 with
+    <cc1>, once with --param min-byte-run-constant-size=1024 and once
+    with byte runs disabled, <runs> times (3 by default).  The best
+    user times of cc1 and of as, and the size of the assembly, are
+    printed.
+      char     unsigned char elements
+      int      int elements
+      double   double elements
+      sparse   int elements, one in 16 of which is not zero
+EOF2
+}
+
+runs=3
+size=8388608
+while test $# -gt 0; do
+    case "$1" in
+	-n) runs=$2; shift 2 ;;
+	-s) size=$2; shift 2 ;;
+	*) break ;;
+    esac
+done
+
+if test $# -ne 1; then
+    usage
+    exit 1
+fi
+cc1=$1
+
+# Generate the source for the table KIND of SIZE bytes on stdout.
+generate () {
+    awk -v kind=$1 -v size=$2 'BEGIN {
+	if (kind == "char") {
+	    type = "unsigned char"; n = size;
+	} else if (kind == "double") {
+	    type = "double"; n = size / 8;
+	} else {
+	    type = "int"; n = size / 4;
+	}
+	printf "const %s table[%d] = {\n", type, n;
+	x = 12345;
+	for (i = 0; i < n; i++) {
+	    x = (x * 1103515245 + 12345) % 2147483648;
+	    if (kind == "char")
+		printf "%d,", x % 256;
+	    else if (kind == "double")
+		printf "%.17g,", x / 65536.0;
+	    else if (kind == "sparse")
+		printf "%d,", i % 16 ? 0 : x;
+	    else
+		printf "%d,", x - 1073741824;
+	    if (i % 16 == 15)
+		printf "\n";
+	}
+	print "};";
+    }'
+}
+
+tmp=`mktemp -d /tmp/varasm-data-bench.XXXXXX` || exit 1
+trap 'rm -rf "$tmp"' 0
+
+# Print the best user time of <runs> runs of the command.
+best_time () {
+    local best= t run
+    TIMEFORMAT=%U
+    for run in `seq $runs`; do
+	t=`{ time "$@" >/dev/null || exit 1; } 2>&1 | tail -n 1`
+	if test -z "$best" || awk "BEGIN { exit !($t < $best) }"; then
+	    best=$t
+	fi
+    done
+    echo $best
+}
+
+printf "%-8s %-9s %8s %8s %10s\n" table output cc1 as asm-bytes
+for kind in char int double sparse; do
+    generate $kind $size > "$tmp/t.c"
+    for mode in runs directives; do
+	if test $mode = runs; then
+	    param=1024
+	else
+	    param=2147483647
+	fi
+	t1=`best_time "$cc1" -quiet -O2 \
+		--param min-byte-run-constant-size=$param \
+		"$tmp/t.c" -o "$tmp/t.s"`
+	t2=`best_time as "$tmp/t.s" -o "$tmp/t.o"`
+	printf "%-8s %-9s %7ss %7ss %10d\n" $kind $mode $t1 $t2 \
+	       `wc -c < "$tmp/t.s"`
+    done
+done
@@ -0,0 +1,142 @@
+/* Function-scoped memory arenas.
+   Copyright (C) 2011 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "config.h"
+#include "system.h"
+#include "coretypes.h"
+#include "arena.h"
+
+/* All arenas created so far.  */
+static function_arena arenas;
+
+/* The function the arenas currently hold memory for, if any.  */
+static struct function *arena_function;
+
+/* Create a new arena called NAME.  The arena lives until it is freed
+   with free_function_arena; its contents are released whenever the
+   function being compiled is finished.  */
+
+function_arena
+create_function_arena (const char *name)
+{
+  function_arena arena = XCNEW (struct function_arena_def);
+
+  arena->name = name;
+  gcc_obstack_init (&arena->obstack);
+  arena->firstobj = XOBNEWVAR (&arena->obstack, char, 0);
+  arena->next = arenas;
+  arenas = arena;
+  return arena;
+}
+
+/* Free ARENA and everything allocated from it.  */
+
+void
+free_function_arena (function_arena arena)
+{
+  function_arena *p;
+
+  for (p = &arenas; *p != arena; p = &(*p)->next)
+    gcc_assert (*p);
+  *p = arena->next;
+
+  obstack_free (&arena->obstack, NULL);
+  free (arena);
+}
+
+/* Allocate SIZE bytes from ARENA.  */
+
+void *
+function_arena_alloc (function_arena arena, size_t size)
+{
+  arena->current += size;
+  arena->allocated += size;
+  if (arena->current > arena->peak)
+    arena->peak = arena->current;
+  return obstack_alloc (&arena->obstack, size);
+}
+
+/* Allocate SIZE bytes from ARENA and clear them.  */
+
+void *
+function_arena_alloc_cleared (function_arena arena, size_t size)
+{
+  void *p = function_arena_alloc (arena, size);
+
+  memset (p, 0, size);
+  return p;
+}
+
+/* Note that passes are about to run on FN.  Passes only switch between
+   functions at pass list boundaries, so whatever the arenas still hold
+   for another function is dead and can be released.  */
+
+void
+claim_function_arenas (struct function *fn)
+{
+  if (arena_function != fn)
+    release_function_arenas ();
+  arena_function = fn;
+}
+
+/* Release the contents of all arenas.  */
+
+void
+release_function_arenas (void)
+{
+  function_arena arena;
+
+  for (arena = arenas; arena; arena = arena->next)
+    if (arena->current)
+      {
+	obstack_free (&arena->obstack, arena->firstobj);
+	arena->firstobj = XOBNEWVAR (&arena->obstack, char, 0);
+	arena->current = 0;
+	arena->releases++;
+      }
+
+  arena_function = NULL;
+}
+
+/* Print statistics for all arenas to stderr.  */
+
+void
+dump_function_arena_statistics (void)
+{
+  function_arena arena;
+  size_t total_allocated = 0;
+  unsigned long total_releases = 0;
+
+  if (!arenas)
+    return;
+
+  fprintf (stderr, "\nFunction arena                   Allocated       Peak   Releases\n");
+  fprintf (stderr, "---------------------------------------------------------------\n");
+  for (arena = arenas; arena; arena = arena->next)
+    {
+      fprintf (stderr, "%-30s %11lu %10lu %10lu\n", arena->name,
+	       (unsigned long) arena->allocated, (unsigned long) arena->peak,
+	       arena->releases);
+      total_allocated += arena->allocated;
+      total_releases += arena->releases;
+    }
+  fprintf (stderr, "---------------------------------------------------------------\n");
+  fprintf (stderr, "%-30s %11lu %10s %10lu\n", "Total",
+	   (unsigned long) total_allocated, "", total_releases);
+}
@@ -0,0 +1,70 @@
+/* Function-scoped memory arenas.
+   Copyright (C) 2011 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef GCC_ARENA_H
+#define GCC_ARENA_H
+
+#include "obstack.h"
+
+struct function;
+
+/* A function arena hands out memory for temporaries that die, at the
+   latest, when the function being compiled is finished.  Nothing is
+   freed individually; execute_one_pass releases every arena at once
+   after the last pass for a function has run, or when it starts
+   running passes on a different function.  Memory from an arena is
+   not known to the garbage collector, so it must never be reachable
+   from GC roots, and it must not hold the only reference to a GC
+   object that is still needed after the next collection.  */
+
+typedef struct function_arena_def
+{
+  /* Name of the arena, for -fmem-report.  */
+  const char *name;
+
+  /* The storage itself, and the first object on it.  Releasing the
+     arena frees everything allocated after FIRSTOBJ.  */
+  struct obstack obstack;
+  char *firstobj;
+
+  /* Statistics, in bytes.  */
+  size_t current;
+  size_t peak;
+  size_t allocated;
+  unsigned long releases;
+
+  /* Chain of all arenas.  */
+  struct function_arena_def *next;
+} *function_arena;
+
+extern function_arena create_function_arena (const char *);
+extern void free_function_arena (function_arena);
+extern void *function_arena_alloc (function_arena, size_t);
+extern void *function_arena_alloc_cleared (function_arena, size_t);
+extern void claim_function_arenas (struct function *);
+extern void release_function_arenas (void);
+extern void dump_function_arena_statistics (void);
+
+#define ARENA_NEW(A, T) ((T *) function_arena_alloc ((A), sizeof (T)))
+#define ARENA_CNEW(A, T) \
+  ((T *) function_arena_alloc_cleared ((A), sizeof (T)))
+#define ARENA_NEWVEC(A, T, N) \
+  ((T *) function_arena_alloc ((A), sizeof (T) * (N)))
+
+#endif /* GCC_ARENA_H */
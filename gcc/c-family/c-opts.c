@@ -597,6 +597,10 @@ c_common_handle_option (size_t scode, const char *arg, int value,
       cpp_opts->extended_identifiers = value;
       break;
 
+    case OPT_fmacro_expansion_cache:
+      cpp_opts->expansion_cache = value;
+      break;
+
     case OPT_fgnu_runtime:
       flag_next_runtime = !value;
       break;
@@ -1010,12 +1014,6 @@ c_common_post_options (const char **pfilename)
     {
       init_c_lex ();
 
-      /* When writing a PCH file, avoid reading some other PCH file,
-	 because the default address space slot then can't be used
-	 for the output PCH file.  */
-      if (pch_file)
-	c_common_no_more_pch ();
-
       /* Yuk.  WTF is this?  I do know ObjC relies on it somewhere.  */
       input_location = UNKNOWN_LOCATION;
     }
@@ -1128,6 +1126,16 @@ c_common_finish (void)
 	}
     }
 
+  if (time_report && cpp_opts->expansion_cache)
+    {
+      unsigned long lookups, hits, forgotten;
+
+      cpp_get_expansion_cache_stats (parse_in, &lookups, &hits, &forgotten);
+      fprintf (stderr, "macro expansion cache: %lu lookups, %lu hits"
+	       " (%.1f%%), %lu entries dropped\n", lookups, hits,
+	       lookups ? hits * 100.0 / lookups : 0.0, forgotten);
+    }
+
   /* For performance, avoid tearing down cpplib's internal structures
      with cpp_destroy ().  */
   cpp_finish (parse_in, deps_stream);
@@ -35,6 +35,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "target.h"
 #include "opts.h"
 #include "timevar.h"
+#include "md5.h"
 
 /* This is a list of flag variables that must match exactly, and their
    names for the error message.  The possible values for *flag_var must
@@ -63,6 +64,8 @@ static const char no_checksum[16] = { 0 };
 
 struct c_pch_validity
 {
+  unsigned char id[16];
+  unsigned char base_id[16];
   unsigned char debug_info_type;
   signed char match[MATCH_SIZE];
   void (*pch_init) (void);
@@ -82,6 +85,11 @@ static FILE *pch_outfile;
 /* The position in the assembler output file when pch_init was called.  */
 static long asm_file_startpos;
 
+/* The identity of the PCH file that was read last, all zero if none
+   was, and of the one c_common_valid_pch accepted last.  */
+static unsigned char loaded_pch_id[16];
+static unsigned char valid_pch_id[16];
+
 static const char *get_ident (void);
 
 /* Compute an appropriate 8-byte magic number for the PCH file, so that
@@ -93,7 +101,7 @@ static const char *
 get_ident (void)
 {
   static char result[IDENT_LENGTH];
-  static const char templ[] = "gpch.013";
+  static const char templ[] = "gpch.014";
   static const char c_language_chars[] = "Co+O";
 
   memcpy (result, templ, IDENT_LENGTH);
@@ -135,6 +143,20 @@ pch_init (void)
   gcc_assert (memcmp (executable_checksum, no_checksum, 16) != 0);
 
   memset (&v, '\0', sizeof (v));
+  {
+    /* Any PCH file built on top of this one records this identity,
+       which only needs to be unique.  */
+    struct md5_ctx ctx;
+    long now = (long) time (NULL);
+    long pid = (long) getpid ();
+
+    md5_init_ctx (&ctx);
+    md5_process_bytes (executable_checksum, 16, &ctx);
+    md5_process_bytes (pch_file, strlen (pch_file), &ctx);
+    md5_process_bytes (&now, sizeof (now), &ctx);
+    md5_process_bytes (&pid, sizeof (pid), &ctx);
+    md5_finish_ctx (&ctx, v.id);
+  }
   v.debug_info_type = write_symbols;
   {
     size_t i;
@@ -218,6 +240,13 @@ c_common_write_pch (void)
   cpp_write_pch_state (parse_in, pch_outfile);
   timevar_pop (TV_PCH_CPP_SAVE);
 
+  /* The PCH file is built on top of whichever PCH file was read while
+     compiling it.  */
+  if (fseek (pch_outfile, IDENT_LENGTH + 16
+	     + offsetof (struct c_pch_validity, base_id), SEEK_SET) != 0
+      || fwrite (loaded_pch_id, 16, 1, pch_outfile) != 1)
+    fatal_error ("can%'t write %s: %m", pch_file);
+
   if (fseek (pch_outfile, 0, SEEK_SET) != 0
       || fwrite (get_ident (), IDENT_LENGTH, 1, pch_outfile) != 1)
     fatal_error ("can%'t write %s: %m", pch_file);
@@ -333,6 +362,19 @@ c_common_valid_pch (cpp_reader *pfile, const char *name, int fd)
       return 2;
     }
 
+  /* Reading a PCH file replaces everything the compiler knows.  Once
+     another PCH file was read, this one is only usable if it was built
+     on top of that one, and so knows everything it did.  */
+  if (memcmp (loaded_pch_id, no_checksum, 16) != 0
+      && memcmp (v.base_id, loaded_pch_id, 16) != 0)
+    {
+      if (cpp_get_options (pfile)->warn_invalid_pch)
+	cpp_error (pfile, CPP_DL_WARNING,
+		   "%s: not built on top of the precompiled header "
+		   "already used", name);
+      return 2;
+    }
+
   /* Check the target-specific validity data.  */
   {
     void *this_file_data = xmalloc (v.target_data_length);
@@ -357,8 +399,34 @@ c_common_valid_pch (cpp_reader *pfile, const char *name, int fd)
   result = cpp_valid_state (pfile, name, fd);
   if (result == -1)
     return 2;
-  else
-    return result == 0;
+  if (result != 0)
+    return 0;
+
+  /* The data of the PCH file can only be loaded at the address it was
+     built for.  Map it there now, and read the header itself instead
+     if something else is there, such as the data of another PCH file
+     or a library placed by address space randomization.  */
+  {
+    off_t pos = lseek (fd, 0, SEEK_CUR);
+    struct c_pch_header h;
+
+    if (pos == (off_t) -1
+	|| read (fd, &h, sizeof (h)) != sizeof (h)
+	|| lseek (fd, h.asm_size, SEEK_CUR) == (off_t) -1)
+      fatal_error ("can%'t read %s: %m", name);
+    if (!gt_pch_reserve (fd))
+      {
+	if (cpp_get_options (pfile)->warn_invalid_pch)
+	  cpp_error (pfile, CPP_DL_WARNING,
+		     "%s: the address of its data is not available", name);
+	return 2;
+      }
+    if (lseek (fd, pos, SEEK_SET) != pos)
+      fatal_error ("can%'t read %s: %m", name);
+  }
+
+  memcpy (valid_pch_id, v.id, 16);
+  return 1;
 }
 
 /* If non-NULL, this function is called after a precompile header file
@@ -388,8 +456,6 @@ c_common_read_pch (cpp_reader *pfile, const char *name,
       goto end;
     }
 
-  cpp_get_callbacks (parse_in)->valid_pch = NULL;
-
   if (fread (&h, sizeof (h), 1, f) != 1)
     {
       cpp_errno (pfile, CPP_DL_ERROR, "reading");
@@ -444,6 +510,8 @@ c_common_read_pch (cpp_reader *pfile, const char *name,
 
   fclose (f);
 
+  memcpy (loaded_pch_id, valid_pch_id, 16);
+
   line_table->trace_includes = saved_trace_includes;
   cpp_set_line_map (pfile, line_table);
   linemap_add (line_table, LC_RENAME, 0, saved_loc.file, saved_loc.line);
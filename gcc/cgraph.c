@@ -99,6 +99,7 @@ The callgraph:
 #include "ipa-utils.h"
 #include "lto-streamer.h"
 #include "ipa-inline.h"
+#include "tree-pass.h"
 
 const char * const ld_plugin_symbol_resolution_names[]=
 {
@@ -1414,6 +1415,7 @@ cgraph_release_function_body (struct cgraph_node *node)
       gimple_set_body (node->decl, NULL);
       VEC_free (ipa_opt_pass, heap,
       		node->ipa_transforms_to_apply);
+      release_function_budget (node->decl);
       /* Struct function hangs a lot of data that would leak if we didn't
          removed all pointers to it.   */
       ggc_free (DECL_STRUCT_FUNCTION (node->decl));
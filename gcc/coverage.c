@@ -320,6 +320,37 @@ read_counts_file (void)
   gcov_close ();
 }
 
+/* Convert the indirect call counters of ENTRY, if they were written
+   before several targets were recorded for each call site, to the
+   EXPECTED counters of the current layout.  The old layout is a
+   (target, count, total) triple per call site.  */
+
+static void
+convert_old_indir_call_counts (counts_entry_t *entry, unsigned expected)
+{
+  unsigned n_sites = expected / GCOV_ICALL_TOPN_NCOUNTS;
+  unsigned ix;
+  gcov_type *counts;
+
+  if (expected % GCOV_ICALL_TOPN_NCOUNTS
+      || entry->summary.num != n_sites * 3)
+    return;
+
+  counts = XCNEWVEC (gcov_type, expected);
+  for (ix = 0; ix < n_sites; ix++)
+    {
+      gcov_type *old_site = entry->counts + 3 * ix;
+      gcov_type *site = counts + GCOV_ICALL_TOPN_NCOUNTS * ix;
+
+      site[0] = old_site[2];
+      site[1] = old_site[0];
+      site[2] = old_site[1];
+    }
+  free (entry->counts);
+  entry->counts = counts;
+  entry->summary.num = expected;
+}
+
 /* Returns the counters for a particular tag.  */
 
 gcov_type *
@@ -353,6 +384,10 @@ get_coverage_counts (unsigned counter, unsigned expected,
     }
 
   checksum = compute_checksum ();
+  if (counter == GCOV_COUNTER_V_INDIR
+      && entry->checksum == checksum
+      && entry->summary.num != expected)
+    convert_old_indir_call_counts (entry, expected);
   if (entry->checksum != checksum
       || entry->summary.num != expected)
     {
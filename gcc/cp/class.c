@@ -112,6 +112,27 @@ static GTY (()) tree sizeof_biggest_empty_class;
    declaration order.  */
 VEC(tree,gc) *local_classes;
 
+/* The names of the members declared so far in a class which is being
+   defined.  While a class is incomplete its members are not sorted,
+   so this lets lookup_field_1 and lookup_fnfields_1 reject the names
+   which are not members without searching all of them.  */
+
+typedef struct GTY(()) class_member_names_s {
+  /* The class being defined.  */
+  tree type;
+  /* The IDENTIFIER_NODEs of its TYPE_FIELDS and of its methods.  */
+  htab_t GTY ((param_is (union tree_node))) field_names;
+  htab_t GTY ((param_is (union tree_node))) method_names;
+  /* A member at or near the end of TYPE_FIELDS, where TYPE_DECLs are
+     added; see finish_member_declaration.  */
+  tree last_field;
+} class_member_names_t;
+DEF_VEC_O(class_member_names_t);
+DEF_VEC_ALLOC_O(class_member_names_t,gc);
+
+/* The classes which are being defined, innermost last.  */
+static GTY (()) VEC(class_member_names_t,gc) *class_member_names;
+
 static tree get_vfield_name (tree);
 static void finish_struct_anon (tree);
 static tree get_vtable_name (tree);
@@ -919,6 +940,163 @@ modify_vtable_entry (tree t,
     }
 }
 
+/* Hash an IDENTIFIER_NODE of a class_member_names_t.  */
+
+static hashval_t
+hash_member_name (const void *p)
+{
+  return IDENTIFIER_HASH_VALUE ((const_tree) p);
+}
+
+/* Return the class_member_names_t of the class T, or NULL if T is not
+   being defined by begin_class_definition.  */
+
+static class_member_names_t *
+find_class_member_names (tree t)
+{
+  class_member_names_t *p;
+  int ix;
+
+  for (ix = (int) VEC_length (class_member_names_t, class_member_names) - 1;
+       ix >= 0; ix--)
+    {
+      p = VEC_index (class_member_names_t, class_member_names, ix);
+      if (p->type == t)
+	return p;
+    }
+  return NULL;
+}
+
+/* Start recording the names of the members of T, a class whose
+   definition is beginning.  */
+
+void
+push_class_member_names (tree t)
+{
+  class_member_names_t *p;
+
+  /* Only record the members of a class which has none yet; otherwise
+     we would miss the members declared before.  */
+  if (!CLASS_TYPE_P (t) || TYPE_FIELDS (t) || CLASSTYPE_METHOD_VEC (t))
+    return;
+
+  p = VEC_safe_push (class_member_names_t, gc, class_member_names, NULL);
+  p->type = t;
+  p->field_names = htab_create_ggc (31, hash_member_name, htab_eq_pointer,
+				    NULL);
+  p->method_names = htab_create_ggc (31, hash_member_name, htab_eq_pointer,
+				     NULL);
+  p->last_field = NULL_TREE;
+}
+
+/* Stop recording the names of the members of T, whose definition is
+   being finished.  */
+
+void
+pop_class_member_names (tree t)
+{
+  int ix;
+
+  for (ix = (int) VEC_length (class_member_names_t, class_member_names) - 1;
+       ix >= 0; ix--)
+    if (VEC_index (class_member_names_t, class_member_names, ix)->type == t)
+      {
+	VEC_ordered_remove (class_member_names_t, class_member_names, ix);
+	break;
+      }
+}
+
+/* Record the name of DECL, which is not a method, in the names P of
+   the members of a class.  The members of an anonymous aggregate are
+   found by lookup_field_1 in the enclosing class.  */
+
+static void
+note_class_member_name_1 (class_member_names_t *p, tree decl)
+{
+  tree name = DECL_NAME (decl);
+  tree field;
+  void **slot;
+
+  if (name)
+    {
+      slot = htab_find_slot_with_hash (p->field_names, name,
+				       IDENTIFIER_HASH_VALUE (name), INSERT);
+      *slot = name;
+    }
+  else if (TREE_TYPE (decl)
+	   && ANON_AGGR_TYPE_P (TREE_TYPE (decl)))
+    for (field = TYPE_FIELDS (TREE_TYPE (decl));
+	 field;
+	 field = DECL_CHAIN (field))
+      note_class_member_name_1 (p, field);
+}
+
+/* Record that DECL is a member of T, if T is being defined.  */
+
+void
+note_class_member_name (tree t, tree decl)
+{
+  class_member_names_t *p = find_class_member_names (t);
+  void **slot;
+
+  if (!p)
+    return;
+  if (TREE_CODE (decl) == FUNCTION_DECL || DECL_FUNCTION_TEMPLATE_P (decl))
+    {
+      slot = htab_find_slot_with_hash (p->method_names, DECL_NAME (decl),
+				       IDENTIFIER_HASH_VALUE (DECL_NAME (decl)),
+				       INSERT);
+      *slot = DECL_NAME (decl);
+    }
+  else
+    note_class_member_name_1 (p, decl);
+}
+
+/* Return false if T is being defined and none of the members declared
+   so far is named NAME: of the methods of T if METHOD_P, and of the
+   other members otherwise.  Return true if there may be one.  */
+
+bool
+class_member_name_p (tree t, tree name, bool method_p)
+{
+  class_member_names_t *p;
+
+  if (COMPLETE_TYPE_P (t))
+    return true;
+  p = find_class_member_names (t);
+  return (!p
+	  || htab_find_with_hash (method_p ? p->method_names : p->field_names,
+				  name, IDENTIFIER_HASH_VALUE (name)) != NULL);
+}
+
+/* Add DECL, a TYPE_DECL, at the end of TYPE_FIELDS (T).  */
+
+void
+append_class_type_decl (tree t, tree decl)
+{
+  class_member_names_t *p = find_class_member_names (t);
+  tree last;
+
+  if (!p)
+    {
+      TYPE_FIELDS (t) = chainon (TYPE_FIELDS (t), decl);
+      return;
+    }
+
+  /* The ordinary fields are added at the beginning of TYPE_FIELDS, so
+     the end we remembered is still the end or close to it.  */
+  last = p->last_field ? p->last_field : TYPE_FIELDS (t);
+  if (!last)
+    TYPE_FIELDS (t) = decl;
+  else
+    {
+      while (DECL_CHAIN (last))
+	last = DECL_CHAIN (last);
+      DECL_CHAIN (last) = decl;
+    }
+  p->last_field = decl;
+}
+
 
 /* Add method METHOD to class TYPE.  If USING_DECL is non-null, it is
    the USING_DECL naming METHOD.  Returns true if the method could be
@@ -986,30 +1164,34 @@ add_method (tree type, tree method, tree using_decl)
 
       insert_p = true;
       /* See if we already have an entry with this name.  */
-      for (slot = CLASSTYPE_FIRST_CONVERSION_SLOT;
-	   VEC_iterate (tree, method_vec, slot, m);
-	   ++slot)
-	{
-	  m = OVL_CURRENT (m);
-	  if (template_conv_p)
-	    {
-	      if (TREE_CODE (m) == TEMPLATE_DECL
-		  && DECL_TEMPLATE_CONV_FN_P (m))
-		insert_p = false;
+      if (!conv_p && !class_member_name_p (type, DECL_NAME (method), true))
+	/* We know we don't; add a new one at the end.  */
+	slot = VEC_length (tree, method_vec);
+      else
+	for (slot = CLASSTYPE_FIRST_CONVERSION_SLOT;
+	     VEC_iterate (tree, method_vec, slot, m);
+	     ++slot)
+	  {
+	    m = OVL_CURRENT (m);
+	    if (template_conv_p)
+	      {
+		if (TREE_CODE (m) == TEMPLATE_DECL
+		    && DECL_TEMPLATE_CONV_FN_P (m))
+		  insert_p = false;
+		break;
+	      }
+	    if (conv_p && !DECL_CONV_FN_P (m))
 	      break;
-	    }
-	  if (conv_p && !DECL_CONV_FN_P (m))
-	    break;
-	  if (DECL_NAME (m) == DECL_NAME (method))
-	    {
-	      insert_p = false;
+	    if (DECL_NAME (m) == DECL_NAME (method))
+	      {
+		insert_p = false;
+		break;
+	      }
+	    if (complete_p
+		&& !DECL_CONV_FN_P (m)
+		&& DECL_NAME (m) > DECL_NAME (method))
 	      break;
-	    }
-	  if (complete_p
-	      && !DECL_CONV_FN_P (m)
-	      && DECL_NAME (m) > DECL_NAME (method))
-	    break;
-	}
+	  }
     }
   current_fns = insert_p ? NULL_TREE : VEC_index (tree, method_vec, slot);
 
@@ -1127,6 +1309,10 @@ add_method (tree type, tree method, tree using_decl)
   else
     /* Replace the current slot.  */
     VEC_replace (tree, method_vec, slot, overload);
+
+  note_class_member_name (type, method);
+  if (complete_p)
+    invalidate_member_lookup_cache (DECL_NAME (method));
   return true;
 }
 
@@ -5759,6 +5945,8 @@ finish_struct (tree t, tree attributes)
 {
   location_t saved_loc = input_location;
 
+  pop_class_member_names (t);
+
   /* Now that we've got all the field declarations, reverse everything
      as necessary.  */
   unreverse_member_declarations (t);
@@ -4685,6 +4685,11 @@ extern tree get_vtable_decl			(tree, int);
 extern void resort_type_method_vec		(void *, void *,
 						 gt_pointer_operator, void *);
 extern bool add_method				(tree, tree, tree);
+extern void push_class_member_names		(tree);
+extern void pop_class_member_names		(tree);
+extern void note_class_member_name		(tree, tree);
+extern bool class_member_name_p			(tree, tree, bool);
+extern void append_class_type_decl		(tree, tree);
 extern bool currently_open_class		(tree);
 extern tree currently_open_derived_class	(tree);
 extern tree current_nonlambda_class_type	(void);
@@ -5098,6 +5103,7 @@ extern void record_last_problematic_instantiation (void);
 extern struct tinst_level *current_instantiation(void);
 extern tree maybe_get_template_decl_from_type_decl (tree);
 extern int processing_template_parmlist;
+extern int tsubst_uncacheable_count;
 extern bool dependent_type_p			(tree);
 extern bool dependent_scope_p			(tree);
 extern bool any_dependent_template_arguments_p  (const_tree);
@@ -5164,6 +5170,7 @@ extern tree lookup_fnfields_slot		(tree, tree);
 extern int class_method_index_for_fn		(tree, tree);
 extern tree lookup_fnfields			(tree, tree, int);
 extern tree lookup_member			(tree, tree, int, bool);
+extern void invalidate_member_lookup_cache	(tree);
 extern int look_for_overrides			(tree, tree);
 extern void get_pure_virtuals			(tree);
 extern void maybe_suppress_debug_info		(tree);
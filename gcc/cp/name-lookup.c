@@ -1909,18 +1909,47 @@ make_lambda_name (void)
   return get_identifier (buf);
 }
 
-/* Return (from the stack of) the BINDING, if any, established at SCOPE.  */
+/* The number of namespace bindings of a name which are searched
+   linearly.  When a name is bound in more namespaces, all its bindings
+   are also entered in the binding_index of their namespace.  */
+#define NAMESPACE_BINDINGS_SEARCH_LENGTH 8
 
-static inline cxx_binding *
-find_binding (cxx_scope *scope, cxx_binding *binding)
+/* Hash and compare the cp_namespace_binding entries of the
+   binding_index of a namespace.  */
+
+static hashval_t
+hash_namespace_binding (const void *p)
 {
-  timevar_push (TV_NAME_LOOKUP);
+  const cp_namespace_binding *e = (const cp_namespace_binding *) p;
+  return IDENTIFIER_HASH_VALUE (e->identifier);
+}
 
-  for (; binding != NULL; binding = binding->previous)
-    if (binding->scope == scope)
-      POP_TIMEVAR_AND_RETURN (TV_NAME_LOOKUP, binding);
+static int
+eq_namespace_binding (const void *p1, const void *p2)
+{
+  const cp_namespace_binding *e = (const cp_namespace_binding *) p1;
+  return e->identifier == (const_tree) p2;
+}
 
-  POP_TIMEVAR_AND_RETURN (TV_NAME_LOOKUP, (cxx_binding *)0);
+/* Enter BINDING, the binding of NAME in a namespace, in the
+   binding_index of the namespace.  */
+
+static void
+index_namespace_binding (tree name, cxx_binding *binding)
+{
+  cxx_scope *scope = binding->scope;
+  cp_namespace_binding *e;
+  void **slot;
+
+  if (!scope->binding_index)
+    scope->binding_index = htab_create_ggc (31, hash_namespace_binding,
+					    eq_namespace_binding, NULL);
+  slot = htab_find_slot_with_hash (scope->binding_index, name,
+				   IDENTIFIER_HASH_VALUE (name), INSERT);
+  e = ggc_alloc_cp_namespace_binding ();
+  e->identifier = name;
+  e->binding = binding;
+  *slot = e;
 }
 
 /* Return the binding for NAME in SCOPE, if any.  Otherwise, return NULL.  */
@@ -1929,12 +1958,30 @@ static inline cxx_binding *
 cxx_scope_find_binding_for_name (cxx_scope *scope, tree name)
 {
   cxx_binding *b = IDENTIFIER_NAMESPACE_BINDINGS (name);
+  cp_namespace_binding *e;
+  int i;
+
   if (b)
     {
       /* Fold-in case where NAME is used only once.  */
       if (scope == b->scope && b->previous == NULL)
 	return b;
-      return find_binding (scope, b);
+      for (i = 0; i < NAMESPACE_BINDINGS_SEARCH_LENGTH; i++)
+	{
+	  if (b->scope == scope)
+	    return b;
+	  b = b->previous;
+	  if (!b)
+	    return NULL;
+	}
+      /* NAME is bound in more namespaces than we want to search: all
+	 its bindings are indexed.  */
+      if (!scope->binding_index)
+	return NULL;
+      e = (cp_namespace_binding *)
+	htab_find_with_hash (scope->binding_index, name,
+			     IDENTIFIER_HASH_VALUE (name));
+      return e ? e->binding : NULL;
     }
   return NULL;
 }
@@ -1946,6 +1993,8 @@ static cxx_binding *
 binding_for_name (cxx_scope *scope, tree name)
 {
   cxx_binding *result;
+  cxx_binding *b;
+  int length;
 
   result = cxx_scope_find_binding_for_name (scope, name);
   if (result)
@@ -1957,6 +2006,18 @@ binding_for_name (cxx_scope *scope, tree name)
   result->is_local = false;
   result->value_is_inherited = false;
   IDENTIFIER_NAMESPACE_BINDINGS (name) = result;
+
+  /* If NAME is now bound in too many namespaces to search them,
+     index its bindings.  */
+  for (b = result, length = 0;
+       b && length <= NAMESPACE_BINDINGS_SEARCH_LENGTH + 1;
+       b = b->previous)
+    length++;
+  if (length == NAMESPACE_BINDINGS_SEARCH_LENGTH + 1)
+    for (b = result; b; b = b->previous)
+      index_namespace_binding (name, b);
+  else if (length > NAMESPACE_BINDINGS_SEARCH_LENGTH + 1)
+    index_namespace_binding (name, result);
   return result;
 }
 
@@ -158,6 +158,13 @@ typedef struct GTY(()) cp_label_binding {
 DEF_VEC_O(cp_label_binding);
 DEF_VEC_ALLOC_O(cp_label_binding,gc);
 
+typedef struct GTY(()) cp_namespace_binding {
+  /* The bound name.  */
+  tree identifier;
+  /* Its binding in the namespace.  */
+  cxx_binding *binding;
+} cp_namespace_binding;
+
 /* For each binding contour we allocate a binding_level structure
    which records the names defined in that contour.
    Contours include:
@@ -205,6 +212,10 @@ struct GTY(()) cp_binding_level {
        VALUE the common ancestor with this binding_level's namespace.  */
     tree using_directives;
 
+    /* For a namespace, the bindings of the names which are bound in
+       many namespaces, indexed by name.  See binding_for_name.  */
+    htab_t GTY ((param_is (cp_namespace_binding))) binding_index;
+
     /* For the binding level corresponding to a class, the entities
        declared in the class or its base classes.  */
     VEC(cp_class_binding,gc) *class_shadowed;
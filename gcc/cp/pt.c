@@ -94,6 +94,74 @@ static GTY ((param_is (spec_entry)))
 static GTY ((param_is (spec_entry)))
   htab_t type_specializations;
 
+/* With -ftemplate-substitution-cache, the result R of substituting
+   ARGS into the type T with the COMPLAIN flags.  */
+
+typedef struct GTY(()) tsubst_entry
+{
+  tree t;
+  tree args;
+  tree r;
+  int complain;
+} tsubst_entry;
+
+/* The cache of tsubst_entries.  An entry goes away as soon as one of
+   its trees is not otherwise referenced.  */
+
+static GTY ((if_marked ("tsubst_entry_marked_p"), param_is (tsubst_entry)))
+  htab_t tsubst_cache;
+
+/* Incremented whenever a substitution does something that depends on
+   more than the substituted tree and the arguments, such as looking up
+   a local specialization or checking the access to a member.  A
+   substitution during which it changed is not entered in the
+   tsubst_cache.  */
+
+int tsubst_uncacheable_count;
+
+static unsigned long tsubst_cache_lookups;
+static unsigned long tsubst_cache_hits;
+
+/* With -fstats, the number of instantiations of the template TMPL, and
+   the time spent in them: SELF_TIME excludes the time spent in nested
+   instantiations, TOTAL_TIME includes it but counts the time of an
+   instantiation of TMPL nested in another one once.  ACTIVE is the
+   number of instantiations of TMPL in progress.  */
+
+typedef struct tinst_stat
+{
+  tree tmpl;
+  unsigned int count;
+  unsigned int active;
+  long self_time;
+  long total_time;
+} tinst_stat;
+
+DEF_VEC_O (tinst_stat);
+DEF_VEC_ALLOC_O (tinst_stat,heap);
+
+/* An instantiation in progress: STAT is the index of the tinst_stat of
+   its template in tinst_stats.  */
+
+typedef struct tinst_frame
+{
+  unsigned int stat;
+  long start;
+  long children_time;
+} tinst_frame;
+
+DEF_VEC_O (tinst_frame);
+DEF_VEC_ALLOC_O (tinst_frame,heap);
+
+static VEC(tinst_stat,heap) *tinst_stats;
+static VEC(tinst_frame,heap) *tinst_frames;
+
+/* Maps a template to one plus the index of its tinst_stat.  The
+   templates themselves are kept alive by tinst_stat_templates.  */
+
+static struct pointer_map_t *tinst_stat_map;
+static GTY(()) VEC(tree,gc) *tinst_stat_templates;
+
 /* Contains canonical template parameter types. The vector is indexed by
    the TEMPLATE_TYPE_IDX of the template parameter. Each element is a
    TREE_LIST, whose TREE_VALUEs contain the canonical template
@@ -185,6 +253,10 @@ static tree tsubst_expr	(tree, tree, tsubst_flags_t, tree, bool);
 static tree tsubst_copy	(tree, tree, tsubst_flags_t, tree);
 static tree tsubst_pack_expansion (tree, tree, tsubst_flags_t, tree);
 static tree tsubst_decl (tree, tree, tsubst_flags_t);
+static tree tsubst_1 (tree, tree, tsubst_flags_t, tree);
+static int tsubst_entry_marked_p (const void *);
+static void begin_tinst_stat (tree);
+static void end_tinst_stat (void);
 static void perform_typedefs_access_check (tree tmpl, tree targs);
 static void append_type_to_template_for_access_check_1 (tree, tree, tree,
 							location_t);
@@ -1051,6 +1123,10 @@ retrieve_local_specialization (tree tmpl)
 {
   tree spec;
 
+  /* The result of a substitution depends on the function being
+     instantiated.  */
+  ++tsubst_uncacheable_count;
+
   if (local_specializations == NULL)
     return NULL_TREE;
 
@@ -6977,6 +7053,11 @@ lookup_template_class (tree d1,
       if (!context)
 	context = global_namespace;
 
+      /* The new type may be declared in the current scope below.  */
+      if (TREE_CODE (template_type) == ENUMERAL_TYPE
+	  || context == current_function_decl)
+	++tsubst_uncacheable_count;
+
       /* Create the type.  */
       if (TREE_CODE (template_type) == ENUMERAL_TYPE)
 	{
@@ -7523,6 +7604,74 @@ pop_tinst_level (void)
   ++tinst_level_tick;
 }
 
+/* With -fstats, record that we are starting to instantiate the template
+   TMPL.  */
+
+static void
+begin_tinst_stat (tree tmpl)
+{
+  tinst_stat *stat;
+  tinst_frame *frame;
+  void **slot;
+  unsigned int ix;
+
+  if (tinst_stat_map == NULL)
+    tinst_stat_map = pointer_map_create ();
+  slot = pointer_map_insert (tinst_stat_map, tmpl);
+  if (*slot == NULL)
+    {
+      stat = VEC_safe_push (tinst_stat, heap, tinst_stats, NULL);
+      memset (stat, 0, sizeof (tinst_stat));
+      stat->tmpl = tmpl;
+      VEC_safe_push (tree, gc, tinst_stat_templates, tmpl);
+      *slot = (void *) (size_t) VEC_length (tinst_stat, tinst_stats);
+    }
+  ix = (size_t) *slot - 1;
+  stat = VEC_index (tinst_stat, tinst_stats, ix);
+  stat->count++;
+  stat->active++;
+
+  frame = VEC_safe_push (tinst_frame, heap, tinst_frames, NULL);
+  frame->stat = ix;
+  frame->children_time = 0;
+  frame->start = get_run_time ();
+}
+
+/* With -fstats, record that we are done with the innermost instantiation
+   started by begin_tinst_stat.  */
+
+static void
+end_tinst_stat (void)
+{
+  tinst_frame *frame = VEC_last (tinst_frame, tinst_frames);
+  tinst_stat *stat = VEC_index (tinst_stat, tinst_stats, frame->stat);
+  long elapsed = get_run_time () - frame->start;
+
+  stat->self_time += elapsed - frame->children_time;
+  /* Count the time of a recursive instantiation once.  */
+  if (--stat->active == 0)
+    stat->total_time += elapsed;
+
+  VEC_pop (tinst_frame, tinst_frames);
+  if (!VEC_empty (tinst_frame, tinst_frames))
+    VEC_last (tinst_frame, tinst_frames)->children_time += elapsed;
+}
+
+/* Sort the tinst_stats by decreasing self time.  */
+
+static int
+tinst_stat_cmp (const void *p1, const void *p2)
+{
+  const tinst_stat *s1 = (const tinst_stat *) p1;
+  const tinst_stat *s2 = (const tinst_stat *) p2;
+
+  if (s1->self_time != s2->self_time)
+    return s1->self_time < s2->self_time ? 1 : -1;
+  if (s1->count != s2->count)
+    return s1->count < s2->count ? 1 : -1;
+  return DECL_UID (s1->tmpl) < DECL_UID (s2->tmpl) ? -1 : 1;
+}
+
 /* We're instantiating a deferred template; restore the template
    instantiation context in which the instantiation was requested, which
    is one step out from LEVEL.  Return the corresponding DECL or TYPE.  */
@@ -8158,6 +8307,8 @@ instantiate_class_template (tree type)
   /* If we've recursively instantiated too many templates, stop.  */
   if (! push_tinst_level (type))
     return type;
+  if (flag_detailed_statistics)
+    begin_tinst_stat (templ);
 
   /* Now we're really doing the instantiation.  Mark the type as in
      the process of being defined.  */
@@ -8584,6 +8735,8 @@ instantiate_class_template (tree type)
   maximum_field_alignment = saved_maximum_field_alignment;
   pop_from_top_level ();
   pop_deferring_access_checks ();
+  if (flag_detailed_statistics)
+    end_tinst_stat ();
   pop_tinst_level ();
 
   /* The vtable for a template class can be emitted in any translation
@@ -10379,6 +10532,140 @@ tsubst_exception_specification (tree fntype,
   return new_specs;
 }
 
+/* Return true if the result of substituting into the type T is worth
+   keeping in the tsubst_cache: the substitutions into templated classes
+   and typename types do most of the lookups.  */
+
+static bool
+tsubst_cacheable_type_p (tree t)
+{
+  switch (TREE_CODE (t))
+    {
+    case RECORD_TYPE:
+    case UNION_TYPE:
+    case ENUMERAL_TYPE:
+      return TYPE_TEMPLATE_INFO (t) != NULL_TREE;
+
+    case TYPENAME_TYPE:
+      return true;
+
+    default:
+      return false;
+    }
+}
+
+/* Return true if the template arguments ARGS can be part of the key of
+   a tsubst_cache entry.  While substituting into a pack expansion, the
+   ARGUMENT_PACK_SELECTs of ARGS select an argument of a pack, and are
+   changed in place from one argument to the next.  */
+
+static bool
+tsubst_cacheable_args_p (tree args)
+{
+  int i;
+
+  if (args == NULL_TREE || TREE_CODE (args) != TREE_VEC)
+    return false;
+
+  for (i = 0; i < TREE_VEC_LENGTH (args); ++i)
+    {
+      tree arg = TREE_VEC_ELT (args, i);
+
+      if (arg == NULL_TREE)
+	continue;
+      if (TREE_CODE (arg) == TREE_VEC
+	  ? !tsubst_cacheable_args_p (arg)
+	  : TREE_CODE (arg) == ARGUMENT_PACK_SELECT)
+	return false;
+    }
+  return true;
+}
+
+/* Return true if the template arguments A and B are the same.  Unlike
+   comp_template_args, two types are the same only if they are spelled
+   the same, so that the diagnostics do not depend on the cache.  */
+
+static bool
+tsubst_cache_args_equal_p (tree a, tree b)
+{
+  int i;
+
+  if (a == b)
+    return true;
+  if (a == NULL_TREE || b == NULL_TREE || TREE_CODE (a) != TREE_CODE (b))
+    return false;
+
+  if (TREE_CODE (a) == TREE_VEC)
+    {
+      if (TREE_VEC_LENGTH (a) != TREE_VEC_LENGTH (b))
+	return false;
+      for (i = 0; i < TREE_VEC_LENGTH (a); ++i)
+	if (!tsubst_cache_args_equal_p (TREE_VEC_ELT (a, i),
+					TREE_VEC_ELT (b, i)))
+	  return false;
+      return true;
+    }
+  else if (ARGUMENT_PACK_P (a))
+    return tsubst_cache_args_equal_p (ARGUMENT_PACK_ARGS (a),
+				      ARGUMENT_PACK_ARGS (b));
+  else if (TYPE_P (a))
+    return false;
+  else
+    return template_args_equal (a, b);
+}
+
+/* Copy the levels of the template arguments ARGS, which tsubst_pack_expansion
+   may change in place after they entered the tsubst_cache.  */
+
+static tree
+copy_tsubst_cache_args (tree args)
+{
+  tree copy = copy_node (args);
+  int i;
+
+  if (TMPL_ARGS_HAVE_MULTIPLE_LEVELS (args))
+    for (i = 1; i <= TMPL_ARGS_DEPTH (args); ++i)
+      SET_TMPL_ARGS_LEVEL (copy, i, copy_node (TMPL_ARGS_LEVEL (args, i)));
+  return copy;
+}
+
+/* Returns a hash for a tsubst_entry.  */
+
+static hashval_t
+hash_tsubst_entry (const void *p)
+{
+  const tsubst_entry *e = (const tsubst_entry *) p;
+  hashval_t val;
+
+  val = iterative_hash_object (TYPE_UID (e->t), 0);
+  val = iterative_hash_object (e->complain, val);
+  return iterative_hash_template_arg (e->args, val);
+}
+
+/* Returns true iff two tsubst_entries are for the same substitution.  */
+
+static int
+eq_tsubst_entries (const void *p1, const void *p2)
+{
+  const tsubst_entry *e1 = (const tsubst_entry *) p1;
+  const tsubst_entry *e2 = (const tsubst_entry *) p2;
+
+  return (e1->t == e2->t
+	  && e1->complain == e2->complain
+	  && tsubst_cache_args_equal_p (e1->args, e2->args));
+}
+
+/* Keep a tsubst_entry across garbage collections only while both the
+   substituted type and the result are live.  */
+
+static int
+tsubst_entry_marked_p (const void *p)
+{
+  const tsubst_entry *e = (const tsubst_entry *) p;
+
+  return ggc_marked_p (e->t) && ggc_marked_p (e->r);
+}
+
 /* Take the tree structure T and replace template parameters used
    therein with the argument vector ARGS.  IN_DECL is an associated
    decl for diagnostics.  If an error occurs, returns ERROR_MARK_NODE.
@@ -10397,6 +10684,65 @@ tsubst_exception_specification (tree fntype,
 
 tree
 tsubst (tree t, tree args, tsubst_flags_t complain, tree in_decl)
+{
+  tsubst_entry elt;
+  tsubst_entry *entry;
+  void **slot;
+  hashval_t hash;
+  int uncacheable_count, diagnostic_count;
+  tree r;
+
+  if (!flag_template_substitution_cache
+      || processing_template_decl
+      || seen_error ()
+      || t == NULL_TREE
+      || !tsubst_cacheable_type_p (t)
+      || !tsubst_cacheable_args_p (args))
+    return tsubst_1 (t, args, complain, in_decl);
+
+  elt.t = t;
+  elt.args = args;
+  elt.r = NULL_TREE;
+  elt.complain = complain;
+  hash = hash_tsubst_entry (&elt);
+
+  tsubst_cache_lookups++;
+  entry = (tsubst_entry *) htab_find_with_hash (tsubst_cache, &elt, hash);
+  if (entry)
+    {
+      tsubst_cache_hits++;
+      return entry->r;
+    }
+
+  uncacheable_count = tsubst_uncacheable_count;
+  diagnostic_count = errorcount + warningcount + sorrycount;
+  r = tsubst_1 (t, args, complain, in_decl);
+
+  /* Only remember the substitutions which succeeded quietly, and which
+     depended on T and ARGS alone.  */
+  if (r != error_mark_node
+      && tsubst_uncacheable_count == uncacheable_count
+      && errorcount + warningcount + sorrycount == diagnostic_count)
+    {
+      slot = htab_find_slot_with_hash (tsubst_cache, &elt, hash, INSERT);
+      if (*slot == NULL)
+	{
+	  entry = ggc_alloc_tsubst_entry ();
+	  entry->t = t;
+	  entry->args = copy_tsubst_cache_args (args);
+	  entry->r = r;
+	  entry->complain = complain;
+	  *slot = entry;
+	}
+    }
+
+  return r;
+}
+
+/* The worker for tsubst.  */
+
+static tree
+tsubst_1 (tree t, tree args, tsubst_flags_t complain, tree in_decl)
 {
   enum tree_code code;
   tree type, r;
@@ -17193,6 +17539,8 @@ instantiate_decl (tree d, int defer_ok,
   /* This needs to happen before any tsubsting.  */
   if (! push_tinst_level (d))
     return d;
+  if (flag_detailed_statistics)
+    begin_tinst_stat (gen_tmpl);
 
   timevar_push (TV_PARSE);
 
@@ -17485,6 +17833,8 @@ instantiate_decl (tree d, int defer_ok,
 out:
   input_location = saved_loc;
   pop_deferring_access_checks ();
+  if (flag_detailed_statistics)
+    end_tinst_stat ();
   pop_tinst_level ();
 
   timevar_pop (TV_PARSE);
@@ -19216,6 +19566,10 @@ init_template_processing (void)
 					  hash_specialization,
 					  eq_specializations,
 					  ggc_free);
+  tsubst_cache = htab_create_ggc (37,
+				  hash_tsubst_entry,
+				  eq_tsubst_entries,
+				  NULL);
 }
 
 /* Print stats about the template hash tables for -fstats.  */
@@ -19231,6 +19585,26 @@ print_template_statistics (void)
 	   "%f collisions\n", (long) htab_size (type_specializations),
 	   (long) htab_elements (type_specializations),
 	   htab_collisions (type_specializations));
+  fprintf (stderr, "tsubst_cache: %ld elements, %lu lookups, %lu hits\n",
+	   (long) htab_elements (tsubst_cache),
+	   tsubst_cache_lookups, tsubst_cache_hits);
+
+  if (!VEC_empty (tinst_stat, tinst_stats))
+    {
+      VEC(tinst_stat,heap) *sorted = VEC_copy (tinst_stat, heap, tinst_stats);
+      tinst_stat *stat;
+      unsigned int i;
+
+      VEC_qsort (tinst_stat, sorted, tinst_stat_cmp);
+      fprintf (stderr, "\nMost expensive templates:\n"
+	       "%10s %10s %10s  %s\n",
+	       "count", "self (s)", "total (s)", "template");
+      for (i = 0; i < 20 && VEC_iterate (tinst_stat, sorted, i, stat); ++i)
+	fprintf (stderr, "%10u %10.3f %10.3f  %s\n", stat->count,
+		 stat->self_time / 1e6, stat->total_time / 1e6,
+		 decl_as_string (stat->tmpl, TFF_PLAIN_IDENTIFIER));
+      VEC_free (tinst_stat, heap, sorted);
+    }
 }
 
 #include "gt-cp-pt.h"
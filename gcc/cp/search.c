@@ -73,8 +73,29 @@ static int n_calls_lookup_fnfields, n_calls_lookup_fnfields_1;
 static int n_calls_get_base_type;
 static int n_outer_fields_searched;
 static int n_contexts_saved;
+static int n_member_lookup_cache_hits;
 #endif /* GATHER_STATISTICS */
 
+/* A result of lookup_member for a complete class.  */
+
+struct GTY(()) member_lookup_entry {
+  /* The TYPE_BINFO of the class searched.  */
+  tree binfo;
+  /* The name looked up, and whether types were wanted.  */
+  tree name;
+  bool want_type;
+  /* The member found, and the binfo in which it was found, as computed
+     by lookup_field_r.  */
+  tree rval;
+  tree rval_binfo;
+};
+
+/* The results of the searches of lookup_member through the bases of
+   complete classes, which are the same until a member is added to one
+   of them.  */
+static GTY ((param_is (struct member_lookup_entry), deletable))
+  htab_t member_lookup_cache;
+
 
 /* Data for lookup_base and its workers.  */
 
@@ -442,6 +463,10 @@ lookup_field_1 (tree type, tree name, bool want_type)
       return NULL_TREE;
     }
 
+  /* A class being defined knows the names of its members.  */
+  if (!class_member_name_p (type, name, /*method_p=*/false))
+    return NULL_TREE;
+
   field = TYPE_FIELDS (type);
 
 #ifdef GATHER_STATISTICS
@@ -1142,6 +1167,54 @@ build_baselink (tree binfo, tree access_binfo, tree functions, tree optype)
   return baselink;
 }
 
+/* Hash and compare the entries of member_lookup_cache.  */
+
+static hashval_t
+hash_member_lookup_entry (const void *p)
+{
+  const struct member_lookup_entry *e
+    = (const struct member_lookup_entry *) p;
+  return (htab_hash_pointer (e->binfo)
+	  ^ IDENTIFIER_HASH_VALUE (e->name)
+	  ^ e->want_type);
+}
+
+static int
+eq_member_lookup_entry (const void *p1, const void *p2)
+{
+  const struct member_lookup_entry *e1
+    = (const struct member_lookup_entry *) p1;
+  const struct member_lookup_entry *e2
+    = (const struct member_lookup_entry *) p2;
+  return (e1->binfo == e2->binfo
+	  && e1->name == e2->name
+	  && e1->want_type == e2->want_type);
+}
+
+/* Return true if the results of lookup_member for NAME can be cached.
+   The special member functions are declared lazily, and conversion
+   functions are not found by name, so we don't cache those.  */
+
+static bool
+member_lookup_cacheable_name_p (tree name)
+{
+  return (!IDENTIFIER_CTOR_OR_DTOR_P (name)
+	  && !IDENTIFIER_TYPENAME_P (name)
+	  && name != ansi_assopname (NOP_EXPR));
+}
+
+/* A member named NAME, or a member without a name if NAME is
+   NULL_TREE, is being added to a complete class; forget the results
+   of lookup_member which might have found it.  */
+
+void
+invalidate_member_lookup_cache (tree name)
+{
+  if (member_lookup_cache
+      && (!name || member_lookup_cacheable_name_p (name)))
+    htab_empty (member_lookup_cache);
+}
+
 /* Look for a member named NAME in an inheritance lattice dominated by
    XBASETYPE.  If PROTECT is 0 or two, we do not check access.  If it
    is 1, we enforce accessibility.  If PROTECT is zero, then, for an
@@ -1160,6 +1233,9 @@ lookup_member (tree xbasetype, tree name, int protect, bool want_type)
   tree rval, rval_binfo = NULL_TREE;
   tree type = NULL_TREE, basetype_path = NULL_TREE;
   struct lookup_field_info lfi;
+  struct member_lookup_entry key, *entry = NULL;
+  bool cacheable;
+  void **slot;
 
   /* rval_binfo is the binfo associated with the found member, note,
      this can be set with useful information, even when rval is not
@@ -1203,7 +1279,47 @@ lookup_member (tree xbasetype, tree name, int protect, bool want_type)
   lfi.type = type;
   lfi.name = name;
   lfi.want_type = want_type;
-  dfs_walk_all (basetype_path, &lookup_field_r, NULL, &lfi);
+
+  /* The search through the bases of a complete class can be done once
+     and for all; only the access checks depend on the context.  */
+  cacheable = (basetype_path == TYPE_BINFO (type)
+	       && BINFO_N_BASE_BINFOS (basetype_path) > 0
+	       && COMPLETE_TYPE_P (type)
+	       && !TYPE_BEING_DEFINED (type)
+	       && member_lookup_cacheable_name_p (name));
+  if (cacheable)
+    {
+      if (!member_lookup_cache)
+	member_lookup_cache = htab_create_ggc (127, hash_member_lookup_entry,
+					       eq_member_lookup_entry, NULL);
+      key.binfo = basetype_path;
+      key.name = name;
+      key.want_type = want_type;
+      entry = (struct member_lookup_entry *)
+	htab_find (member_lookup_cache, &key);
+    }
+
+  if (entry)
+    {
+#ifdef GATHER_STATISTICS
+      n_member_lookup_cache_hits++;
+#endif /* GATHER_STATISTICS */
+      lfi.rval = entry->rval;
+      lfi.rval_binfo = entry->rval_binfo;
+    }
+  else
+    {
+      dfs_walk_all (basetype_path, &lookup_field_r, NULL, &lfi);
+      if (cacheable && !lfi.ambiguous)
+	{
+	  slot = htab_find_slot (member_lookup_cache, &key, INSERT);
+	  entry = ggc_alloc_member_lookup_entry ();
+	  *entry = key;
+	  entry->rval = lfi.rval;
+	  entry->rval_binfo = lfi.rval_binfo;
+	  *slot = entry;
+	}
+    }
   rval = lfi.rval;
   rval_binfo = lfi.rval_binfo;
   if (rval_binfo)
@@ -1399,6 +1515,9 @@ lookup_fnfields_1 (tree type, tree name)
   if (IDENTIFIER_TYPENAME_P (name))
     return lookup_conversion_operator (type, TREE_TYPE (name));
 
+  if (!class_member_name_p (type, name, /*method_p=*/true))
+    return -1;
+
   /* Skip the conversion operators.  */
   for (i = CLASSTYPE_FIRST_CONVERSION_SLOT;
        VEC_iterate (tree, method_vec, i, fn);
@@ -1433,14 +1552,22 @@ lookup_fnfields_1 (tree type, tree name)
 	}
     }
   else
-    for (; VEC_iterate (tree, method_vec, i, fn); ++i)
-      {
+    {
+      /* While the class is being defined, new methods are added at the
+	 end of the vector, and it is mostly the recent ones which are
+	 looked up; search backwards.  */
+      size_t first = i;
+
+      for (i = VEC_length (tree, method_vec); i-- > first; )
+	{
 #ifdef GATHER_STATISTICS
-	n_outer_fields_searched++;
+	  n_outer_fields_searched++;
 #endif /* GATHER_STATISTICS */
-	if (DECL_NAME (OVL_CURRENT (fn)) == name)
-	  return i;
-      }
+	  fn = VEC_index (tree, method_vec, i);
+	  if (DECL_NAME (OVL_CURRENT (fn)) == name)
+	    return i;
+	}
+    }
 
   return -1;
 }
@@ -2156,6 +2283,8 @@ print_search_statistics (void)
 	   n_fields_searched, n_calls_lookup_field, n_calls_lookup_field_1);
   fprintf (stderr, "%d fnfields searched in %d calls to lookup_fnfields\n",
 	   n_outer_fields_searched, n_calls_lookup_fnfields);
+  fprintf (stderr, "%d of the calls to lookup_field found in the cache\n",
+	   n_member_lookup_cache_hits);
   fprintf (stderr, "%d calls to get_base_type\n", n_calls_get_base_type);
 #else /* GATHER_STATISTICS */
   fprintf (stderr, "no search statistics\n");
@@ -2172,6 +2301,7 @@ reinit_search_statistics (void)
   n_calls_get_base_type = 0;
   n_outer_fields_searched = 0;
   n_contexts_saved = 0;
+  n_member_lookup_cache_hits = 0;
 #endif /* GATHER_STATISTICS */
 }
 
@@ -2622,3 +2752,4 @@ original_binfo (tree binfo, tree here)
   return result;
 }
 
+#include "gt-cp-search.h"
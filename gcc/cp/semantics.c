@@ -303,6 +303,13 @@ perform_or_defer_access_check (tree binfo, tree decl, tree diag_decl)
   deferred_access_check *new_access;
 
 
+  /* Unless DECL is a public member of the class named by BINFO, whether
+     it is accessible depends on the current scope, so a substitution
+     which needs this check must not be taken from the tsubst cache.  */
+  if (TREE_PRIVATE (decl) || TREE_PROTECTED (decl)
+      || DECL_CONTEXT (decl) != BINFO_TYPE (binfo))
+    ++tsubst_uncacheable_count;
+
   /* Exit if we are in a context that no access checking is performed.
      */
   if (deferred_access_no_check)
@@ -2557,6 +2564,7 @@ begin_class_definition (tree t, tree attributes)
   maybe_process_partial_specialization (t);
   pushclass (t);
   TYPE_BEING_DEFINED (t) = 1;
+  push_class_member_names (t);
 
   cplus_decl_attributes (&t, attributes, (int) ATTR_FLAG_TYPE_IN_PLACE);
   fixup_attribute_variants (t);
@@ -2669,13 +2677,15 @@ finish_member_declaration (tree decl)
 	 declaration order so that class layout works as expected.
 	 However, we don't need that order until class layout, so we
 	 save a little time by putting FIELD_DECLs on in reverse order
-	 here, and then reversing them in finish_struct_1.  (We could
-	 also keep a pointer to the correct insertion points in the
-	 list.)  */
+	 here, and then reversing them in finish_struct_1.  While the
+	 class is being defined, append_class_type_decl remembers where
+	 the end of the list is.  */
 
+      note_class_member_name (current_class_type, decl);
+      if (COMPLETE_TYPE_P (current_class_type))
+	invalidate_member_lookup_cache (DECL_NAME (decl));
       if (TREE_CODE (decl) == TYPE_DECL)
-	TYPE_FIELDS (current_class_type)
-	  = chainon (TYPE_FIELDS (current_class_type), decl);
+	append_class_type_decl (current_class_type, decl);
       else
 	{
 	  DECL_CHAIN (decl) = TYPE_FIELDS (current_class_type);
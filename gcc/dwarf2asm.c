@@ -40,6 +40,59 @@ along with GCC; see the file COPYING3.  If not see
 #define ASM_COMMENT_START ";#"
 #endif
 
+/* Between dw2_asm_begin_byte_runs and dw2_asm_end_byte_runs, the
+   constants output by dw2_asm_output_data, dw2_asm_output_nstring and
+   the leb128 routines are encoded here, and output as long strings
+   when something else has to be output, instead of as one directive
+   each.  */
+static bool byte_runs_p;
+static unsigned char *byte_run;
+static size_t byte_run_len;
+static size_t byte_run_alloc;
+
+/* Add BYTE at the end of byte_run.  */
+
+static inline void
+add_to_byte_run (int byte)
+{
+  if (byte_run_len == byte_run_alloc)
+    {
+      byte_run_alloc = byte_run_alloc ? 2 * byte_run_alloc : 4096;
+      byte_run = XRESIZEVEC (unsigned char, byte_run, byte_run_alloc);
+    }
+  byte_run[byte_run_len++] = byte;
+}
+
+/* Start collecting the constant data in byte runs, if this is
+   possible and the user did not ask for a commented output.  */
+
+void
+dw2_asm_begin_byte_runs (void)
+{
+  byte_runs_p = (BITS_PER_UNIT == 8 && !flag_debug_asm);
+}
+
+/* Output the constant data collected since the last call.  */
+
+void
+dw2_asm_flush_byte_runs (void)
+{
+  if (byte_run_len)
+    {
+      assemble_bytes (byte_run, byte_run_len);
+      byte_run_len = 0;
+    }
+}
+
+/* Output the constant data collected, and stop collecting them.  */
+
+void
+dw2_asm_end_byte_runs (void)
+{
+  dw2_asm_flush_byte_runs ();
+  byte_runs_p = false;
+}
+
 
 /* Output an unaligned integer with the given value and size.  Prefer not
    to print a newline, since the caller may want to add a comment.  */
@@ -49,6 +102,7 @@ dw2_assemble_integer (int size, rtx x)
 {
   const char *op = integer_asm_op (size, FALSE);
 
+  dw2_asm_flush_byte_runs ();
   if (op)
     {
       fputs (op, asm_out_file);
@@ -99,12 +153,26 @@ dw2_asm_output_data (int size, unsigned HOST_WIDE_INT value,
 {
   va_list ap;
   const char *op = integer_asm_op (size, FALSE);
-
-  va_start (ap, comment);
+  int i;
 
   if (size * 8 < HOST_BITS_PER_WIDE_INT)
     value &= ~(~(unsigned HOST_WIDE_INT) 0 << (size * 8));
 
+  if (byte_runs_p)
+    {
+      if (BYTES_BIG_ENDIAN)
+	for (i = size - 1; i >= 0; i--)
+	  add_to_byte_run (i < HOST_BITS_PER_WIDE_INT / 8
+			   ? (value >> (i * 8)) & 0xff : 0);
+      else
+	for (i = 0; i < size; i++)
+	  add_to_byte_run (i < HOST_BITS_PER_WIDE_INT / 8
+			   ? (value >> (i * 8)) & 0xff : 0);
+      return;
+    }
+
+  va_start (ap, comment);
+
   if (op)
     fprintf (asm_out_file, "%s" HOST_WIDE_INT_PRINT_HEX, op, value);
   else
@@ -132,6 +200,7 @@ dw2_asm_output_delta (int size, const char *lab1, const char *lab2,
 {
   va_list ap;
 
+  dw2_asm_flush_byte_runs ();
   va_start (ap, comment);
 
 #ifdef ASM_OUTPUT_DWARF_DELTA
@@ -162,6 +231,7 @@ dw2_asm_output_vms_delta (int size ATTRIBUTE_UNUSED,
 {
   va_list ap;
 
+  dw2_asm_flush_byte_runs ();
   va_start (ap, comment);
 
 #ifndef ASM_OUTPUT_DWARF_VMS_DELTA
@@ -195,6 +265,7 @@ dw2_asm_output_offset (int size, const char *label,
 {
   va_list ap;
 
+  dw2_asm_flush_byte_runs ();
   va_start (ap, comment);
 
 #ifdef ASM_OUTPUT_DWARF_OFFSET
@@ -312,7 +383,13 @@ dw2_asm_output_nstring (const char *str, size_t orig_len,
   if (len == (size_t) -1)
     len = strlen (str);
 
-  if (flag_debug_asm && comment)
+  if (byte_runs_p)
+    {
+      for (i = 0; i < len; i++)
+	add_to_byte_run ((unsigned char) str[i]);
+      add_to_byte_run (0);
+    }
+  else if (flag_debug_asm && comment)
     {
       fputs ("\t.ascii \"", asm_out_file);
       for (i = 0; i < len; i++)
@@ -593,6 +670,18 @@ dw2_asm_output_data_uleb128 (unsigned HOST_WIDE_INT value,
 {
   va_list ap;
 
+  if (byte_runs_p)
+    {
+      do
+	{
+	  int byte = (value & 0x7f);
+	  value >>= 7;
+	  add_to_byte_run (value != 0 ? byte | 0x80 : byte);
+	}
+      while (value != 0);
+      return;
+    }
+
   va_start (ap, comment);
 
 #ifdef HAVE_AS_LEB128
@@ -677,6 +766,23 @@ dw2_asm_output_data_sleb128 (HOST_WIDE_INT value,
 {
   va_list ap;
 
+  if (byte_runs_p)
+    {
+      int byte, more;
+
+      do
+	{
+	  byte = (value & 0x7f);
+	  /* arithmetic shift */
+	  value >>= 7;
+	  more = !((value == 0 && (byte & 0x40) == 0)
+		   || (value == -1 && (byte & 0x40) != 0));
+	  add_to_byte_run (more ? byte | 0x80 : byte);
+	}
+      while (more);
+      return;
+    }
+
   va_start (ap, comment);
 
 #ifdef HAVE_AS_LEB128
@@ -740,6 +846,7 @@ dw2_asm_output_delta_uleb128 (const char *lab1 ATTRIBUTE_UNUSED,
 {
   va_list ap;
 
+  dw2_asm_flush_byte_runs ();
   va_start (ap, comment);
 
 #ifdef HAVE_AS_LEB128
@@ -949,6 +1056,7 @@ dw2_asm_output_encoded_addr_rtx (int encoding, rtx addr, bool is_public,
   int size;
   va_list ap;
 
+  dw2_asm_flush_byte_runs ();
   va_start (ap, comment);
 
   size = size_of_encoded_value (encoding);
@@ -19,6 +19,10 @@ along with GCC; see the file COPYING3.  If not see
 <http://www.gnu.org/licenses/>.  */
 
 
+extern void dw2_asm_begin_byte_runs (void);
+extern void dw2_asm_flush_byte_runs (void);
+extern void dw2_asm_end_byte_runs (void);
+
 extern void dw2_assemble_integer (int, rtx);
 
 extern void dw2_asm_output_data_raw (int, unsigned HOST_WIDE_INT);
@@ -5077,6 +5077,7 @@ output_loc_operands (dw_loc_descr_ref loc, int for_eh_or_skip)
       if (loc->dtprel)
 	{
 	  gcc_assert (targetm.asm_out.output_dwarf_dtprel);
+	  dw2_asm_flush_byte_runs ();
 	  targetm.asm_out.output_dwarf_dtprel (asm_out_file, 4,
 					       val1->v.val_addr);
 	  fputc ('\n', asm_out_file);
@@ -5090,6 +5091,7 @@ output_loc_operands (dw_loc_descr_ref loc, int for_eh_or_skip)
       if (loc->dtprel)
 	{
 	  gcc_assert (targetm.asm_out.output_dwarf_dtprel);
+	  dw2_asm_flush_byte_runs ();
 	  targetm.asm_out.output_dwarf_dtprel (asm_out_file, 8,
 					       val1->v.val_addr);
 	  fputc ('\n', asm_out_file);
@@ -5272,6 +5274,7 @@ output_loc_operands (dw_loc_descr_ref loc, int for_eh_or_skip)
 	{
 	  if (targetm.asm_out.output_dwarf_dtprel)
 	    {
+	      dw2_asm_flush_byte_runs ();
 	      targetm.asm_out.output_dwarf_dtprel (asm_out_file,
 						   DWARF2_ADDR_SIZE,
 						   val1->v.val_addr);
@@ -6223,6 +6226,11 @@ static GTY(()) unsigned abbrev_die_table_in_use;
    abbrev_die_table.  */
 #define ABBREV_DIE_TABLE_INCREMENT 256
 
+/* The DIEs of abbrev_die_table, hashed by the abbreviation they define,
+   so that build_abbrev_table need not compare a DIE with all of them.
+   The DIEs are kept alive by abbrev_die_table.  */
+static htab_t abbrev_die_hash;
+
 /* A global counter for generating labels for line number data.  */
 static unsigned int line_info_label_num;
 
@@ -10590,6 +10598,52 @@ output_location_lists (dw_die_ref die)
   FOR_EACH_CHILD (die, c, output_location_lists (c));
 }
 
+/* Hash the abbreviation of the DIE X: its tag, whether it has
+   children, and the names and forms of its attributes.  */
+
+static hashval_t
+abbrev_die_hash_hash (const void *x)
+{
+  const_dw_die_ref die = (const_dw_die_ref) x;
+  hashval_t hash = die->die_tag * 2 + (die->die_child != NULL);
+  dw_attr_ref a;
+  unsigned ix;
+
+  FOR_EACH_VEC_ELT (dw_attr_node, die->die_attr, ix, a)
+    hash = iterative_hash_hashval_t (a->dw_attr * 64 + value_format (a),
+				     hash);
+  return hash;
+}
+
+/* Return true if the DIEs X and Y have the same abbreviation.  */
+
+static int
+abbrev_die_hash_eq (const void *x, const void *y)
+{
+  const_dw_die_ref die1 = (const_dw_die_ref) x;
+  const_dw_die_ref die2 = (const_dw_die_ref) y;
+  dw_attr_ref a1, a2;
+  unsigned ix;
+
+  if (die1->die_tag != die2->die_tag)
+    return 0;
+  if ((die1->die_child != NULL) != (die2->die_child != NULL))
+    return 0;
+
+  if (VEC_length (dw_attr_node, die1->die_attr)
+      != VEC_length (dw_attr_node, die2->die_attr))
+    return 0;
+
+  FOR_EACH_VEC_ELT (dw_attr_node, die2->die_attr, ix, a2)
+    {
+      a1 = VEC_index (dw_attr_node, die1->die_attr, ix);
+      if ((a1->dw_attr != a2->dw_attr)
+	  || (value_format (a1) != value_format (a2)))
+	return 0;
+    }
+  return 1;
+}
+
 /* The format of each DIE (and its attribute value pairs) is encoded in an
    abbreviation table.  This routine builds the abbreviation table and assigns
    a unique abbreviation id for each abbreviation entry.  The children of each
@@ -10603,6 +10657,7 @@ build_abbrev_table (dw_die_ref die)
   dw_die_ref c;
   dw_attr_ref a;
   unsigned ix;
+  void **slot;
 
   /* Scan the DIE references, and mark as external any that refer to
      DIEs from other CUs (i.e. those which are not marked).  */
@@ -10614,38 +10669,18 @@ build_abbrev_table (dw_die_ref die)
 	set_AT_ref_external (a, 1);
       }
 
-  for (abbrev_id = 1; abbrev_id < abbrev_die_table_in_use; ++abbrev_id)
+  if (!abbrev_die_hash)
+    abbrev_die_hash = htab_create (ABBREV_DIE_TABLE_INCREMENT,
+				   abbrev_die_hash_hash, abbrev_die_hash_eq,
+				   NULL);
+  slot = htab_find_slot (abbrev_die_hash, die, INSERT);
+  if (*slot)
+    abbrev_id = ((dw_die_ref) *slot)->die_abbrev;
+  else
     {
-      dw_die_ref abbrev = abbrev_die_table[abbrev_id];
-      dw_attr_ref die_a, abbrev_a;
-      unsigned ix;
-      bool ok = true;
-
-      if (abbrev->die_tag != die->die_tag)
-	continue;
-      if ((abbrev->die_child != NULL) != (die->die_child != NULL))
-	continue;
+      abbrev_id = abbrev_die_table_in_use;
+      *slot = die;
 
-      if (VEC_length (dw_attr_node, abbrev->die_attr)
-	  != VEC_length (dw_attr_node, die->die_attr))
-	continue;
-
-      FOR_EACH_VEC_ELT (dw_attr_node, die->die_attr, ix, die_a)
-	{
-	  abbrev_a = VEC_index (dw_attr_node, abbrev->die_attr, ix);
-	  if ((abbrev_a->dw_attr != die_a->dw_attr)
-	      || (value_format (abbrev_a) != value_format (die_a)))
-	    {
-	      ok = false;
-	      break;
-	    }
-	}
-      if (ok)
-	break;
-    }
-
-  if (abbrev_id >= abbrev_die_table_in_use)
-    {
       if (abbrev_die_table_in_use >= abbrev_die_table_allocated)
 	{
 	  n_alloc = abbrev_die_table_allocated + ABBREV_DIE_TABLE_INCREMENT;
@@ -11097,6 +11132,9 @@ output_abbrev_section (void)
   if (abbrev_die_table_in_use == 1)
     return;
 
+  if (flag_debug_byte_runs)
+    dw2_asm_begin_byte_runs ();
+
   for (abbrev_id = 1; abbrev_id < abbrev_die_table_in_use; ++abbrev_id)
     {
       dw_die_ref abbrev = abbrev_die_table[abbrev_id];
@@ -11126,6 +11164,8 @@ output_abbrev_section (void)
 
   /* Terminate the table.  */
   dw2_asm_output_data (1, 0, NULL);
+
+  dw2_asm_end_byte_runs ();
 }
 
 /* Output a symbol we can use to refer to this DIE from another CU.  */
@@ -11138,6 +11178,7 @@ output_die_symbol (dw_die_ref die)
   if (sym == 0)
     return;
 
+  dw2_asm_flush_byte_runs ();
   if (strncmp (sym, DIE_LABEL_PREFIX, sizeof (DIE_LABEL_PREFIX) - 1) == 0)
     /* We make these global, not weak; if the target doesn't support
        .linkonce, it doesn't support combining the sections, so debugging
@@ -11562,8 +11603,11 @@ output_comp_unit (dw_die_ref die, int output_if_empty)
     }
 
   /* Output debugging information.  */
+  if (flag_debug_byte_runs)
+    dw2_asm_begin_byte_runs ();
   output_compilation_unit_header ();
   output_die (die);
+  dw2_asm_end_byte_runs ();
 
   /* Leave the marks on the main CU, so we can check them in
      output_pubnames.  */
@@ -11615,11 +11659,14 @@ output_comdat_type_unit (comdat_type_node *node)
 #endif
 
   /* Output debugging information.  */
+  if (flag_debug_byte_runs)
+    dw2_asm_begin_byte_runs ();
   output_compilation_unit_header ();
   output_signature (node->signature, "Type Signature");
   dw2_asm_output_data (DWARF_OFFSET_SIZE, node->type_die->die_offset,
 		       "Offset to Type DIE");
   output_die (node->root_die);
+  dw2_asm_end_byte_runs ();
 
   unmark_dies (node->root_die);
 }
@@ -22922,6 +22969,183 @@ htab_ct_eq (const void *of1, const void *of2)
                     DWARF_TYPE_SIGNATURE_SIZE));
 }
 
+/* The -fdebug-types-cache= file is made of blocks, each written by one
+   compilation: a line with "@" and the name of the main input file,
+   followed by the signatures of the type units that compilation output,
+   one in hexadecimal per line.  Only the last block of each input file
+   tells what its object currently provides.  */
+
+/* The number of the last block of an input file in the cache file.  */
+
+struct debug_types_owner
+{
+  char *name;
+  unsigned int block;
+};
+
+static hashval_t
+debug_types_owner_hash (const void *p)
+{
+  return htab_hash_string (((const struct debug_types_owner *) p)->name);
+}
+
+static int
+debug_types_owner_eq (const void *p1, const void *p2)
+{
+  return !strcmp (((const struct debug_types_owner *) p1)->name,
+		  ((const struct debug_types_owner *) p2)->name);
+}
+
+static void
+debug_types_owner_free (void *p)
+{
+  free (((struct debug_types_owner *) p)->name);
+  free (p);
+}
+
+/* Read a line of FILE into *BUF, of *SIZE bytes, which is grown as
+   needed, and strip its newline.  Return false at the end of FILE.  */
+
+static bool
+read_debug_types_cache_line (FILE *file, char **buf, size_t *size)
+{
+  size_t len = 0;
+
+  while (fgets (*buf + len, *size - len, file))
+    {
+      len += strlen (*buf + len);
+      if (len > 0 && (*buf)[len - 1] == '\n')
+	{
+	  (*buf)[len - 1] = '\0';
+	  return true;
+	}
+      *size *= 2;
+      *buf = XRESIZEVEC (char, *buf, *size);
+    }
+  return false;
+}
+
+/* Read the signatures of the type units that the objects of a build
+   other than SELF provide, according to the -fdebug-types-cache= file,
+   into a hash table of comdat type nodes without DIEs.  The blocks of
+   the file are keyed on the absolute names of the objects, and the last
+   block of each object is the one of its last successful compilation.
+   The type units listed for SELF come from a previous compilation of
+   the same object, which this one replaces; SELF is NULL if the output
+   of this compilation is not recorded.  The file may not exist yet.  */
+
+static htab_t
+read_debug_types_cache (const char *self)
+{
+  htab_t table = htab_create (100, htab_ct_hash, htab_ct_eq, free);
+  htab_t owners;
+  struct debug_types_owner key, *owner;
+  comdat_type_node *ctnode;
+  size_t size = 256;
+  char *line;
+  FILE *file;
+  void **slot;
+  unsigned int byte, block;
+  bool live = false;
+  int i;
+
+  file = fopen (flag_debug_types_cache, "r");
+  if (!file)
+    return table;
+
+  owners = htab_create (10, debug_types_owner_hash, debug_types_owner_eq,
+			debug_types_owner_free);
+  line = XNEWVEC (char, size);
+
+  /* Find the last block of each object.  */
+  for (block = 0; read_debug_types_cache_line (file, &line, &size); )
+    if (line[0] == '@')
+      {
+	key.name = line + 1;
+	slot = htab_find_slot (owners, &key, INSERT);
+	if (*slot == NULL)
+	  {
+	    owner = XNEW (struct debug_types_owner);
+	    owner->name = xstrdup (line + 1);
+	    *slot = owner;
+	  }
+	((struct debug_types_owner *) *slot)->block = block++;
+      }
+
+  /* Then read the signatures in those blocks.  The blocks that other
+     compilations append meanwhile are ignored.  */
+  rewind (file);
+  for (block = 0; read_debug_types_cache_line (file, &line, &size); )
+    {
+      if (line[0] == '@')
+	{
+	  key.name = line + 1;
+	  owner = (struct debug_types_owner *) htab_find (owners, &key);
+	  live = (owner != NULL && owner->block == block
+		  && (self == NULL || strcmp (line + 1, self) != 0));
+	  block++;
+	  continue;
+	}
+      if (!live || strlen (line) != 2 * DWARF_TYPE_SIGNATURE_SIZE)
+	continue;
+
+      ctnode = XCNEW (comdat_type_node);
+      for (i = 0; i < DWARF_TYPE_SIGNATURE_SIZE; i++)
+	{
+	  if (!ISXDIGIT (line[2 * i]) || !ISXDIGIT (line[2 * i + 1]))
+	    break;
+	  byte = hex_value (line[2 * i]) * 16 + hex_value (line[2 * i + 1]);
+	  ctnode->signature[i] = byte;
+	}
+      if (i < DWARF_TYPE_SIGNATURE_SIZE)
+	{
+	  free (ctnode);
+	  continue;
+	}
+
+      slot = htab_find_slot (table, ctnode, INSERT);
+      if (*slot)
+	free (ctnode);
+      else
+	*slot = ctnode;
+    }
+
+  free (line);
+  htab_delete (owners);
+  fclose (file);
+  return table;
+}
+
+/* Write the signatures of the type units in NEW_TYPES, a vector of
+   COUNT comdat type nodes, to the -debug-types-cache-list file.  The
+   driver adds them to the -fdebug-types-cache= file as the block of the
+   output of this compilation, once the object has been assembled, so
+   that a failed compilation does not replace the previous block.  */
+
+static void
+write_debug_types_cache (comdat_type_node **new_types, unsigned int count)
+{
+  unsigned int i;
+  int j;
+  FILE *file = fopen (debug_types_cache_list, "w");
+
+  if (!file)
+    {
+      warning (0, "cannot write the type unit list %qs: %m",
+	       debug_types_cache_list);
+      return;
+    }
+  for (i = 0; i < count; i++)
+    {
+      for (j = 0; j < DWARF_TYPE_SIGNATURE_SIZE; j++)
+	fprintf (file, "%02x", new_types[i]->signature[j] & 0xff);
+      putc ('\n', file);
+    }
+  if (fclose (file) != 0)
+    warning (0, "cannot write the type unit list %qs: %m",
+	     debug_types_cache_list);
+}
+
 /* Move a DW_AT_{,MIPS_}linkage_name attribute just added to dw_die_ref
    to the location it would have been added, should we know its
    DECL_ASSEMBLER_NAME when we added other attributes.  This will
@@ -23518,6 +23742,10 @@ dwarf2out_finish (const char *filename)
   limbo_die_node *node, *next_node;
   comdat_type_node *ctnode;
   htab_t comdat_type_table;
+  htab_t debug_types_cache = NULL;
+  comdat_type_node **new_types = NULL;
+  char *debug_types_self = NULL;
+  unsigned int n_comdat_types = 0;
   unsigned int i;
 
   gen_scheduled_generic_parms_dies ();
@@ -23735,6 +23963,20 @@ dwarf2out_finish (const char *filename)
     output_comp_unit (node->die, 0);
 
   comdat_type_table = htab_create (100, htab_ct_hash, htab_ct_eq, NULL);
+  if (flag_debug_types_cache && use_debug_types)
+    {
+      if (debug_types_cache_object
+	  && IS_ABSOLUTE_PATH (debug_types_cache_object))
+	debug_types_self = xstrdup (debug_types_cache_object);
+      else if (debug_types_cache_object)
+	debug_types_self = concat (getpwd (), "/",
+				   debug_types_cache_object, NULL);
+      debug_types_cache = read_debug_types_cache (debug_types_self);
+      for (ctnode = comdat_type_list; ctnode != NULL; ctnode = ctnode->next)
+	n_comdat_types++;
+      new_types = XNEWVEC (comdat_type_node *, n_comdat_types);
+      n_comdat_types = 0;
+    }
   for (ctnode = comdat_type_list; ctnode != NULL; ctnode = ctnode->next)
     {
       void **slot = htab_find_slot (comdat_type_table, ctnode, INSERT);
@@ -23742,6 +23984,16 @@ dwarf2out_finish (const char *filename)
       /* Don't output duplicate types.  */
       if (*slot != HTAB_EMPTY_ENTRY)
         continue;
+      *slot = ctnode;
+
+      /* Nor the types that another object of this build provides; the
+	 references to them only use their signature.  */
+      if (debug_types_cache)
+	{
+	  if (htab_find (debug_types_cache, ctnode))
+	    continue;
+	  new_types[n_comdat_types++] = ctnode;
+	}
 
       /* Add a pointer to the line table for the main compilation unit
          so that the debugger can make sense of DW_AT_decl_file
@@ -23751,9 +24003,16 @@ dwarf2out_finish (const char *filename)
 		        debug_line_section_label);
 
       output_comdat_type_unit (ctnode);
-      *slot = ctnode;
     }
   htab_delete (comdat_type_table);
+  if (debug_types_cache)
+    {
+      if (debug_types_cache_list)
+	write_debug_types_cache (new_types, n_comdat_types);
+      htab_delete (debug_types_cache);
+      free (new_types);
+      free (debug_types_self);
+    }
 
   /* Output the main compilation unit if non-empty or if .debug_macinfo
      will be emitted.  */
@@ -129,6 +129,20 @@ enum excess_precision
   EXCESS_PRECISION_STANDARD
 };
 
+/* The output format of -ftime-report.  */
+enum time_report_format
+{
+  TIME_REPORT_FORMAT_TEXT,
+  TIME_REPORT_FORMAT_JSON
+};
+
+/* The algorithm used to compress the LTO IL.  */
+enum lto_compression_algorithm
+{
+  LTO_COMPRESSION_ZLIB,
+  LTO_COMPRESSION_LZ4
+};
+
 /* Selection of the graph form.  */
 enum graph_dump_types
 {
@@ -45,6 +45,11 @@ compilation is specified by a string called a "spec".  */
 #include "opts.h"
 #include "vec.h"
 #include "filenames.h"
+#include "md5.h"
+#include <dirent.h>
+#ifdef HAVE_UTIME_H
+#include <utime.h>
+#endif
 
 /* By default there is no special suffix for target executables.  */
 /* FIXME: when autoconf is fixed, remove the host check - dj */
@@ -266,6 +271,7 @@ static const char *compare_debug_dump_opt_spec_function (int, const char **);
 static const char *compare_debug_self_opt_spec_function (int, const char **);
 static const char *compare_debug_auxbase_opt_spec_function (int, const char **);
 static const char *pass_through_libs_spec_func (int, const char **);
+static const char *debug_types_cache_spec_function (int, const char **);
 
 /* The Specs Language
 
@@ -787,7 +793,9 @@ static const char *cc1_options =
  %{!fsyntax-only:%{S:%W{o*}%{!o*:-o %b.s}}}\
  %{fsyntax-only:-o %j} %{-param*}\
  %{fmudflap|fmudflapth:-fno-builtin -fno-merge-constants}\
- %{coverage:-fprofile-arcs -ftest-coverage}";
+ %{coverage:-fprofile-arcs -ftest-coverage}\
+ %{fdebug-types-cache=*:%{c|S:-debug-types-cache-object %{o*:%*}%{!o*:%b%{c:%O}%{S:.s}}\
+   -debug-types-cache-list %d%u.dtc}}";
 
 static const char *asm_options =
 "%{-target-help:%:print-asm-header()} "
@@ -798,16 +806,25 @@ static const char *asm_options =
 #endif
 "%a %Y %{c:%W{o*}%{!o*:-o %w%b%O}}%{!c:-o %d%w%u%O}";
 
+/* Once the output of a compilation with -fdebug-types-cache= has been
+   produced, add the type units the compiler listed to the cache.  */
+static const char *debug_types_cache_commit =
+"%{fdebug-types-cache=*:%{c|S:\n\
+   %:debug-types-cache(%{fdebug-types-cache=*:%*}\
+     %{o*:%*}%{!o*:%b%{c:%O}%{S:.s}} %U.dtc)}}";
+
 static const char *invoke_as =
 #ifdef AS_NEEDS_DASH_FOR_PIPED_INPUT
 "%{!fwpa:\
    %{fcompare-debug=*|fdump-final-insns=*:%:compare-debug-dump-opt()}\
    %{!S:-o %|.s |\n as %(asm_options) %|.s %A }\
+   %(debug_types_cache_commit)\
   }";
 #else
 "%{!fwpa:\
    %{fcompare-debug=*|fdump-final-insns=*:%:compare-debug-dump-opt()}\
    %{!S:-o %|.s |\n as %(asm_options) %m.s %A }\
+   %(debug_types_cache_commit)\
   }";
 #endif
 
@@ -1177,6 +1194,7 @@ static struct spec_list static_specs[] =
   INIT_STATIC_SPEC ("asm_final",		&asm_final_spec),
   INIT_STATIC_SPEC ("asm_options",		&asm_options),
   INIT_STATIC_SPEC ("invoke_as",		&invoke_as),
+  INIT_STATIC_SPEC ("debug_types_cache_commit", &debug_types_cache_commit),
   INIT_STATIC_SPEC ("cpp",			&cpp_spec),
   INIT_STATIC_SPEC ("cpp_options",		&cpp_options),
   INIT_STATIC_SPEC ("cpp_debug_options",	&cpp_debug_options),
@@ -1252,6 +1270,7 @@ static const struct spec_function static_spec_functions[] =
   { "compare-debug-self-opt",	compare_debug_self_opt_spec_function },
   { "compare-debug-auxbase-opt", compare_debug_auxbase_opt_spec_function },
   { "pass-through-libs",	pass_through_libs_spec_func },
+  { "debug-types-cache",	debug_types_cache_spec_function },
 #ifdef EXTRA_SPEC_FUNCTIONS
   EXTRA_SPEC_FUNCTIONS
 #endif
@@ -2445,6 +2464,504 @@ add_sysrooted_prefix (struct path_prefix *pprefix, const char *prefix,
 	      require_machine_suffix, os_multilib);
 }
 
+/* The compile cache.  When it is enabled with --compile-cache=DIR, every
+   compiler proper run on preprocessed input is keyed on a hash of that
+   input, of its other arguments and of the compiler itself.  The object
+   file that the following assembler run produces is stored in DIR under
+   that key, together with the diagnostics of the compiler, and is reused
+   instead of running the compiler and the assembler the next time the
+   same key comes up.  */
+
+/* The directory of the compile cache, or NULL if it is not used.  */
+static const char *compile_cache_dir;
+
+/* The maximum size of the compile cache in megabytes, 0 for no limit.  */
+static unsigned long compile_cache_size = 1024;
+
+/* Where the compile cache stands for the current input file.  */
+static enum
+{
+  /* No compilation is being looked up.  */
+  CACHE_IDLE,
+  /* The compiler is running because its output was not cached.  */
+  CACHE_COMPILING,
+  /* The next command is the assembler, whose output must be stored.  */
+  CACHE_STORE,
+  /* The next command is the assembler, which must not be run because
+     its output was cached.  */
+  CACHE_REUSE
+} compile_cache_state;
+
+/* The cache entry of the current input file, without suffix, and the
+   file holding either the diagnostics of the compiler (when storing) or
+   a private copy of the cached object file (when reusing).  */
+static char *compile_cache_entry;
+static char *compile_cache_file;
+
+/* Copy the contents of the file FROM to the stream TO.  Return true if
+   successful.  */
+
+static bool
+copy_file_to_stream (const char *from, FILE *to)
+{
+  char buf[8192];
+  size_t len;
+  bool ok;
+  FILE *in = fopen (from, "rb");
+
+  if (!in)
+    return false;
+  while ((len = fread (buf, 1, sizeof buf, in)) > 0)
+    if (fwrite (buf, 1, len, to) != len)
+      break;
+  ok = !ferror (in) && !ferror (to);
+  fclose (in);
+  return ok;
+}
+
+/* Copy the file FROM to a new file TO.  Return true if successful.  */
+
+static bool
+copy_file (const char *from, const char *to)
+{
+  bool ok;
+  FILE *out = fopen (to, "wb");
+
+  if (!out)
+    return false;
+  ok = copy_file_to_stream (from, out);
+  if (fclose (out) != 0)
+    ok = false;
+  if (!ok)
+    unlink (to);
+  return ok;
+}
+
+/* Atomically install a copy of the file FROM as the cache file TO.  */
+
+static void
+compile_cache_install (const char *from, const char *to)
+{
+  char *tmp = concat (to, ".tmp", NULL);
+  char pid[32];
+
+  sprintf (pid, "%ld", (long) getpid ());
+  tmp = reconcat (tmp, tmp, pid, NULL);
+  if (copy_file (from, tmp) && rename (tmp, to) != 0)
+    unlink (tmp);
+  free (tmp);
+}
+
+/* Add the string S, including its terminating null, to CTX.  */
+
+static void
+md5_process_string (struct md5_ctx *ctx, const char *s)
+{
+  md5_process_bytes (s, strlen (s) + 1, ctx);
+}
+
+/* Add the contents of the file NAME to CTX.  Return false if it cannot
+   be read.  */
+
+static bool
+md5_process_file (struct md5_ctx *ctx, const char *name)
+{
+  char buf[8192];
+  size_t len;
+  bool ok;
+  FILE *in = fopen (name, "rb");
+
+  if (!in)
+    return false;
+  while ((len = fread (buf, 1, sizeof buf, in)) > 0)
+    md5_process_bytes (buf, len, ctx);
+  ok = !ferror (in);
+  fclose (in);
+  return ok;
+}
+
+/* Return the name, without suffix, of the cache entry for the compiler
+   command ARGV, whose preprocessed input is the argument at index INPUT,
+   or NULL if its output must not be cached.  */
+
+static char *
+compile_cache_key (const char *const *argv, int input)
+{
+  static const char *const uncacheable[] = {
+    /* Options producing files other than the assembler output.  */
+    "-fdump-", "-fprofile-arcs", "-fprofile-generate", "-ftest-coverage",
+    "-fstack-usage", "-aux-info", "-fcompare-debug", "--output-pch=",
+    "-ftime-report",
+    /* Options making the output depend on files other than the input.  */
+    "-fdebug-types-cache"
+  };
+  /* Assembler options producing files other than the object file:
+     listings and dependencies.  */
+  static const char *const uncacheable_as[] = { "-a", "--MD" };
+  struct md5_ctx ctx;
+  unsigned char digest[16];
+  char *key;
+  struct stat st;
+  const char *auxbase = NULL, *profile_dir = NULL;
+  bool debug = false, profile_use = false, strip = false;
+  char *opt;
+  unsigned ix;
+  int i;
+  size_t j;
+
+  md5_init_ctx (&ctx);
+  md5_process_string (&ctx, version_string);
+  md5_process_string (&ctx, pkgversion_string);
+
+  /* A rebuilt compiler may not change its version.  */
+  if (stat (argv[0], &st) != 0)
+    return NULL;
+  md5_process_string (&ctx, argv[0]);
+  md5_process_bytes (&st.st_size, sizeof st.st_size, &ctx);
+  md5_process_bytes (&st.st_mtime, sizeof st.st_mtime, &ctx);
+
+  for (i = 1; argv[i]; i++)
+    {
+      const char *arg = argv[i];
+
+      for (j = 0; j < ARRAY_SIZE (uncacheable); j++)
+	if (strncmp (arg, uncacheable[j], strlen (uncacheable[j])) == 0)
+	  return NULL;
+
+      /* The input and output are temporary files, whose names do not
+	 matter.  */
+      if (i == input)
+	continue;
+      if (strcmp (arg, "-o") == 0 && argv[i + 1])
+	{
+	  i++;
+	  continue;
+	}
+
+      if (arg[0] == '-' && arg[1] == 'g' && strcmp (arg, "-g0") != 0)
+	debug = true;
+      else if (strcmp (arg, "-fprofile-use") == 0)
+	profile_use = true;
+      else if (strncmp (arg, "-fprofile-use=", 14) == 0)
+	profile_use = true, profile_dir = arg + 14;
+      else if (strncmp (arg, "-fprofile-dir=", 14) == 0)
+	profile_dir = arg + 14;
+      else if ((strcmp (arg, "-auxbase") == 0
+		|| strcmp (arg, "-auxbase-strip") == 0)
+	       && argv[i + 1])
+	{
+	  auxbase = argv[i + 1];
+	  strip = arg[8] != '\0';
+	}
+
+      md5_process_string (&ctx, arg);
+    }
+
+  /* The object file also depends on the options passed on to the
+     assembler by -Wa and -Xassembler.  */
+  md5_process_string (&ctx, "-Wa");
+  FOR_EACH_VEC_ELT (char_p, assembler_options, ix, opt)
+    {
+      for (j = 0; j < ARRAY_SIZE (uncacheable_as); j++)
+	if (strncmp (opt, uncacheable_as[j], strlen (uncacheable_as[j])) == 0)
+	  return NULL;
+      md5_process_string (&ctx, opt);
+    }
+
+  if (!md5_process_file (&ctx, argv[input]))
+    return NULL;
+
+  /* The debug information records the current directory.  */
+  if (debug)
+    md5_process_string (&ctx, getpwd ());
+
+  /* The profile feedback is read from auxbase.gcda, in the profile
+     directory if one was given.  */
+  if (profile_use)
+    {
+      char *gcda, *base, *dot;
+
+      if (!auxbase)
+	return NULL;
+      base = xstrdup (auxbase);
+      dot = strrchr (base, '.');
+      if (strip && dot && dot >= lbasename (base))
+	*dot = '\0';
+      gcda = (profile_dir
+	      ? concat (profile_dir, dir_separator_str, base, ".gcda", NULL)
+	      : concat (base, ".gcda", NULL));
+      if (!md5_process_file (&ctx, gcda))
+	md5_process_string (&ctx, "no profile");
+      free (gcda);
+      free (base);
+    }
+
+  md5_finish_ctx (&ctx, digest);
+  key = XNEWVEC (char, strlen (compile_cache_dir) + 2 + 2 * sizeof digest);
+  i = sprintf (key, "%s%s", compile_cache_dir, dir_separator_str);
+  for (j = 0; j < sizeof digest; j++)
+    i += sprintf (key + i, "%02x", digest[j]);
+  return key;
+}
+
+/* A file in the compile cache, for compile_cache_evict.  */
+
+struct cache_file
+{
+  char *name;
+  time_t mtime;
+  off_t size;
+};
+
+/* qsort callback ordering cache files from the least recently used.  */
+
+static int
+cache_file_cmp (const void *p1, const void *p2)
+{
+  const struct cache_file *f1 = (const struct cache_file *) p1;
+  const struct cache_file *f2 = (const struct cache_file *) p2;
+
+  if (f1->mtime != f2->mtime)
+    return f1->mtime < f2->mtime ? -1 : 1;
+  return strcmp (f1->name, f2->name);
+}
+
+/* Remove the least recently used object files, with their diagnostics,
+   until the compile cache is back under 90% of its size limit.  Return
+   the size of the files left in the cache.  */
+
+static double
+compile_cache_evict (void)
+{
+  DIR *dir;
+  struct dirent *d;
+  struct cache_file *files = NULL;
+  size_t n_files = 0, alloc_files = 0, i;
+  double total = 0, limit = compile_cache_size * 1048576.0;
+
+  if (!(dir = opendir (compile_cache_dir)))
+    return 0;
+
+  while ((d = readdir (dir)) != NULL)
+    {
+      struct stat st;
+      char *name = concat (compile_cache_dir, dir_separator_str,
+			   d->d_name, NULL);
+
+      if (stat (name, &st) != 0 || !S_ISREG (st.st_mode))
+	{
+	  free (name);
+	  continue;
+	}
+      total += st.st_size;
+      if (n_files == alloc_files)
+	{
+	  alloc_files = alloc_files * 2 + 64;
+	  files = XRESIZEVEC (struct cache_file, files, alloc_files);
+	}
+      files[n_files].name = name;
+      files[n_files].mtime = st.st_mtime;
+      files[n_files].size = st.st_size;
+      n_files++;
+    }
+  closedir (dir);
+
+  if (total > limit)
+    {
+      /* Diagnostics are removed along with their object file, which is
+	 touched whenever it is used, so only object files are ordered.  */
+      qsort (files, n_files, sizeof (struct cache_file), cache_file_cmp);
+      for (i = 0; i < n_files && total > 0.9 * limit; i++)
+	{
+	  size_t len = strlen (files[i].name);
+	  char *diag;
+	  struct stat st;
+
+	  if (len < 2 || strcmp (files[i].name + len - 2, ".o") != 0)
+	    continue;
+	  if (unlink (files[i].name) == 0)
+	    total -= files[i].size;
+	  diag = xstrdup (files[i].name);
+	  diag[len - 2] = '\0';
+	  diag = reconcat (diag, diag, ".diag", NULL);
+	  if (stat (diag, &st) == 0 && unlink (diag) == 0)
+	    total -= st.st_size;
+	  free (diag);
+	}
+    }
+
+  for (i = 0; i < n_files; i++)
+    free (files[i].name);
+  free (files);
+  return total;
+}
+
+/* Add ADDED bytes, just stored in the compile cache, to the total size
+   of the cache kept in its "size" file, and evict entries if the total
+   goes over the size limit.  Concurrent compilations may lose some of
+   the updates of the total; the eviction recomputes it from the files
+   actually present.  */
+
+static void
+compile_cache_account (double added)
+{
+  char *name, *tmp;
+  char pid[32];
+  double total = 0;
+  FILE *f;
+
+  if (!compile_cache_size)
+    return;
+
+  name = concat (compile_cache_dir, dir_separator_str, "size", NULL);
+  f = fopen (name, "r");
+  if (f)
+    {
+      if (fscanf (f, "%lf", &total) != 1 || total < 0)
+	total = 0;
+      fclose (f);
+    }
+  total += added;
+  if (total > compile_cache_size * 1048576.0)
+    total = compile_cache_evict ();
+
+  sprintf (pid, ".tmp%ld", (long) getpid ());
+  tmp = concat (name, pid, NULL);
+  f = fopen (tmp, "w");
+  if (f)
+    {
+      fprintf (f, "%.0f\n", total);
+      if (fclose (f) != 0 || rename (tmp, name) != 0)
+	unlink (tmp);
+    }
+  free (tmp);
+  free (name);
+}
+
+/* Called by execute before running the command ARGV when the compile
+   cache is enabled.  Return true if the command need not run because
+   its output is in the cache.  Otherwise set *ERRNAME to the file the
+   diagnostics of the command must go to, if they are to be cached.  */
+
+static bool
+compile_cache_before (const char *const *argv, const char **errname)
+{
+  const char *prog = lbasename (argv[0]);
+  char *object;
+  int i, input = 0;
+
+  /* The assembler for a cached compilation: copy the object file to its
+     output.  */
+  if (compile_cache_state == CACHE_REUSE)
+    {
+      compile_cache_state = CACHE_IDLE;
+      for (i = 1; argv[i]; i++)
+	if (strcmp (argv[i], "-o") == 0 && argv[i + 1])
+	  {
+	    if (!copy_file (compile_cache_file, argv[i + 1]))
+	      pfatal_with_name (argv[i + 1]);
+	    return true;
+	  }
+      fatal_error ("no output file for cached object %s",
+		   compile_cache_entry);
+    }
+  if (compile_cache_state == CACHE_STORE)
+    return false;
+  compile_cache_state = CACHE_IDLE;
+
+  /* Only a compiler proper reading preprocessed input is cached.  */
+  if (strncmp (prog, "cc1", 3) != 0)
+    return false;
+  for (i = 1; argv[i]; i++)
+    if (strcmp (argv[i], "-fpreprocessed") == 0 && argv[i + 1])
+      input = i + 1;
+  if (!input)
+    return false;
+
+  free (compile_cache_entry);
+  compile_cache_entry = compile_cache_key (argv, input);
+  if (!compile_cache_entry)
+    return false;
+
+  /* Take a private copy of a cached object file, so that it cannot be
+     evicted before the assembler step.  */
+  object = concat (compile_cache_entry, ".o", NULL);
+  compile_cache_file = make_temp_file (".o");
+  record_temp_file (compile_cache_file, 1, 1);
+  if (copy_file (object, compile_cache_file))
+    {
+      char *diag = concat (compile_cache_entry, ".diag", NULL);
+
+      if (verbose_flag)
+	fnotice (stderr, "Reusing cached object %s\n", object);
+#ifdef HAVE_UTIME_H
+      utime (object, NULL);
+#endif
+      copy_file_to_stream (diag, stderr);
+      free (diag);
+      free (object);
+      compile_cache_state = CACHE_REUSE;
+      return true;
+    }
+  free (object);
+
+  compile_cache_file = make_temp_file (".diag");
+  record_temp_file (compile_cache_file, 1, 1);
+  *errname = compile_cache_file;
+  compile_cache_state = CACHE_COMPILING;
+  return false;
+}
+
+/* Called by execute after running the command ARGV when the compile
+   cache is enabled.  FAILED is true if it failed.  */
+
+static void
+compile_cache_after (const char *const *argv, bool failed)
+{
+  int i;
+
+  switch (compile_cache_state)
+    {
+    case CACHE_COMPILING:
+      /* Show the diagnostics of the compiler, which went to a file.  */
+      copy_file_to_stream (compile_cache_file, stderr);
+      compile_cache_state = failed ? CACHE_IDLE : CACHE_STORE;
+      break;
+
+    case CACHE_STORE:
+      compile_cache_state = CACHE_IDLE;
+      if (failed)
+	break;
+      for (i = 1; argv[i]; i++)
+	if (strcmp (argv[i], "-o") == 0 && argv[i + 1])
+	  {
+	    char *diag = concat (compile_cache_entry, ".diag", NULL);
+	    char *object = concat (compile_cache_entry, ".o", NULL);
+	    struct stat st;
+	    double added = 0;
+
+	    /* The diagnostics go first, so that whoever finds the object
+	       file also finds them.  */
+	    if (stat (compile_cache_file, &st) == 0 && st.st_size > 0)
+	      {
+		compile_cache_install (compile_cache_file, diag);
+		added += st.st_size;
+	      }
+	    compile_cache_install (argv[i + 1], object);
+	    if (stat (argv[i + 1], &st) == 0)
+	      added += st.st_size;
+	    free (diag);
+	    free (object);
+	    compile_cache_account (added);
+	    break;
+	  }
+      break;
+
+    default:
+      break;
+    }
+}
+
 /* Execute the command specified by the arguments on the current line of spec.
    When using pipes, this includes several piped-together commands
    with `|' between them.
@@ -2464,6 +2981,7 @@ execute (void)
     const char **argv;		/* vector of args.  */
   };
   const char *arg;
+  const char *errname = NULL;
 
   struct command *commands;	/* each command buffer with above info.  */
 
@@ -2622,6 +3140,14 @@ execute (void)
     }
 #endif
 
+  /* The output of the command may already be in the compile cache.  */
+  if (compile_cache_dir && n_commands == 1
+      && compile_cache_before (commands[0].argv, &errname))
+    {
+      execution_count++;
+      return 0;
+    }
+
   /* Run each piped subprocess.  */
 
   pex = pex_init (PEX_USE_PIPES | ((report_times || report_times_to_file)
@@ -2640,7 +3166,7 @@ execute (void)
 			((i + 1 == n_commands ? PEX_LAST : 0)
 			 | (string == commands[i].prog ? PEX_SEARCH : 0)),
 			string, CONST_CAST (char **, commands[i].argv),
-			NULL, NULL, &err);
+			NULL, errname, &err);
       if (errmsg != NULL)
 	{
 	  if (err == 0)
@@ -2678,6 +3204,11 @@ execute (void)
 
     pex_free (pex);
 
+    if (compile_cache_dir && n_commands == 1)
+      compile_cache_after (commands[0].argv,
+			   !WIFEXITED (statuses[0])
+			   || WEXITSTATUS (statuses[0]) != 0);
+
     for (i = 0; i < n_commands; ++i)
       {
 	int status = statuses[i];
@@ -2962,6 +3493,9 @@ display_help (void)
   -no-canonical-prefixes   Do not canonicalize paths when building relative\n\
                            prefixes to other gcc components\n"), stdout);
   fputs (_("  -pipe                    Use pipes rather than intermediate files\n"), stdout);
+  fputs (_("\
+  --compile-cache=<dir>    Reuse object files compiled earlier from the same\n\
+                           preprocessed input, keeping them in <dir>\n"), stdout);
   fputs (_("  -time                    Time the execution of each subprocess\n"), stdout);
   fputs (_("  -specs=<file>            Override built-in specs with the contents of <file>\n"), stdout);
   fputs (_("  -std=<standard>          Assume that the input sources are for <standard>\n"), stdout);
@@ -3410,6 +3944,16 @@ driver_handle_option (struct gcc_options *opts,
       do_save = false;
       break;
 
+    case OPT__compile_cache_:
+      compile_cache_dir = arg;
+      do_save = false;
+      break;
+
+    case OPT__compile_cache_size_:
+      compile_cache_size = value;
+      do_save = false;
+      break;
+
     case OPT__sysroot_:
       target_system_root = arg;
       target_system_root_changed = 1;
@@ -3939,6 +4483,26 @@ process_command (unsigned int decoded_options_count,
       compare_debug = 1;
     }
 
+  /* The compile cache only stores object files, and needs to see the
+     preprocessed input of the compiler.  */
+  if (compile_cache_dir)
+    {
+      bool cacheable = have_c && !use_pipes && !save_temps_flag
+		       && !compare_debug && !wrapper_string;
+
+      for (j = 0; j < (unsigned int) n_switches && cacheable; j++)
+	if (strcmp (switches[j].part1, "S") == 0
+	    || strcmp (switches[j].part1, "E") == 0
+	    || strcmp (switches[j].part1, "M") == 0
+	    || strcmp (switches[j].part1, "MM") == 0
+	    || strcmp (switches[j].part1, "fsyntax-only") == 0)
+	  cacheable = false;
+      if (cacheable)
+	save_switch ("-no-integrated-cpp", 0, NULL, true);
+      else
+	compile_cache_dir = NULL;
+    }
+
   /* Ensure we only invoke each subprocess once.  */
   if (print_subprocess_help || print_help_list || print_version)
     {
@@ -8294,3 +8858,57 @@ pass_through_libs_spec_func (int argc, const char **argv)
     }
   return prepended;
 }
+
+/* %:debug-types-cache spec function.  Its arguments are the
+   -fdebug-types-cache= file, the output file of a compilation, which
+   has just been produced, and the file where the compiler listed the
+   type units it output.  Append that list to the cache as the block of
+   the output file, which replaces its previous block.  The block is
+   written with a single write to a file opened for appending, so that
+   the compilations of a parallel build may share the cache.  */
+
+static const char *
+debug_types_cache_spec_function (int argc, const char **argv)
+{
+  const char *cache, *output, *list;
+  char *buf;
+  size_t len;
+  struct stat st;
+  FILE *in;
+  int fd;
+
+  if (argc < 3)
+    fatal_error ("too few arguments to %%:debug-types-cache");
+
+  /* Only the last -fdebug-types-cache= option counts.  */
+  cache = argv[argc - 3];
+  output = argv[argc - 2];
+  list = argv[argc - 1];
+
+  if (IS_ABSOLUTE_PATH (output))
+    buf = concat ("@", output, "\n", NULL);
+  else
+    buf = concat ("@", getpwd (), "/", output, "\n", NULL);
+  len = strlen (buf);
+
+  /* The compiler does not list anything when it outputs no debugging
+     information, and the block of the output is then empty.  */
+  in = fopen (list, "r");
+  if (in)
+    {
+      if (fstat (fileno (in), &st) == 0 && st.st_size > 0)
+	{
+	  buf = XRESIZEVEC (char, buf, len + st.st_size);
+	  len += fread (buf + len, 1, st.st_size, in);
+	}
+      fclose (in);
+    }
+
+  fd = open (cache, O_WRONLY | O_APPEND | O_CREAT, 0666);
+  if (fd < 0 || write (fd, buf, len) != (ssize_t) len)
+    warning (0, "cannot update the type unit cache %qs: %m", cache);
+  if (fd >= 0)
+    close (fd);
+  free (buf);
+  return NULL;
+}
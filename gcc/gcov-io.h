@@ -326,7 +326,7 @@ typedef HOST_WIDEST_INT gcov_type;
 #define GCOV_COUNTER_V_DELTA	4  /* The most common difference between
 				      consecutive values of expression.  */
 
-#define GCOV_COUNTER_V_INDIR	5  /* The most common indirect address */
+#define GCOV_COUNTER_V_INDIR	5  /* The most common indirect addresses */
 #define GCOV_COUNTER_AVERAGE	6  /* Compute average value passed to the
 				      counter.  */
 #define GCOV_COUNTER_IOR	7  /* IOR of the all values passed to
@@ -335,6 +335,12 @@ typedef HOST_WIDEST_INT gcov_type;
 				      profiling.  */
 #define GCOV_COUNTERS		8
 
+/* Number of indirect call targets tracked per call site, and the
+   number of counters this takes: the total number of calls followed
+   by GCOV_ICALL_TOPN_VAL (target, count) pairs.  */
+#define GCOV_ICALL_TOPN_VAL	4
+#define GCOV_ICALL_TOPN_NCOUNTS	(1 + 2 * GCOV_ICALL_TOPN_VAL)
+
 /* Number of counters used for value profiling.  */
 #define GCOV_N_VALUE_COUNTERS \
   (GCOV_LAST_VALUE_COUNTER - GCOV_FIRST_VALUE_COUNTER + 1)
@@ -349,7 +355,7 @@ typedef HOST_WIDEST_INT gcov_type;
 				 "__gcov_merge_add",	\
 				 "__gcov_merge_single",	\
 				 "__gcov_merge_delta",  \
-				 "__gcov_merge_single", \
+				 "__gcov_merge_icall_topn", \
 				 "__gcov_merge_add",	\
 				 "__gcov_merge_ior"}
 
@@ -468,11 +474,16 @@ extern void __gcov_merge_delta (gcov_type *, unsigned) ATTRIBUTE_HIDDEN;
 /* The merge function that just ors the counters together.  */
 extern void __gcov_merge_ior (gcov_type *, unsigned) ATTRIBUTE_HIDDEN;
 
+/* The merge function to choose the most common indirect call targets.  */
+extern void __gcov_merge_icall_topn (gcov_type *, unsigned) ATTRIBUTE_HIDDEN;
+
 /* The profiler functions.  */
 extern void __gcov_interval_profiler (gcov_type *, gcov_type, int, unsigned);
 extern void __gcov_pow2_profiler (gcov_type *, gcov_type);
 extern void __gcov_one_value_profiler (gcov_type *, gcov_type);
 extern void __gcov_indirect_call_profiler (gcov_type *, gcov_type, void *, void *);
+extern void __gcov_indirect_call_topn_profiler (gcov_type *, gcov_type,
+						void *, void *);
 extern void __gcov_average_profiler (gcov_type *, gcov_type);
 extern void __gcov_ior_profiler (gcov_type *, gcov_type);
 
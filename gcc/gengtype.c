@@ -2228,6 +2228,9 @@ struct write_types_data
   const char *reorder_note_routine;
   const char *comment;
   int skip_hooks;		/* skip hook generation if non zero */
+  const char *child_marker_routine; /* if non NULL, marks pointed-to
+				       structures with their marking
+				       routine instead of calling it */
 };
 
 static void output_escaped_param (struct walk_type_data *d,
@@ -3107,9 +3110,14 @@ write_types (outf_p output_header, type_p structures, type_p param_structs,
 	oprintf (output_header, "#define gt_%s_", wtd->prefix);
 	output_mangled_typename (output_header, s);
 	oprintf (output_header, "(X) do { \\\n");
-	oprintf (output_header,
-		 "  if (X != NULL) gt_%sx_%s (X);\\\n", wtd->prefix,
-		 s->u.s.tag);
+	if (wtd->child_marker_routine)
+	  oprintf (output_header,
+		   "  if (X != NULL) %s (X, gt_%sx_%s);\\\n",
+		   wtd->child_marker_routine, wtd->prefix, s->u.s.tag);
+	else
+	  oprintf (output_header,
+		   "  if (X != NULL) gt_%sx_%s (X);\\\n", wtd->prefix,
+		   s->u.s.tag);
 	oprintf (output_header, "  } while (0)\n");
 
 	for (opt = s->u.s.opt; opt; opt = opt->next)
@@ -3243,14 +3251,14 @@ write_types (outf_p output_header, type_p structures, type_p param_structs,
 static const struct write_types_data ggc_wtd = {
   "ggc_m", NULL, "ggc_mark", "ggc_test_and_set_mark", NULL,
   "GC marker procedures.  ",
-  FALSE
+  FALSE, "ggc_mark_child"
 };
 
 static const struct write_types_data pch_wtd = {
   "pch_n", "pch_p", "gt_pch_note_object", "gt_pch_note_object",
   "gt_pch_note_reorder",
   "PCH type-walking procedures.  ",
-  TRUE
+  TRUE, NULL
 };
 
 /* Write out the local pointer-walking routines.  */
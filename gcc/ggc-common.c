@@ -38,6 +38,9 @@ along with GCC; see the file COPYING3.  If not see
 /* When set, ggc_collect will do collection.  */
 bool ggc_force_collect;
 
+/* True while several threads are marking objects.  */
+bool ggc_parallel_marking;
+
 /* When true, protect the contents of the identifier hash table.  */
 bool ggc_protect_identifiers = true;
 
@@ -157,8 +160,9 @@ ggc_mark_roots (void)
     for (rti = *rt; rti->base != NULL; rti++)
       memset (rti->base, 0, rti->stride);
 
-  for (rt = gt_ggc_rtab; *rt; rt++)
-    ggc_mark_root_tab (*rt);
+  if (! ggc_mark_roots_parallel (gt_ggc_rtab))
+    for (rt = gt_ggc_rtab; *rt; rt++)
+      ggc_mark_root_tab (*rt);
 
   FOR_EACH_VEC_ELT (const_ggc_root_tab_t, extra_root_vec, i, rtp)
     ggc_mark_root_tab (rtp);
@@ -601,6 +605,53 @@ gt_pch_save (FILE *f)
   htab_delete (saving_htab);
 }
 
+/* The PCH data that gt_pch_reserve mapped for gt_pch_restore, and what
+   the host hook returned for it.  */
+static void *reserved_pch_base;
+static size_t reserved_pch_size;
+static int reserved_pch_result;
+
+/* Map the data of the PCH file open on FD, whose position is where
+   gt_pch_save started writing, at the address it was saved for, and
+   keep it for gt_pch_restore.  Return false if that address is not
+   available, in which case the PCH file cannot be used.  The position
+   of FD is not preserved.  */
+
+bool
+gt_pch_reserve (int fd)
+{
+  const struct ggc_root_tab *const *rt;
+  const struct ggc_root_tab *rti;
+  struct mmap_info mmi;
+  off_t skip = 0;
+  int result;
+
+  /* Skip the scalar variables and the global pointers.  */
+  for (rt = gt_pch_scalar_rtab; *rt; rt++)
+    for (rti = *rt; rti->base != NULL; rti++)
+      skip += rti->stride;
+  for (rt = gt_ggc_rtab; *rt; rt++)
+    for (rti = *rt; rti->base != NULL; rti++)
+      skip += rti->nelt * sizeof (void *);
+  for (rt = gt_pch_cache_rtab; *rt; rt++)
+    for (rti = *rt; rti->base != NULL; rti++)
+      skip += rti->nelt * sizeof (void *);
+
+  if (lseek (fd, skip, SEEK_CUR) == (off_t) -1
+      || read (fd, &mmi, sizeof (mmi)) != sizeof (mmi))
+    fatal_error ("can%'t read PCH file: %m");
+
+  result = host_hooks.gt_pch_use_address (mmi.preferred_base, mmi.size,
+					  fd, mmi.offset);
+  if (result < 0)
+    return false;
+
+  reserved_pch_base = mmi.preferred_base;
+  reserved_pch_size = mmi.size;
+  reserved_pch_result = result;
+  return true;
+}
+
 /* Read the state of the compiler back in from F.  */
 
 void
@@ -643,8 +694,13 @@ gt_pch_restore (FILE *f)
   if (fread (&mmi, sizeof (mmi), 1, f) != 1)
     fatal_error ("can%'t read PCH file: %m");
 
-  result = host_hooks.gt_pch_use_address (mmi.preferred_base, mmi.size,
-					  fileno (f), mmi.offset);
+  if (reserved_pch_base == mmi.preferred_base
+      && reserved_pch_size == mmi.size)
+    result = reserved_pch_result;
+  else
+    result = host_hooks.gt_pch_use_address (mmi.preferred_base, mmi.size,
+					    fileno (f), mmi.offset);
+  reserved_pch_base = NULL;
   if (result < 0)
     fatal_error ("had to relocate PCH");
   if (result == 0)
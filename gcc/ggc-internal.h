@@ -27,6 +27,11 @@ along with GCC; see the file COPYING3.  If not see
 /* Call ggc_set_mark on all the roots.  */
 extern void ggc_mark_roots (void);
 
+/* Mark the roots in the NULL-terminated vector of root tables RTAB
+   using several threads, if the collector is able and configured to.
+   Return false if nothing was marked.  */
+extern bool ggc_mark_roots_parallel (const struct ggc_root_tab *const *);
+
 /* Stringpool.  */
 
 /* Mark the entries in the string pool.  */
@@ -50,6 +50,21 @@ along with GCC; see the file COPYING3.  If not see
 #define USING_MALLOC_PAGE_GROUPS
 #endif
 
+/* Generational collection needs to know which pages were written to
+   since the previous collection.  We find out by write-protecting them
+   and catching the resulting faults, which requires pages obtained
+   from mmap and signal handlers that are told the faulting address.  */
+#if defined (USING_MMAP) && defined (SA_SIGINFO) && defined (PROT_READ)
+#define GGC_GENERATIONAL
+#endif
+
+/* Marking and sweeping with several threads needs atomic updates of
+   the in-use bitmaps.  */
+#if defined (HAVE_PTHREAD) && defined (HAVE_SYNC_BUILTINS)
+#define GGC_PARALLEL
+#include <pthread.h>
+#endif
+
 /* Strategy:
 
    This garbage-collecting allocator allocates objects on one of a set
@@ -77,7 +92,33 @@ along with GCC; see the file COPYING3.  If not see
    Empty pages (of all orders) are kept on a single page cache list,
    and are considered first when new pages are required; they are
    deallocated at the start of the next collection if they haven't
-   been recycled by then.  */
+   been recycled by then.
+
+   With --param ggc-minor-collections=N, N minor collections are done
+   between two full ones.  Every object that survives a collection
+   joins the old generation, whose marks are not cleared by a minor
+   collection; marking therefore stops at old objects, and only the
+   objects allocated since the previous collection can be freed.  The
+   pages holding old objects are write-protected after each collection.
+   The first store to such a page unprotects it and flags it dirty, and
+   a minor collection starts by marking what the old objects on the
+   dirty pages point to, since they are the only old objects that can
+   point to new ones.  Some of these old objects are unreachable, and
+   the compiler does not keep unreachable objects consistent enough for
+   their marking routines to be run on them.  So the old objects on
+   dirty pages, and the new objects they lead to, are scanned
+   conservatively instead: every word pointing inside a new object
+   keeps it alive.
+
+   With --param ggc-threads=N, N threads mark the objects reachable from
+   the root tables, and then sweep the lists of pages of each order.
+   Each thread takes root table entries in turn, and the marking
+   routines push the objects they find on a stack private to the thread
+   (see ggc_mark_child) rather than recursing.  A thread whose stack
+   grows while others are idle moves the top of its stack to a shared
+   list of chunks, from which idle threads take their work.  In-use bits
+   are set atomically, and the free object counts recomputed at the end
+   of the marking.  */
 
 /* Define GGC_DEBUG_LEVEL to print debugging information.
      0: No debugging output.
@@ -277,6 +318,22 @@ typedef struct page_entry
   /* The lg of size of objects allocated from this page.  */
   unsigned char order;
 
+#ifdef GGC_GENERATIONAL
+  /* Nonzero if the page is write-protected.  */
+  unsigned char protected_p;
+
+  /* Nonzero if the page was written to since the last collection.  */
+  unsigned char dirty_p;
+
+  /* The number of objects in the old generation.  */
+  unsigned short num_old_objects;
+
+  /* A bit vector indicating whether or not objects belong to the old
+     generation.  This is in_use_p as of the end of the last
+     collection, or NULL if generational collection is not in use.  */
+  unsigned long *old_p;
+#endif
+
   /* A bit vector indicating whether or not objects are in use.  The
      Nth bit is one if the Nth object on this page is allocated.  This
      array is dynamically sized.  */
@@ -321,6 +378,34 @@ typedef struct page_table_chain
 
 #endif
 
+#ifdef GGC_PARALLEL
+/* An object to mark, and the routine marking it.  */
+struct mark_item
+{
+  void *object;
+  gt_pointer_walker walker;
+};
+
+/* The number of objects a thread moves from its mark stack to the
+   shared list at a time.  */
+#define MARK_CHUNK_SIZE 256
+
+/* Objects moved from a mark stack to the shared list.  */
+struct mark_chunk
+{
+  struct mark_chunk *next;
+  struct mark_item items[MARK_CHUNK_SIZE];
+};
+
+/* The mark stack of a thread.  */
+struct mark_stack
+{
+  struct mark_item *items;
+  size_t n;
+  size_t alloc;
+};
+#endif
+
 #ifdef ENABLE_GC_ALWAYS_COLLECT
 /* List of free objects to be verified as actually free on the
    next collection.  */
@@ -420,6 +505,99 @@ static struct globals
   struct free_object *free_object_list;
 #endif
 
+#ifdef GGC_GENERATIONAL
+  struct
+  {
+    /* True if objects are being recorded for generational collection.  */
+    bool active;
+
+    /* True if generational collection can no longer be used, because
+       a PCH file was read.  */
+    bool disabled;
+
+    /* True during a minor collection.  */
+    bool minor_p;
+
+    /* The number of minor collections to do before the next full
+       collection.  */
+    int minor_left;
+
+    /* The number of pages unprotected one by one since the last
+       collection.  */
+    unsigned long isolated_faults;
+
+    /* The most system pages covered by a protected page entry.  */
+    size_t max_entry_pages;
+
+    /* Bytes in the old generation after the last collection.  */
+    size_t old_bytes;
+
+    /* Statistics.  */
+    unsigned long minor_collections;
+    unsigned long full_collections;
+    unsigned long forced_full_collections;
+    unsigned long long minor_reclaimed;
+    unsigned long long full_reclaimed;
+    unsigned long write_faults;
+    unsigned long dirty_pages;
+    unsigned long rescanned_objects;
+    unsigned long kept_objects;
+
+    /* The new objects found by mark_dirty_pages, still to be scanned.  */
+    const char **scan_stack;
+    size_t scan_size;
+    size_t scan_alloc;
+  } gen;
+#endif
+
+#ifdef GGC_PARALLEL
+  struct
+  {
+    /* True once the fields below have been initialized.  */
+    bool initialized;
+
+    /* The number of threads taking part in the current phase.  */
+    int threads;
+
+    /* The stack size of the threads, or zero for the default.  */
+    size_t stack_size;
+
+    /* Protects SHARED, IDLE, DONE and THREADS.  */
+    pthread_mutex_t lock;
+
+    /* Signalled when work is shared, and when marking is over.  */
+    pthread_cond_t cond;
+
+    /* Work given away by busy threads.  */
+    struct mark_chunk *shared;
+
+    /* The number of threads waiting for work.  This is also read
+       without the lock, by threads deciding whether to share work.  */
+    volatile int idle;
+
+    /* True once every thread has run out of work.  */
+    bool done;
+
+    /* The mark stack of the current thread.  */
+    pthread_key_t stack_key;
+
+    /* The root table entries to mark, and the index of the next one.  */
+    const struct ggc_root_tab **roots;
+    size_t num_roots;
+    size_t next_root;
+
+    /* The next order to sweep, and for each order, the pages to free
+       and the bytes still allocated.  */
+    unsigned next_order;
+    page_entry **to_free;
+    size_t *allocated;
+
+    /* The number of collections whose marking was done by several
+       threads.  */
+    unsigned long markings;
+  } par;
+#endif
+
 #ifdef GATHER_STATISTICS
   struct
   {
@@ -490,11 +668,39 @@ static void sweep_pages (void);
 static void ggc_recalculate_in_use_p (page_entry *);
 static void compute_inverse (unsigned);
 static inline void adjust_depth (void);
-static void move_ptes_to_front (int, int);
+static void move_ptes_to_front (int, int, bool);
 
 void debug_print_page_list (int);
 static void push_depth (unsigned int);
 static void push_by_depth (page_entry *, unsigned long *);
+#ifdef GGC_GENERATIONAL
+static void alloc_old_p (page_entry *);
+static void free_old_p (page_entry *);
+static page_entry *lookup_protected_page (const void *);
+static bool unprotect_page (page_entry *);
+static inline void make_page_writable (page_entry *);
+static void protect_pages (page_entry **, size_t);
+static int compare_page_addresses (const void *, const void *);
+static void ggc_write_fault (int, siginfo_t *, void *);
+static void start_generational (void);
+static void stop_generational (void);
+static void choose_collection_kind (void);
+static void scan_conservatively (const char *, size_t);
+static bool minor_collection_possible_p (void);
+static void mark_dirty_pages (void);
+static void promote_survivors (void);
+#endif
+static void sweep_order (unsigned, page_entry **, size_t *);
+#ifdef GGC_PARALLEL
+static bool init_parallel (void);
+static void run_threads (void *(*) (void *), int);
+static void drain_mark_stack (struct mark_stack *);
+static void share_work (struct mark_stack *);
+static bool wait_for_work (struct mark_stack *);
+static void *mark_worker (void *);
+static void *sweep_worker (void *);
+static void recount_free_objects (void);
+#endif
 
 /* Push an entry onto G.depth.  */
 
@@ -593,6 +799,42 @@ lookup_page_table_entry (const void *p)
   return base[L1][L2];
 }
 
+#ifdef GGC_GENERATIONAL
+/* Traverse the page table and find the entry for a page.
+   Return NULL if the object wasn't allocated via GC.  */
+
+static inline page_entry *
+lookup_page_table_if_allocated (const void *p)
+{
+  page_entry ***base;
+  size_t L1, L2;
+
+#if HOST_BITS_PER_PTR <= 32
+  base = &G.lookup[0];
+#else
+  page_table table = G.lookup;
+  size_t high_bits = (size_t) p & ~ (size_t) 0xffffffff;
+  while (1)
+    {
+      if (table == NULL)
+	return NULL;
+      if (table->high_bits == high_bits)
+	break;
+      table = table->next;
+    }
+  base = &table->table[0];
+#endif
+
+  /* Extract the level 1 and 2 indices.  */
+  L1 = LOOKUP_L1 (p);
+  if (! base[L1])
+    return NULL;
+
+  L2 = LOOKUP_L2 (p);
+  return base[L1][L2];
+}
+#endif
+
 /* Set the page table entry for a page.  */
 
 static void
@@ -880,6 +1122,11 @@ alloc_page (unsigned order)
 
   set_page_table_entry (page, entry);
 
+#ifdef GGC_GENERATIONAL
+  if (G.gen.active)
+    alloc_old_p (entry);
+#endif
+
   if (GGC_DEBUG_LEVEL >= 2)
     fprintf (G.debug_file,
 	     "Allocating page at %p, object size=%lu, data %p-%p\n",
@@ -919,6 +1166,12 @@ free_page (page_entry *entry)
 	     "Deallocating page at %p, data %p-%p\n", (void *) entry,
 	     entry->page, entry->page + entry->bytes - 1);
 
+#ifdef GGC_GENERATIONAL
+  /* The page may be recycled for new objects.  */
+  make_page_writable (entry);
+  free_old_p (entry);
+#endif
+
   /* Mark the page as inaccessible.  Discard the handle to avoid handle
      leak.  */
   VALGRIND_DISCARD (VALGRIND_MAKE_MEM_NOACCESS (entry->page, entry->bytes));
@@ -1191,6 +1444,12 @@ ggc_internal_alloc_stat (size_t size MEM_STAT_DECL)
 		       result PASS_MEM_STAT);
 #endif
 
+#ifdef GGC_GENERATIONAL
+  /* The caller is about to initialize the object.  Doing this now is
+     cheaper than taking the fault.  */
+  make_page_writable (entry);
+#endif
+
 #ifdef ENABLE_GC_CHECKING
   /* Keep poisoning-by-writing-0xaf the object, in an attempt to keep the
      exact same semantics in presence of memory bugs, regardless of
@@ -1256,6 +1515,27 @@ ggc_internal_alloc_stat (size_t size MEM_STAT_DECL)
   return result;
 }
 
+/* Set MASK in the WORD'th word of the in-use bitmap of ENTRY, and
+   return nonzero if it was already set.  While several threads are
+   marking, the bit is set atomically and the free object count is left
+   for recount_free_objects to update.  */
+
+static inline int
+test_and_set_in_use (page_entry *entry, unsigned word, unsigned long mask)
+{
+  if (entry->in_use_p[word] & mask)
+    return 1;
+
+#ifdef GGC_PARALLEL
+  if (ggc_parallel_marking)
+    return (__sync_fetch_and_or (&entry->in_use_p[word], mask) & mask) != 0;
+#endif
+
+  entry->in_use_p[word] |= mask;
+  entry->num_free_objects -= 1;
+  return 0;
+}
+
 /* Mark function for strings.  */
 
 void
@@ -1293,14 +1573,11 @@ gt_ggc_m_S (const void *p)
   word = bit / HOST_BITS_PER_LONG;
   mask = (unsigned long) 1 << (bit % HOST_BITS_PER_LONG);
 
-  /* If the bit was previously set, skip it.  */
-  if (entry->in_use_p[word] & mask)
+  /* If the bit was previously set, skip it.  Otherwise set it, and
+     decrement the free object count.  */
+  if (test_and_set_in_use (entry, word, mask))
     return;
 
-  /* Otherwise set it, and decrement the free object count.  */
-  entry->in_use_p[word] |= mask;
-  entry->num_free_objects -= 1;
-
   if (GGC_DEBUG_LEVEL >= 4)
     fprintf (G.debug_file, "Marking %p\n", p);
 
@@ -1329,14 +1606,11 @@ ggc_set_mark (const void *p)
   word = bit / HOST_BITS_PER_LONG;
   mask = (unsigned long) 1 << (bit % HOST_BITS_PER_LONG);
 
-  /* If the bit was previously set, skip it.  */
-  if (entry->in_use_p[word] & mask)
+  /* If the bit was previously set, skip it.  Otherwise set it, and
+     decrement the free object count.  */
+  if (test_and_set_in_use (entry, word, mask))
     return 1;
 
-  /* Otherwise set it, and decrement the free object count.  */
-  entry->in_use_p[word] |= mask;
-  entry->num_free_objects -= 1;
-
   if (GGC_DEBUG_LEVEL >= 4)
     fprintf (G.debug_file, "Marking %p\n", p);
 
@@ -1395,6 +1669,11 @@ ggc_free (void *p)
 	     "Freeing object, actual size=%lu, at %p on %p\n",
 	     (unsigned long) size, p, (void *) pe);
 
+#ifdef GGC_GENERATIONAL
+  /* The object is about to be poisoned or reused.  */
+  make_page_writable (pe);
+#endif
+
 #ifdef ENABLE_GC_CHECKING
   /* Poison the data, to indicate the data is garbage.  */
   VALGRIND_DISCARD (VALGRIND_MAKE_MEM_UNDEFINED (p, size));
@@ -1425,6 +1704,16 @@ ggc_free (void *p)
     bit = bit_offset % HOST_BITS_PER_LONG;
     pe->in_use_p[word] &= ~(1UL << bit);
 
+#ifdef GGC_GENERATIONAL
+    /* A new object allocated in its place must not be mistaken for an
+       old one.  */
+    if (pe->old_p && (pe->old_p[word] & (1UL << bit)))
+      {
+	pe->old_p[word] &= ~(1UL << bit);
+	pe->num_old_objects--;
+      }
+#endif
+
     if (pe->num_free_objects++ == 0)
       {
 	page_entry *p, *q;
@@ -1656,150 +1945,495 @@ clear_marks (void)
 	      memcpy (save_in_use_p (p), p->in_use_p, bitmap_size);
 	    }
 
-	  /* Reset reset the number of free objects and clear the
-             in-use bits.  These will be adjusted by mark_obj.  */
-	  p->num_free_objects = num_objects;
-	  memset (p->in_use_p, 0, bitmap_size);
+#ifdef GGC_GENERATIONAL
+	  /* A minor collection starts with the old generation marked.  */
+	  if (G.gen.minor_p)
+	    {
+	      p->num_free_objects = num_objects - p->num_old_objects;
+	      memcpy (p->in_use_p, p->old_p, bitmap_size);
+	    }
+	  else
+#endif
+	    {
+	      /* Reset reset the number of free objects and clear the
+		 in-use bits.  These will be adjusted by mark_obj.  */
+	      p->num_free_objects = num_objects;
+	      memset (p->in_use_p, 0, bitmap_size);
+	    }
 
 	  /* Make sure the one-past-the-end bit is always set.  */
 	  p->in_use_p[num_objects / HOST_BITS_PER_LONG]
-	    = ((unsigned long) 1 << (num_objects % HOST_BITS_PER_LONG));
+	    |= ((unsigned long) 1 << (num_objects % HOST_BITS_PER_LONG));
 	}
     }
 }
 
-/* Free all empty pages.  Partially empty pages need no attention
-   because the `mark' bit doubles as an `unused' bit.  */
+/* Sweep the pages of ORDER.  Add the bytes still allocated on them to
+   *ALLOCATED, and chain the empty pages on *TO_FREE.  Partially empty
+   pages need no attention because the `mark' bit doubles as an `unused'
+   bit.  */
 
 static void
-sweep_pages (void)
+sweep_order (unsigned order, page_entry **to_free, size_t *allocated)
 {
-  unsigned order;
+  /* The last page-entry to consider, regardless of entries
+     placed at the end of the list.  */
+  page_entry * const last = G.page_tails[order];
 
-  for (order = 2; order < NUM_ORDERS; order++)
-    {
-      /* The last page-entry to consider, regardless of entries
-	 placed at the end of the list.  */
-      page_entry * const last = G.page_tails[order];
+  size_t num_objects;
+  size_t live_objects;
+  page_entry *p, *previous;
+  int done;
 
-      size_t num_objects;
-      size_t live_objects;
-      page_entry *p, *previous;
-      int done;
+  *to_free = NULL;
+  *allocated = 0;
 
-      p = G.pages[order];
-      if (p == NULL)
-	continue;
+  p = G.pages[order];
+  if (p == NULL)
+    return;
 
-      previous = NULL;
-      do
-	{
-	  page_entry *next = p->next;
+  previous = NULL;
+  do
+    {
+      page_entry *next = p->next;
 
-	  /* Loop until all entries have been examined.  */
-	  done = (p == last);
+      /* Loop until all entries have been examined.  */
+      done = (p == last);
 
-	  num_objects = OBJECTS_IN_PAGE (p);
+      num_objects = OBJECTS_IN_PAGE (p);
 
-	  /* Add all live objects on this page to the count of
-             allocated memory.  */
-	  live_objects = num_objects - p->num_free_objects;
+      /* Add all live objects on this page to the count of
+	 allocated memory.  */
+      live_objects = num_objects - p->num_free_objects;
 
-	  G.allocated += OBJECT_SIZE (order) * live_objects;
+      *allocated += OBJECT_SIZE (order) * live_objects;
 
-	  /* Only objects on pages in the topmost context should get
-	     collected.  */
-	  if (p->context_depth < G.context_depth)
-	    ;
+      /* Only objects on pages in the topmost context should get
+	 collected.  */
+      if (p->context_depth < G.context_depth)
+	;
 
-	  /* Remove the page if it's empty.  */
-	  else if (live_objects == 0)
+      /* Remove the page if it's empty.  */
+      else if (live_objects == 0)
+	{
+	  /* If P was the first page in the list, then NEXT
+	     becomes the new first page in the list, otherwise
+	     splice P out of the forward pointers.  */
+	  if (! previous)
+	    G.pages[order] = next;
+	  else
+	    previous->next = next;
+
+	  /* Splice P out of the back pointers too.  */
+	  if (next)
+	    next->prev = previous;
+
+	  /* Are we removing the last element?  */
+	  if (p == G.page_tails[order])
+	    G.page_tails[order] = previous;
+	  p->next = *to_free;
+	  *to_free = p;
+	  p = previous;
+	}
+
+      /* If the page is full, move it to the end.  */
+      else if (p->num_free_objects == 0)
+	{
+	  /* Don't move it if it's already at the end.  */
+	  if (p != G.page_tails[order])
 	    {
-	      /* If P was the first page in the list, then NEXT
-		 becomes the new first page in the list, otherwise
-		 splice P out of the forward pointers.  */
+	      /* Move p to the end of the list.  */
+	      p->next = NULL;
+	      p->prev = G.page_tails[order];
+	      G.page_tails[order]->next = p;
+
+	      /* Update the tail pointer...  */
+	      G.page_tails[order] = p;
+
+	      /* ... and the head pointer, if necessary.  */
 	      if (! previous)
 		G.pages[order] = next;
 	      else
 		previous->next = next;
 
-	      /* Splice P out of the back pointers too.  */
+	      /* And update the backpointer in NEXT if necessary.  */
 	      if (next)
 		next->prev = previous;
 
-	      /* Are we removing the last element?  */
-	      if (p == G.page_tails[order])
-		G.page_tails[order] = previous;
-	      free_page (p);
 	      p = previous;
 	    }
+	}
 
-	  /* If the page is full, move it to the end.  */
-	  else if (p->num_free_objects == 0)
-	    {
-	      /* Don't move it if it's already at the end.  */
-	      if (p != G.page_tails[order])
-		{
-		  /* Move p to the end of the list.  */
-		  p->next = NULL;
-		  p->prev = G.page_tails[order];
-		  G.page_tails[order]->next = p;
+      /* If we've fallen through to here, it's a page in the
+	 topmost context that is neither full nor empty.  Such a
+	 page must precede pages at lesser context depth in the
+	 list, so move it to the head.  */
+      else if (p != G.pages[order])
+	{
+	  previous->next = p->next;
 
-		  /* Update the tail pointer...  */
-		  G.page_tails[order] = p;
+	  /* Update the backchain in the next node if it exists.  */
+	  if (p->next)
+	    p->next->prev = previous;
 
-		  /* ... and the head pointer, if necessary.  */
-		  if (! previous)
-		    G.pages[order] = next;
-		  else
-		    previous->next = next;
+	  /* Move P to the head of the list.  */
+	  p->next = G.pages[order];
+	  p->prev = NULL;
+	  G.pages[order]->prev = p;
 
-		  /* And update the backpointer in NEXT if necessary.  */
-		  if (next)
-		    next->prev = previous;
+	  /* Update the head pointer.  */
+	  G.pages[order] = p;
 
-		  p = previous;
-		}
-	    }
+	  /* Are we moving the last element?  */
+	  if (G.page_tails[order] == p)
+	    G.page_tails[order] = previous;
+	  p = previous;
+	}
 
-	  /* If we've fallen through to here, it's a page in the
-	     topmost context that is neither full nor empty.  Such a
-	     page must precede pages at lesser context depth in the
-	     list, so move it to the head.  */
-	  else if (p != G.pages[order])
-	    {
-	      previous->next = p->next;
+      previous = p;
+      p = next;
+    }
+  while (! done);
 
-	      /* Update the backchain in the next node if it exists.  */
-	      if (p->next)
-		p->next->prev = previous;
+  /* Now, restore the in_use_p vectors for any pages from contexts
+     other than the current one.  */
+  for (p = G.pages[order]; p; p = p->next)
+    if (p->context_depth != G.context_depth)
+      ggc_recalculate_in_use_p (p);
+}
 
-	      /* Move P to the head of the list.  */
-	      p->next = G.pages[order];
-	      p->prev = NULL;
-	      G.pages[order]->prev = p;
+/* Free all empty pages.  */
 
-	      /* Update the head pointer.  */
-	      G.pages[order] = p;
+static void
+sweep_pages (void)
+{
+  page_entry *to_free[NUM_ORDERS];
+  size_t allocated[NUM_ORDERS];
+  unsigned order;
 
-	      /* Are we moving the last element?  */
-	      if (G.page_tails[order] == p)
-	        G.page_tails[order] = previous;
-	      p = previous;
-	    }
+#ifdef GGC_PARALLEL
+  if (PARAM_VALUE (GGC_THREADS) > 1 && init_parallel ())
+    {
+      G.par.next_order = 2;
+      G.par.to_free = to_free;
+      G.par.allocated = allocated;
+      run_threads (sweep_worker, PARAM_VALUE (GGC_THREADS));
+    }
+  else
+#endif
+    for (order = 2; order < NUM_ORDERS; order++)
+      sweep_order (order, &to_free[order], &allocated[order]);
 
-	  previous = p;
-	  p = next;
+  /* Freeing pages updates data structures shared by all orders.  */
+  for (order = 2; order < NUM_ORDERS; order++)
+    {
+      page_entry *p, *next;
+
+      G.allocated += allocated[order];
+      for (p = to_free[order]; p; p = next)
+	{
+	  next = p->next;
+	  free_page (p);
 	}
-      while (! done);
+    }
+}
 
-      /* Now, restore the in_use_p vectors for any pages from contexts
-         other than the current one.  */
-      for (p = G.pages[order]; p; p = p->next)
-	if (p->context_depth != G.context_depth)
-	  ggc_recalculate_in_use_p (p);
+#ifdef GGC_PARALLEL
+/* Prepare for running the collector in several threads.  Return false
+   if threads cannot be used.  */
+
+static bool
+init_parallel (void)
+{
+  if (! G.par.initialized)
+    {
+#if defined (HAVE_GETRLIMIT) && defined (RLIMIT_STACK)
+      struct rlimit rlim;
+#endif
+
+      if (pthread_key_create (&G.par.stack_key, NULL) != 0)
+	return false;
+      pthread_mutex_init (&G.par.lock, NULL);
+      pthread_cond_init (&G.par.cond, NULL);
+
+      /* Marking routines written by hand may still recurse deeply, so
+	 give the threads as much stack as the main thread has.  */
+#if defined (HAVE_GETRLIMIT) && defined (RLIMIT_STACK)
+      if (getrlimit (RLIMIT_STACK, &rlim) == 0
+	  && rlim.rlim_cur != (rlim_t) RLIM_INFINITY)
+	G.par.stack_size = rlim.rlim_cur;
+#endif
+      G.par.initialized = true;
     }
+
+  return true;
+}
+
+/* Run FN in N threads, one of them being the current thread, and wait
+   for all of them to return.  If fewer threads can be created, run FN
+   in as many as possible.  */
+
+static void
+run_threads (void *(*fn) (void *), int n)
+{
+  pthread_t *ids = XALLOCAVEC (pthread_t, n - 1);
+  pthread_attr_t attr;
+  int i, started;
+
+  G.par.threads = n;
+
+  pthread_attr_init (&attr);
+  if (G.par.stack_size)
+    pthread_attr_setstacksize (&attr, G.par.stack_size);
+  for (started = 0; started < n - 1; started++)
+    if (pthread_create (&ids[started], &attr, fn, NULL) != 0)
+      break;
+  pthread_attr_destroy (&attr);
+
+  /* Threads waiting for work may be waiting for the ones that could not
+     be created.  */
+  if (started < n - 1)
+    {
+      pthread_mutex_lock (&G.par.lock);
+      G.par.threads = started + 1;
+      pthread_cond_broadcast (&G.par.cond);
+      pthread_mutex_unlock (&G.par.lock);
+    }
+
+  fn (NULL);
+
+  for (i = 0; i < started; i++)
+    pthread_join (ids[i], NULL);
+}
+
+/* Push P, to be marked by WALKER, on the mark stack of the current
+   thread.  */
+
+void
+ggc_push_mark (void *p, gt_pointer_walker walker)
+{
+  struct mark_stack *stack
+    = (struct mark_stack *) pthread_getspecific (G.par.stack_key);
+
+  if (stack->n == stack->alloc)
+    {
+      stack->alloc = stack->alloc ? stack->alloc * 2 : 4 * MARK_CHUNK_SIZE;
+      stack->items = XRESIZEVEC (struct mark_item, stack->items,
+				 stack->alloc);
+    }
+  stack->items[stack->n].object = p;
+  stack->items[stack->n].walker = walker;
+  stack->n++;
+
+  /* Give some work away if another thread is out of it.  */
+  if (stack->n >= 2 * MARK_CHUNK_SIZE && G.par.idle > 0)
+    share_work (stack);
+}
+
+/* Mark the objects on STACK, and everything reachable from them.  */
+
+static void
+drain_mark_stack (struct mark_stack *stack)
+{
+  while (stack->n > 0)
+    {
+      struct mark_item *item = &stack->items[--stack->n];
+      (*item->walker) (item->object);
+    }
+}
+
+/* Move the topmost MARK_CHUNK_SIZE objects of STACK to the shared list,
+   and wake up a thread waiting for them.  */
+
+static void
+share_work (struct mark_stack *stack)
+{
+  struct mark_chunk *chunk = XNEW (struct mark_chunk);
+
+  stack->n -= MARK_CHUNK_SIZE;
+  memcpy (chunk->items, stack->items + stack->n, sizeof (chunk->items));
+
+  pthread_mutex_lock (&G.par.lock);
+  chunk->next = G.par.shared;
+  G.par.shared = chunk;
+  pthread_cond_signal (&G.par.cond);
+  pthread_mutex_unlock (&G.par.lock);
+}
+
+/* Wait until another thread shares some work, and move it to STACK.
+   Return false if every thread is out of work instead, meaning marking
+   is over.  */
+
+static bool
+wait_for_work (struct mark_stack *stack)
+{
+  struct mark_chunk *chunk;
+
+  pthread_mutex_lock (&G.par.lock);
+  G.par.idle++;
+  while (G.par.shared == NULL && ! G.par.done)
+    {
+      if (G.par.idle == G.par.threads)
+	{
+	  G.par.done = true;
+	  pthread_cond_broadcast (&G.par.cond);
+	}
+      else
+	pthread_cond_wait (&G.par.cond, &G.par.lock);
+    }
+
+  chunk = G.par.shared;
+  if (chunk == NULL)
+    {
+      pthread_mutex_unlock (&G.par.lock);
+      return false;
+    }
+  G.par.shared = chunk->next;
+  G.par.idle--;
+  pthread_mutex_unlock (&G.par.lock);
+
+  if (stack->alloc < stack->n + MARK_CHUNK_SIZE)
+    {
+      stack->alloc = stack->n + 4 * MARK_CHUNK_SIZE;
+      stack->items = XRESIZEVEC (struct mark_item, stack->items,
+				 stack->alloc);
+    }
+  memcpy (stack->items + stack->n, chunk->items, sizeof (chunk->items));
+  stack->n += MARK_CHUNK_SIZE;
+  free (chunk);
+  return true;
+}
+
+/* The body of a marking thread.  Mark the root table entries not yet
+   claimed by another thread, then help the others until nothing is
+   left to mark.  */
+
+static void *
+mark_worker (void *data ATTRIBUTE_UNUSED)
+{
+  struct mark_stack stack;
+  size_t r, i;
+
+  memset (&stack, 0, sizeof (stack));
+  pthread_setspecific (G.par.stack_key, &stack);
+
+  while ((r = __sync_fetch_and_add (&G.par.next_root, 1)) < G.par.num_roots)
+    {
+      const struct ggc_root_tab *rt = G.par.roots[r];
+
+      for (i = 0; i < rt->nelt; i++)
+	{
+	  (*rt->cb) (*(void **) ((char *) rt->base + rt->stride * i));
+	  drain_mark_stack (&stack);
+	}
+    }
+
+  do
+    drain_mark_stack (&stack);
+  while (wait_for_work (&stack));
+
+  pthread_setspecific (G.par.stack_key, NULL);
+  free (stack.items);
+  return NULL;
+}
+
+/* The body of a sweeping thread.  Sweep the orders not yet claimed by
+   another thread.  */
+
+static void *
+sweep_worker (void *data ATTRIBUTE_UNUSED)
+{
+  unsigned order;
+
+  while ((order = __sync_fetch_and_add (&G.par.next_order, 1)) < NUM_ORDERS)
+    sweep_order (order, &G.par.to_free[order], &G.par.allocated[order]);
+  return NULL;
+}
+
+/* Recompute the free object count of every page from its in-use
+   bitmap, since parallel marking does not maintain it.  */
+
+static void
+recount_free_objects (void)
+{
+  unsigned order;
+  page_entry *p;
+
+  for (order = 2; order < NUM_ORDERS; order++)
+    for (p = G.pages[order]; p; p = p->next)
+      {
+	/* Because the past-the-end bit in in_use_p is always set, we
+	   pretend there is one additional object.  */
+	size_t num_objects = OBJECTS_IN_PAGE (p) + 1;
+	size_t i, live = 0;
+
+	/* Hosts with the __sync builtins have this one too.  */
+	for (i = 0; i < CEIL (BITMAP_SIZE (num_objects),
+			      sizeof (*p->in_use_p)); i++)
+	  live += __builtin_popcountl (p->in_use_p[i]);
+
+	p->num_free_objects = num_objects - live;
+      }
+}
+
+/* Mark the roots in RTAB, using the threads requested by the ggc-threads
+   parameter.  Return false if the roots should be marked serially
+   instead.  */
+
+bool
+ggc_mark_roots_parallel (const struct ggc_root_tab *const *rtab)
+{
+  const struct ggc_root_tab *const *rt;
+  const struct ggc_root_tab *rti;
+  size_t n;
+
+  if (PARAM_VALUE (GGC_THREADS) <= 1 || ! init_parallel ())
+    return false;
+
+  n = 0;
+  for (rt = rtab; *rt; rt++)
+    for (rti = *rt; rti->base != NULL; rti++)
+      n++;
+  G.par.roots = XNEWVEC (const struct ggc_root_tab *, n);
+  n = 0;
+  for (rt = rtab; *rt; rt++)
+    for (rti = *rt; rti->base != NULL; rti++)
+      G.par.roots[n++] = rti;
+  G.par.num_roots = n;
+  G.par.next_root = 0;
+  G.par.shared = NULL;
+  G.par.idle = 0;
+  G.par.done = false;
+
+  ggc_parallel_marking = true;
+  run_threads (mark_worker, PARAM_VALUE (GGC_THREADS));
+  ggc_parallel_marking = false;
+  G.par.markings++;
+
+  free (G.par.roots);
+  G.par.roots = NULL;
+  recount_free_objects ();
+  return true;
+}
+#else
+/* This host cannot mark in parallel.  */
+
+bool
+ggc_mark_roots_parallel (const struct ggc_root_tab *const *rtab
+			 ATTRIBUTE_UNUSED)
+{
+  return false;
+}
+
+/* Likewise, so nothing is ever pushed on a mark stack.  */
+
+void
+ggc_push_mark (void *p ATTRIBUTE_UNUSED,
+	       gt_pointer_walker walker ATTRIBUTE_UNUSED)
+{
+  gcc_unreachable ();
 }
+#endif /* GGC_PARALLEL */
 
 #ifdef ENABLE_GC_CHECKING
 /* Clobber all free objects.  */
@@ -1826,6 +2460,13 @@ poison_pages (void)
 	       contexts.  */
 	    continue;
 
+#ifdef GGC_GENERATIONAL
+	  /* The free objects on a page that was not written to since the
+	     last collection have been poisoned already.  */
+	  if (G.gen.minor_p && p->protected_p)
+	    continue;
+#endif
+
 	  num_objects = OBJECTS_IN_PAGE (p);
 	  for (i = 0; i < num_objects; i++)
 	    {
@@ -1842,6 +2483,9 @@ poison_pages (void)
 		     below.  */
 		  VALGRIND_DISCARD (VALGRIND_MAKE_MEM_UNDEFINED (object,
 								 size));
+#ifdef GGC_GENERATIONAL
+		  make_page_writable (p);
+#endif
 		  memset (object, 0xa5, size);
 
 		  /* Drop the handle to avoid handle leak.  */
@@ -1895,6 +2539,426 @@ validate_free_objects (void)
 #define validate_free_objects()
 #endif
 
+#ifdef GGC_GENERATIONAL
+/* The number of pages that may be unprotected one at a time between two
+   collections.  Each of them can split a mapping in two, and the kernel
+   limits the number of mappings of a process; past this, whole runs of
+   protected pages are unprotected together instead.  */
+#define MAX_ISOLATED_FAULTS 8192
+
+/* The signal actions that were in place before generational collection
+   started.  */
+static struct sigaction old_segv_action;
+#ifdef SIGBUS
+static struct sigaction old_bus_action;
+#endif
+
+/* Allocate the OLD_P vector of ENTRY.  */
+
+static void
+alloc_old_p (page_entry *entry)
+{
+  entry->old_p = XCNEWVEC (unsigned long,
+			   CEIL (BITMAP_SIZE (OBJECTS_IN_PAGE (entry) + 1),
+				 sizeof (unsigned long)));
+  entry->num_old_objects = 0;
+  entry->dirty_p = 0;
+}
+
+/* Release the vector allocated by alloc_old_p for ENTRY.  */
+
+static void
+free_old_p (page_entry *entry)
+{
+  free (entry->old_p);
+  entry->old_p = NULL;
+  entry->num_old_objects = 0;
+  entry->dirty_p = 0;
+}
+
+/* Return the write-protected page entry whose memory contains P, or
+   NULL if there is none.  This is called from a signal handler.  */
+
+static page_entry *
+lookup_protected_page (const void *p)
+{
+  const char *page = (const char *) ((size_t) p & ~(G.pagesize - 1));
+  size_t i;
+
+  /* Only the first page of an entry is in the page table.  */
+  for (i = 0; i < G.gen.max_entry_pages; i++, page -= G.pagesize)
+    {
+      page_entry *entry = lookup_page_table_if_allocated (page);
+
+      if (entry != NULL)
+	{
+	  if (entry->protected_p
+	      && (const char *) p < entry->page + entry->bytes)
+	    return entry;
+	  return NULL;
+	}
+    }
+
+  return NULL;
+}
+
+/* Make ENTRY, which is write-protected, writable again and flag it as
+   dirty.  Return false if this cannot be done.  */
+
+static bool
+unprotect_page (page_entry *entry)
+{
+  page_entry *p;
+  char *start, *end, *page;
+
+  if (G.gen.isolated_faults < MAX_ISOLATED_FAULTS
+      && mprotect (entry->page, entry->bytes, PROT_READ | PROT_WRITE) == 0)
+    {
+      G.gen.isolated_faults++;
+      entry->protected_p = 0;
+      entry->dirty_p = 1;
+      return true;
+    }
+
+  /* Unprotect the whole run of protected pages around ENTRY.  This
+     merges mappings rather than splitting them.  */
+  start = entry->page;
+  while ((p = lookup_protected_page (start - 1)) != NULL)
+    start = p->page;
+  end = entry->page + entry->bytes;
+  while ((p = lookup_protected_page (end)) != NULL)
+    end = p->page + p->bytes;
+
+  if (mprotect (start, end - start, PROT_READ | PROT_WRITE) != 0)
+    return false;
+
+  for (page = start; page < end; page = p->page + p->bytes)
+    {
+      p = lookup_protected_page (page);
+      p->protected_p = 0;
+      p->dirty_p = 1;
+    }
+
+  return true;
+}
+
+/* Make ENTRY writable, if it is write-protected.  */
+
+static inline void
+make_page_writable (page_entry *entry)
+{
+  if (entry->protected_p && ! unprotect_page (entry))
+    {
+      perror ("mprotect");
+      exit (FATAL_EXIT_CODE);
+    }
+}
+
+/* Write-protect the N page entries starting at ENTRIES, which hold old
+   objects and are contiguous in memory.  If this fails, they are
+   considered dirty until the next collection.  */
+
+static void
+protect_pages (page_entry **entries, size_t n)
+{
+  char *start = entries[0]->page;
+  char *end = entries[n - 1]->page + entries[n - 1]->bytes;
+  bool ok = mprotect (start, end - start, PROT_READ) == 0;
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      page_entry *entry = entries[i];
+      size_t pages = entry->bytes >> G.lg_pagesize;
+
+      entry->protected_p = ok;
+      entry->dirty_p = !ok;
+      if (ok && pages > G.gen.max_entry_pages)
+	G.gen.max_entry_pages = pages;
+    }
+}
+
+/* Compare the addresses of the page entries pointed to by PA and PB,
+   for qsort.  */
+
+static int
+compare_page_addresses (const void *pa, const void *pb)
+{
+  const page_entry *const a = *(const page_entry *const *) pa;
+  const page_entry *const b = *(const page_entry *const *) pb;
+
+  if (a->page != b->page)
+    return a->page < b->page ? -1 : 1;
+  return 0;
+}
+
+/* Handler for SIGSEGV and SIGBUS.  A write to a protected page makes
+   the page writable and dirty; other faults are passed on to the
+   handler that was in place before.  */
+
+static void
+ggc_write_fault (int sig, siginfo_t *info, void *context)
+{
+  struct sigaction *old = &old_segv_action;
+  page_entry *entry = lookup_protected_page (info->si_addr);
+
+  if (entry != NULL && unprotect_page (entry))
+    {
+      G.gen.write_faults++;
+      return;
+    }
+
+#ifdef SIGBUS
+  if (sig == SIGBUS)
+    old = &old_bus_action;
+#endif
+  if (old->sa_flags & SA_SIGINFO)
+    (*old->sa_sigaction) (sig, info, context);
+  else if (old->sa_handler != SIG_DFL && old->sa_handler != SIG_IGN)
+    (*old->sa_handler) (sig);
+  else
+    /* Fault again, and let the default action happen.  */
+    signal (sig, SIG_DFL);
+}
+
+/* Start recording what the next collections need to know to collect
+   only the objects allocated since the collection before them.  */
+
+static void
+start_generational (void)
+{
+  struct sigaction sa;
+  unsigned order;
+  page_entry *p;
+
+  for (order = 2; order < NUM_ORDERS; order++)
+    for (p = G.pages[order]; p != NULL; p = p->next)
+      alloc_old_p (p);
+
+  memset (&sa, 0, sizeof (sa));
+  sa.sa_sigaction = ggc_write_fault;
+  sa.sa_flags = SA_SIGINFO;
+  sigemptyset (&sa.sa_mask);
+  sigaction (SIGSEGV, &sa, &old_segv_action);
+#ifdef SIGBUS
+  sigaction (SIGBUS, &sa, &old_bus_action);
+#endif
+
+  G.gen.active = true;
+}
+
+/* Stop generational collection, making every page writable.  */
+
+static void
+stop_generational (void)
+{
+  unsigned order;
+  page_entry *p;
+
+  for (order = 2; order < NUM_ORDERS; order++)
+    for (p = G.pages[order]; p != NULL; p = p->next)
+      {
+	make_page_writable (p);
+	free_old_p (p);
+      }
+
+  sigaction (SIGSEGV, &old_segv_action, NULL);
+#ifdef SIGBUS
+  sigaction (SIGBUS, &old_bus_action, NULL);
+#endif
+
+  G.gen.active = false;
+}
+
+/* Decide whether the collection that is starting is a minor one.  The
+   first collection after generational collection was requested starts
+   it, and is a full one.  */
+
+static void
+choose_collection_kind (void)
+{
+  if (! G.gen.active)
+    {
+      if (G.gen.disabled
+	  || G.context_depth != 0
+	  || PARAM_VALUE (GGC_MINOR_COLLECTIONS) == 0)
+	return;
+      start_generational ();
+    }
+  else if (G.gen.minor_left > 0)
+    {
+      if (! ggc_force_collect && minor_collection_possible_p ())
+	{
+	  G.gen.minor_p = true;
+	  G.gen.minor_left--;
+	  G.gen.minor_collections++;
+	  return;
+	}
+      G.gen.forced_full_collections++;
+    }
+
+  G.gen.minor_left = PARAM_VALUE (GGC_MINOR_COLLECTIONS);
+  G.gen.full_collections++;
+}
+
+/* Return true if a minor collection can be done now, that is if
+   scanning the dirty pages is cheaper than a full collection.  */
+
+static bool
+minor_collection_possible_p (void)
+{
+  unsigned order;
+  page_entry *p;
+  size_t old_pages = 0, dirty_pages = 0;
+
+  if (G.context_depth != 0)
+    return false;
+
+#ifdef ENABLE_GC_ALWAYS_COLLECT
+  /* The objects on the free object list must not be marked.  */
+  if (G.free_object_list != NULL)
+    return false;
+#endif
+
+  for (order = 2; order < NUM_ORDERS; order++)
+    for (p = G.pages[order]; p != NULL; p = p->next)
+      if (p->num_old_objects != 0)
+	{
+	  old_pages++;
+	  dirty_pages += p->dirty_p;
+	}
+
+  return dirty_pages * 2 <= old_pages;
+}
+
+/* Mark every new object that a word of the SIZE bytes at START points
+   inside of, and push it on G.gen.scan_stack.  */
+
+static void
+scan_conservatively (const char *start, size_t size)
+{
+  const char *const *word = (const char *const *) start;
+  const char *const *end = (const char *const *) (start + size);
+
+  for (; word < end; word++)
+    {
+      const char *q = *word;
+      page_entry *entry;
+      size_t bit;
+      unsigned long mask;
+
+      if (q == NULL
+	  || (entry = lookup_page_table_if_allocated (q)) == NULL
+	  || q < entry->page
+	  || entry->old_p == NULL)
+	continue;
+
+      /* Old objects are marked already.  Objects marked now need not be
+	 scanned again.  The past-the-end bit is not an object.  */
+      bit = OFFSET_TO_BIT (q - entry->page, entry->order);
+      mask = (unsigned long) 1 << (bit % HOST_BITS_PER_LONG);
+      if (bit >= OBJECTS_IN_PAGE (entry)
+	  || (entry->in_use_p[bit / HOST_BITS_PER_LONG] & mask))
+	continue;
+
+      entry->in_use_p[bit / HOST_BITS_PER_LONG] |= mask;
+      entry->num_free_objects--;
+      G.gen.kept_objects++;
+
+      if (G.gen.scan_size == G.gen.scan_alloc)
+	{
+	  G.gen.scan_alloc = G.gen.scan_alloc ? G.gen.scan_alloc * 2 : 256;
+	  G.gen.scan_stack = XRESIZEVEC (const char *, G.gen.scan_stack,
+					 G.gen.scan_alloc);
+	}
+      G.gen.scan_stack[G.gen.scan_size++]
+	= entry->page + bit * OBJECT_SIZE (entry->order);
+    }
+}
+
+/* Mark the objects that the old objects on dirty pages point to.  These
+   are the only old objects that can point to new objects.  Both kinds
+   of objects are scanned conservatively: the old ones may be
+   unreachable, and nothing is known about the unreachable objects of
+   the compiler, not even whether their marking routine can be run on
+   them.  */
+
+static void
+mark_dirty_pages (void)
+{
+  unsigned order;
+  page_entry *p;
+
+  for (order = 2; order < NUM_ORDERS; order++)
+    for (p = G.pages[order]; p != NULL; p = p->next)
+      if (p->dirty_p && p->num_old_objects != 0)
+	{
+	  size_t num_objects = OBJECTS_IN_PAGE (p);
+	  size_t i;
+
+	  G.gen.dirty_pages++;
+	  for (i = 0; i < num_objects; i++)
+	    if ((p->old_p[i / HOST_BITS_PER_LONG]
+		 >> (i % HOST_BITS_PER_LONG)) & 1)
+	      {
+		G.gen.rescanned_objects++;
+		scan_conservatively (p->page + i * OBJECT_SIZE (order),
+				     OBJECT_SIZE (order));
+		while (G.gen.scan_size > 0)
+		  {
+		    const char *q = G.gen.scan_stack[--G.gen.scan_size];
+		    page_entry *entry = lookup_page_table_entry (q);
+		    scan_conservatively (q, OBJECT_SIZE (entry->order));
+		  }
+	      }
+	}
+}
+
+/* Make every object that survived the collection an old object, and
+   write-protect the pages holding old objects.  */
+
+static void
+promote_survivors (void)
+{
+  unsigned order;
+  page_entry *p, **to_protect;
+  size_t i, j, n = 0;
+
+  G.gen.isolated_faults = 0;
+  G.gen.old_bytes = 0;
+  to_protect = XNEWVEC (page_entry *, G.by_depth_in_use);
+
+  for (order = 2; order < NUM_ORDERS; order++)
+    for (p = G.pages[order]; p != NULL; p = p->next)
+      {
+	size_t num_objects = OBJECTS_IN_PAGE (p);
+
+	memcpy (p->old_p, p->in_use_p, BITMAP_SIZE (num_objects + 1));
+	p->num_old_objects = num_objects - p->num_free_objects;
+	G.gen.old_bytes += p->num_old_objects * OBJECT_SIZE (order);
+
+	if (p->num_old_objects == 0)
+	  p->dirty_p = 0;
+	else if (! p->protected_p)
+	  to_protect[n++] = p;
+      }
+
+  /* Protect adjacent pages with a single system call.  */
+  qsort (to_protect, n, sizeof (page_entry *), compare_page_addresses);
+  for (i = 0; i < n; i = j)
+    {
+      char *end = to_protect[i]->page + to_protect[i]->bytes;
+
+      for (j = i + 1; j < n && to_protect[j]->page == end; j++)
+	end += to_protect[j]->bytes;
+      protect_pages (to_protect + i, j - i);
+    }
+
+  free (to_protect);
+}
+
+#endif /* GGC_GENERATIONAL */
+
 /* Top level mark-and-sweep routine.  */
 
 void
@@ -1907,6 +2971,9 @@ ggc_collect (void)
     MAX (G.allocated_last_gc, (size_t)PARAM_VALUE (GGC_MIN_HEAPSIZE) * 1024);
 
   float min_expand = allocated_last_gc * PARAM_VALUE (GGC_MIN_EXPAND) / 100;
+#ifdef GGC_GENERATIONAL
+  size_t allocated_before = G.allocated;
+#endif
 
   if (G.allocated < allocated_last_gc + min_expand && !ggc_force_collect)
     return;
@@ -1930,7 +2997,15 @@ ggc_collect (void)
 
   invoke_plugin_callbacks (PLUGIN_GGC_START, NULL);
 
+#ifdef GGC_GENERATIONAL
+  choose_collection_kind ();
+#endif
+
   clear_marks ();
+#ifdef GGC_GENERATIONAL
+  if (G.gen.minor_p)
+    mark_dirty_pages ();
+#endif
   ggc_mark_roots ();
 #ifdef GATHER_STATISTICS
   ggc_prune_overhead_list ();
@@ -1939,6 +3014,20 @@ ggc_collect (void)
   validate_free_objects ();
   sweep_pages ();
 
+#ifdef GGC_GENERATIONAL
+  if (G.gen.active)
+    {
+      size_t reclaimed = (allocated_before > G.allocated
+			  ? allocated_before - G.allocated : 0);
+      if (G.gen.minor_p)
+	G.gen.minor_reclaimed += reclaimed;
+      else
+	G.gen.full_reclaimed += reclaimed;
+      promote_survivors ();
+    }
+  G.gen.minor_p = false;
+#endif
+
   G.allocated_last_gc = G.allocated;
 
   invoke_plugin_callbacks (PLUGIN_GGC_END, NULL);
@@ -1959,6 +3048,40 @@ ggc_collect (void)
 		     : (x) / (1024*1024))))
 #define STAT_LABEL(x) ((x) < 1024*10 ? ' ' : ((x) < 1024*1024*10 ? 'k' : 'M'))
 
+/* Print the statistics of the collections done so far to STREAM.  */
+
+void
+ggc_dump_statistics (FILE *stream ATTRIBUTE_UNUSED)
+{
+#ifdef GGC_GENERATIONAL
+  fprintf (stream, "%-30s %10lu\n", "Minor collections",
+	   G.gen.minor_collections);
+  fprintf (stream, "%-30s %10lu\n", "Full collections",
+	   G.gen.full_collections);
+  fprintf (stream, "%-30s %10lu\n", "  of which instead of minor",
+	   G.gen.forced_full_collections);
+  fprintf (stream, "%-30s %10lu%c\n", "Reclaimed by minor",
+	   SCALE (G.gen.minor_reclaimed),
+	   STAT_LABEL (G.gen.minor_reclaimed));
+  fprintf (stream, "%-30s %10lu%c\n", "Reclaimed by full",
+	   SCALE (G.gen.full_reclaimed),
+	   STAT_LABEL (G.gen.full_reclaimed));
+  fprintf (stream, "%-30s %10lu%c\n", "Old generation",
+	   SCALE (G.gen.old_bytes), STAT_LABEL (G.gen.old_bytes));
+  fprintf (stream, "%-30s %10lu\n", "Write faults",
+	   G.gen.write_faults);
+  fprintf (stream, "%-30s %10lu\n", "Dirty pages scanned",
+	   G.gen.dirty_pages);
+  fprintf (stream, "%-30s %10lu\n", "Old objects scanned",
+	   G.gen.rescanned_objects);
+  fprintf (stream, "%-30s %10lu\n", "New objects kept by them",
+	   G.gen.kept_objects);
+#endif
+#ifdef GGC_PARALLEL
+  fprintf (stream, "%-30s %10lu\n", "Parallel markings", G.par.markings);
+#endif
+}
+
 void
 ggc_print_statistics (void)
 {
@@ -2022,6 +3145,14 @@ ggc_print_statistics (void)
 	   SCALE (G.allocated), STAT_LABEL(G.allocated),
 	   SCALE (total_overhead), STAT_LABEL (total_overhead));
 
+#ifdef GGC_GENERATIONAL
+  if (G.gen.minor_collections || G.gen.full_collections)
+    {
+      fprintf (stderr, "\nGenerational collection\n");
+      ggc_dump_statistics (stderr);
+    }
+#endif
+
 #ifdef GATHER_STATISTICS
   {
     fprintf (stderr, "\nTotal allocations and overheads during the compilation process\n");
@@ -2210,10 +3341,12 @@ ggc_pch_finish (struct ggc_pch_data *d, FILE *f)
 }
 
 /* Move the PCH PTE entries just added to the end of by_depth, to the
-   front.  */
+   front.  CHAINED is true if the entries of another PCH file are already
+   there.  */
 
 static void
-move_ptes_to_front (int count_old_page_tables, int count_new_page_tables)
+move_ptes_to_front (int count_old_page_tables, int count_new_page_tables,
+		    bool chained)
 {
   unsigned i;
 
@@ -2254,8 +3387,15 @@ move_ptes_to_front (int count_old_page_tables, int count_new_page_tables)
      entry is already 0, and context 0 entries always start at index
      0, so there is nothing to update in the first slot.  We need a
      second slot, only if we have old ptes, and if we do, they start
-     at index count_new_page_tables.  */
-  if (count_old_page_tables)
+     at index count_new_page_tables.  When another PCH file was read
+     before, its entries are still at context 0, right after the new
+     ones, so the old ptes start that much further.  */
+  if (chained)
+    {
+      if (G.depth_in_use > 1)
+	G.depth[1] += count_new_page_tables;
+    }
+  else if (count_old_page_tables)
     push_depth (count_new_page_tables);
 }
 
@@ -2267,9 +3407,18 @@ ggc_pch_read (FILE *f, void *addr)
   char *offs = (char *) addr;
   unsigned long count_old_page_tables;
   unsigned long count_new_page_tables;
+  bool chained;
 
   count_old_page_tables = G.by_depth_in_use;
 
+#ifdef GGC_GENERATIONAL
+  /* The objects read from the PCH file are not tracked, and are
+     written to without notice.  */
+  if (G.gen.active)
+    stop_generational ();
+  G.gen.disabled = true;
+#endif
+
   /* We've just read in a PCH file.  So, every object that used to be
      allocated is now free.  */
   clear_marks ();
@@ -2282,14 +3431,18 @@ ggc_pch_read (FILE *f, void *addr)
 
   /* No object read from a PCH file should ever be freed.  So, set the
      context depth to 1, and set the depth of all the currently-allocated
-     pages to be 1 too.  PCH pages will have depth 0.  */
-  gcc_assert (!G.context_depth);
+     pages to be 1 too.  PCH pages will have depth 0.  If a PCH file was
+     read before, its pages keep depth 0: the objects in them can no
+     longer be reached, but they are left alone.  */
+  gcc_assert (G.context_depth <= 1);
+  chained = G.context_depth == 1;
   G.context_depth = 1;
   for (i = 0; i < NUM_ORDERS; i++)
     {
       page_entry *p;
       for (p = G.pages[i]; p != NULL; p = p->next)
-	p->context_depth = G.context_depth;
+	if (p->context_depth != 0 || !chained)
+	  p->context_depth = G.context_depth;
     }
 
   /* Allocate the appropriate page-table entries for the pages read from
@@ -2350,7 +3503,7 @@ ggc_pch_read (FILE *f, void *addr)
      handling.  */
   count_new_page_tables = G.by_depth_in_use - count_old_page_tables;
 
-  move_ptes_to_front (count_old_page_tables, count_new_page_tables);
+  move_ptes_to_front (count_old_page_tables, count_new_page_tables, chained);
 
   /* Update the statistics.  */
   G.allocated = G.allocated_last_gc = offs - (char *)addr;
@@ -1556,6 +1556,24 @@ ggc_set_mark (const void *p)
   return 0;
 }
 
+/* This collector does not mark in parallel.  */
+
+bool
+ggc_mark_roots_parallel (const struct ggc_root_tab *const *rtab
+			 ATTRIBUTE_UNUSED)
+{
+  return false;
+}
+
+/* Likewise, so nothing is ever pushed on a mark stack.  */
+
+void
+ggc_push_mark (void *p ATTRIBUTE_UNUSED,
+	       gt_pointer_walker walker ATTRIBUTE_UNUSED)
+{
+  gcc_unreachable ();
+}
+
 /* Return 1 if P has been marked, zero otherwise.
    P must have been allocated by the GC allocator; it mustn't point to
    static objects, stack variables, or memory allocated with malloc.  */
@@ -2087,6 +2105,14 @@ ggc_collect (void)
 		     : (x) / (1024*1024))))
 #define LABEL(x) ((x) < 1024*10 ? ' ' : ((x) < 1024*1024*10 ? 'k' : 'M'))
 
+/* Print the statistics of the collections done so far to STREAM.  The
+   zone collector does not keep any.  */
+
+void
+ggc_dump_statistics (FILE *stream ATTRIBUTE_UNUSED)
+{
+}
+
 void
 ggc_print_statistics (void)
 {
@@ -2450,6 +2476,10 @@ ggc_pch_read (FILE *f, void *addr)
   struct page_entry *pch_page;
   char *p;
 
+  /* The objects of a single PCH file are tracked.  */
+  if (pch_zone.page != NULL)
+    fatal_error ("can%'t read a second PCH file with the zone collector");
+
   if (fread (&d, sizeof (d), 1, f) != 1)
     fatal_error ("can%'t read PCH file: %m");
 
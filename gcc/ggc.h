@@ -104,6 +104,20 @@ extern const struct ggc_cache_tab * const gt_ggc_cache_rtab[];
       ggc_set_mark (a__);			\
   } while (0)
 
+/* True while several threads are marking objects.  */
+extern bool ggc_parallel_marking;
+
+/* Mark X, which is not NULL, with WALKER, the marking routine for its
+   type.  While several threads are marking, X is pushed on the mark
+   stack of the current thread instead, so that marking the objects it
+   points to can be shared with idle threads.  */
+#define ggc_mark_child(X, WALKER)					\
+  (ggc_parallel_marking ? ggc_push_mark ((X), (WALKER)) : (WALKER) (X))
+
+/* Push X on the mark stack of the current thread, to be marked later
+   with WALKER.  */
+extern void ggc_push_mark (void *, gt_pointer_walker);
+
 /* Actually set the mark on a particular region of memory, but don't
    follow pointers.  This function is called by ggc_mark_*.  It
    returns zero if the object was not previously marked; nonzero if
@@ -241,6 +255,9 @@ extern void ggc_register_root_tab (const struct ggc_root_tab *);
    plugins.  Does nothing if the passed pointer is NULL. */
 extern void ggc_register_cache_tab (const struct ggc_cache_tab *);
 
+/* Map the data of a PCH file open on FD ahead of gt_pch_restore.  */
+extern bool gt_pch_reserve (int fd);
+
 /* Read objects previously saved with gt_pch_save from F.  */
 extern void gt_pch_restore (FILE *f);
 
@@ -249,6 +266,10 @@ extern void gt_pch_restore (FILE *f);
 /* Print allocation statistics.  */
 extern void ggc_print_statistics (void);
 
+/* Print the statistics of the collections done so far to STREAM, for
+   -fdump-ggc.  */
+extern void ggc_dump_statistics (FILE *stream);
+
 extern void stringpool_statistics (void);
 
 /* Heuristics.  */
@@ -65,6 +65,11 @@ void __gcov_merge_delta (gcov_type *counters  __attribute__ ((unused)),
 			 unsigned n_counters __attribute__ ((unused))) {}
 #endif
 
+#ifdef L_gcov_merge_icall_topn
+void __gcov_merge_icall_topn (gcov_type *counters  __attribute__ ((unused)),
+			      unsigned n_counters __attribute__ ((unused))) {}
+#endif
+
 #else
 
 #include <string.h>
@@ -690,6 +695,90 @@ __gcov_merge_single (gcov_type *counters, unsigned n_counters)
 }
 #endif /* L_gcov_merge_single */
 
+#ifdef L_gcov_merge_icall_topn
+/* The profile merging function for choosing the most common targets of
+   an indirect call.  It is given an array COUNTERS of N_COUNTERS old
+   counters and it reads the same number of counters from the gcov file.
+   The counters are split into GCOV_ICALL_TOPN_NCOUNTS-tuples where the
+   members of the tuple have meanings:
+
+   -- total number of calls
+   -- GCOV_ICALL_TOPN_VAL pairs of a candidate target and its counter,
+      a zero counter marking an unused pair
+
+   The candidates of both tables are combined and the
+   GCOV_ICALL_TOPN_VAL ones with the largest counters are kept, their
+   counters decreased by the largest counter that is dropped.  */
+void
+__gcov_merge_icall_topn (gcov_type *counters, unsigned n_counters)
+{
+  gcov_type values[2 * GCOV_ICALL_TOPN_VAL];
+  gcov_type counts[2 * GCOV_ICALL_TOPN_VAL];
+  unsigned i, j, k, n, n_measures;
+  gcov_type value, counter, cut;
+
+  gcc_assert (!(n_counters % GCOV_ICALL_TOPN_NCOUNTS));
+  n_measures = n_counters / GCOV_ICALL_TOPN_NCOUNTS;
+  for (i = 0; i < n_measures; i++, counters += GCOV_ICALL_TOPN_NCOUNTS)
+    {
+      counters[0] += gcov_read_counter ();
+
+      n = 0;
+      for (j = 0; j < GCOV_ICALL_TOPN_VAL; j++)
+	if (counters[2 + 2 * j] > 0)
+	  {
+	    values[n] = counters[1 + 2 * j];
+	    counts[n] = counters[2 + 2 * j];
+	    n++;
+	  }
+      for (j = 0; j < GCOV_ICALL_TOPN_VAL; j++)
+	{
+	  value = gcov_read_counter ();
+	  counter = gcov_read_counter ();
+	  if (counter <= 0)
+	    continue;
+	  for (k = 0; k < n; k++)
+	    if (values[k] == value)
+	      break;
+	  if (k == n)
+	    {
+	      values[n] = value;
+	      counts[n] = 0;
+	      n++;
+	    }
+	  counts[k] += counter;
+	}
+
+      /* Sort the candidates by decreasing counter.  */
+      for (j = 1; j < n; j++)
+	{
+	  value = values[j];
+	  counter = counts[j];
+	  for (k = j; k > 0 && counts[k - 1] < counter; k--)
+	    {
+	      values[k] = values[k - 1];
+	      counts[k] = counts[k - 1];
+	    }
+	  values[k] = value;
+	  counts[k] = counter;
+	}
+
+      cut = n > GCOV_ICALL_TOPN_VAL ? counts[GCOV_ICALL_TOPN_VAL] : 0;
+      for (j = 0; j < GCOV_ICALL_TOPN_VAL; j++)
+	if (j < n && counts[j] > cut)
+	  {
+	    counters[1 + 2 * j] = values[j];
+	    counters[2 + 2 * j] = counts[j] - cut;
+	  }
+	else
+	  {
+	    counters[1 + 2 * j] = 0;
+	    counters[2 + 2 * j] = 0;
+	  }
+    }
+}
+#endif /* L_gcov_merge_icall_topn */
+
 #ifdef L_gcov_merge_delta
 /* The profile merging function for choosing the most common
    difference between two consecutive evaluations of the value.  It is
@@ -797,7 +886,8 @@ __gcov_one_value_profiler (gcov_type *counters, gcov_type value)
 }
 #endif
 
-#ifdef L_gcov_indirect_call_profiler
+#if defined (L_gcov_indirect_call_profiler) \
+    || defined (L_gcov_indirect_call_topn_profiler)
 
 /* By default, the C++ compiler will use function addresses in the
    vtable entries.  Setting TARGET_VTABLE_USES_DESCRIPTORS to nonzero
@@ -815,7 +905,9 @@ __gcov_one_value_profiler (gcov_type *counters, gcov_type value)
 #else
 #define VTABLE_USES_DESCRIPTORS 0
 #endif
+#endif
 
+#ifdef L_gcov_indirect_call_profiler
 /* Tries to determine the most common value among its inputs. */
 void
 __gcov_indirect_call_profiler (gcov_type* counter, gcov_type value,
@@ -831,6 +923,63 @@ __gcov_indirect_call_profiler (gcov_type* counter, gcov_type value,
 }
 #endif
 
+#ifdef L_gcov_indirect_call_topn_profiler
+/* Tries to determine the GCOV_ICALL_TOPN_VAL most common values among
+   its inputs.  COUNTERS[0] counts all the values; it is followed by
+   GCOV_ICALL_TOPN_VAL pairs of a candidate value and its counter.  If
+   VALUE matches a candidate, its counter is incremented.  Otherwise
+   VALUE takes a pair whose counter is zero if there is one, and all the
+   counters are decremented if there is not.  This guarantees that every
+   value seen more than COUNTERS[0] / (GCOV_ICALL_TOPN_VAL + 1) times is
+   a candidate in the end, its counter being short by at most that
+   much.  */
+
+static inline void
+__gcov_topn_value_profiler_body (gcov_type *counters, gcov_type value)
+{
+  unsigned i;
+  gcov_type *entry, *free_entry = 0;
+
+  counters[0]++;
+  for (i = 0; i < GCOV_ICALL_TOPN_VAL; i++)
+    {
+      entry = &counters[1 + 2 * i];
+      if (entry[1] == 0)
+	{
+	  if (!free_entry)
+	    free_entry = entry;
+	}
+      else if (entry[0] == value)
+	{
+	  entry[1]++;
+	  return;
+	}
+    }
+
+  if (free_entry)
+    {
+      free_entry[0] = value;
+      free_entry[1] = 1;
+    }
+  else
+    for (i = 0; i < GCOV_ICALL_TOPN_VAL; i++)
+      counters[2 + 2 * i]--;
+}
+
+/* Like __gcov_indirect_call_profiler, but records the most common
+   callees of the call site in the table COUNTER of
+   GCOV_ICALL_TOPN_NCOUNTS counters.  */
+void
+__gcov_indirect_call_topn_profiler (gcov_type* counter, gcov_type value,
+				    void* cur_func, void* callee_func)
+{
+  if (cur_func == callee_func
+      || (VTABLE_USES_DESCRIPTORS && callee_func
+	  && *(void **) cur_func == *(void **) callee_func))
+    __gcov_topn_value_profiler_body (counter, value);
+}
+#endif
+
 
 #ifdef L_gcov_average_profiler
 /* Increase corresponding COUNTER by VALUE.  FIXME: Perhaps we want
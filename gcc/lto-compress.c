@@ -51,6 +51,31 @@ struct lto_compression_stream
 static const size_t Z_BUFFER_LENGTH = 4096;
 static const size_t MIN_STREAM_ALLOCATION = 1024;
 
+/* Constants of the LZ4 block format.  A match is at least LZ4_MIN_MATCH
+   bytes long and at most LZ4_MAX_OFFSET bytes back, the last
+   LZ4_LAST_LITERALS bytes of a block are literals and no match starts
+   in the last LZ4_MF_LIMIT bytes.  */
+
+#define LZ4_MIN_MATCH 4
+#define LZ4_MAX_OFFSET 65535
+#define LZ4_LAST_LITERALS 5
+#define LZ4_MF_LIMIT 12
+#define LZ4_HASH_LOG 14
+
+/* Data compressed with lz4 is split in blocks of at most this size, which
+   are compressed independently.  */
+
+static const size_t LZ4_BLOCK_LENGTH = 256 * 1024;
+
+/* Each lz4 block is preceded by a header made of these four bytes, the
+   uncompressed and the compressed length of the block as 32-bit little
+   endian numbers.  A zlib stream can not start with this magic, so
+   sections compressed with either algorithm can be told apart, even
+   when the linker concatenated them.  */
+
+static const unsigned char LZ4_MAGIC[4] = { 'L', 'Z', '4', 'B' };
+#define LZ4_HEADER_LENGTH 12
+
 /* For zlib, allocate SIZE count of ITEMS and return the address, OPAQUE
    is unused.  */
 
@@ -161,10 +186,198 @@ lto_compress_block (struct lto_compression_stream *stream,
   lto_stats.num_output_il_bytes += num_chars;
 }
 
-/* Finalize STREAM compression, and free stream allocations.  */
+/* Store the 32-bit number VALUE at P, least significant byte first.  */
 
-void
-lto_end_compression (struct lto_compression_stream *stream)
+static void
+lz4_put_length (unsigned char *p, size_t value)
+{
+  p[0] = value & 0xff;
+  p[1] = (value >> 8) & 0xff;
+  p[2] = (value >> 16) & 0xff;
+  p[3] = (value >> 24) & 0xff;
+}
+
+/* Return the 32-bit number stored at P by lz4_put_length.  */
+
+static size_t
+lz4_get_length (const unsigned char *p)
+{
+  return ((size_t) p[0] | ((size_t) p[1] << 8) | ((size_t) p[2] << 16)
+	  | ((size_t) p[3] << 24));
+}
+
+/* Return the hash of the four bytes at P.  */
+
+static inline unsigned int
+lz4_hash (const unsigned char *p)
+{
+  uint32_t v;
+
+  memcpy (&v, p, sizeof v);
+  return (v * 2654435761U) >> (32 - LZ4_HASH_LOG);
+}
+
+/* Write the length LEN, less the part of it already stored in a token,
+   to OP as a sequence of bytes of 255 and a final byte less than 255.
+   Return the address after it.  */
+
+static unsigned char *
+lz4_put_extra_length (unsigned char *op, size_t len)
+{
+  for (; len >= 255; len -= 255)
+    *op++ = 255;
+  *op++ = len;
+  return op;
+}
+
+/* Write a sequence to OP made of the LIT_LEN literals at LIT and a match of
+   MATCH_LEN bytes OFFSET bytes back.  A MATCH_LEN of zero stands for the
+   last sequence of the block, which has no match.  Return the address after
+   the sequence.  */
+
+static unsigned char *
+lz4_put_sequence (unsigned char *op, const unsigned char *lit, size_t lit_len,
+		  size_t offset, size_t match_len)
+{
+  unsigned char *token = op++;
+
+  *token = (lit_len < 15 ? lit_len : 15) << 4;
+  if (lit_len >= 15)
+    op = lz4_put_extra_length (op, lit_len - 15);
+  memcpy (op, lit, lit_len);
+  op += lit_len;
+
+  if (match_len)
+    {
+      match_len -= LZ4_MIN_MATCH;
+      *op++ = offset & 0xff;
+      *op++ = offset >> 8;
+      *token |= match_len < 15 ? match_len : 15;
+      if (match_len >= 15)
+	op = lz4_put_extra_length (op, match_len - 15);
+    }
+  return op;
+}
+
+/* Compress the LEN bytes at SRC to DST, which must have room for
+   LZ4_COMPRESS_BOUND (LEN) bytes, using TABLE as the match finder hash
+   table.  Return the compressed length.  */
+
+#define LZ4_COMPRESS_BOUND(LEN) ((LEN) + (LEN) / 255 + 16)
+
+static size_t
+lz4_compress (const unsigned char *src, size_t len, unsigned char *dst,
+	      unsigned int *table)
+{
+  size_t ip = 0, anchor = 0;
+  unsigned char *op = dst;
+
+  memset (table, 0, sizeof (unsigned int) << LZ4_HASH_LOG);
+  if (len >= LZ4_MF_LIMIT)
+    while (ip <= len - LZ4_MF_LIMIT)
+      {
+	unsigned int h = lz4_hash (src + ip);
+	size_t ref = table[h], match_len;
+
+	/* Positions are stored biased by one, zero meaning none.  */
+	table[h] = ip + 1;
+	if (ref == 0
+	    || ip - (ref - 1) > LZ4_MAX_OFFSET
+	    || memcmp (src + ref - 1, src + ip, LZ4_MIN_MATCH) != 0)
+	  {
+	    ip++;
+	    continue;
+	  }
+	ref--;
+
+	match_len = LZ4_MIN_MATCH;
+	while (ip + match_len < len - LZ4_LAST_LITERALS
+	       && src[ref + match_len] == src[ip + match_len])
+	  match_len++;
+
+	op = lz4_put_sequence (op, src + anchor, ip - anchor, ip - ref,
+			       match_len);
+	ip += match_len;
+	anchor = ip;
+      }
+
+  op = lz4_put_sequence (op, src + anchor, len - anchor, 0, 0);
+  return op - dst;
+}
+
+/* Read the rest of a length from *IP, not past END, adding it to *LEN.
+   Return false if the data ends early.  */
+
+static bool
+lz4_get_extra_length (const unsigned char **ip, const unsigned char *end,
+		      size_t *len)
+{
+  unsigned char c;
+
+  do
+    {
+      if (*ip >= end)
+	return false;
+      c = *(*ip)++;
+      *len += c;
+    }
+  while (c == 255);
+  return true;
+}
+
+/* Uncompress the LEN bytes at SRC to the DST_LEN bytes at DST.  Return
+   false if they are not a valid lz4 block of that size.  */
+
+static bool
+lz4_uncompress (const unsigned char *src, size_t len, unsigned char *dst,
+		size_t dst_len)
+{
+  const unsigned char *ip = src, *end = src + len;
+  unsigned char *op = dst, *op_end = dst + dst_len;
+
+  while (ip < end)
+    {
+      unsigned char token = *ip++;
+      size_t lit_len = token >> 4, match_len = token & 15, offset;
+
+      if (lit_len == 15 && !lz4_get_extra_length (&ip, end, &lit_len))
+	return false;
+      if (lit_len > (size_t) (end - ip) || lit_len > (size_t) (op_end - op))
+	return false;
+      memcpy (op, ip, lit_len);
+      op += lit_len;
+      ip += lit_len;
+
+      /* The last sequence has no match.  */
+      if (ip == end)
+	break;
+
+      if (end - ip < 2)
+	return false;
+      offset = ip[0] | (ip[1] << 8);
+      ip += 2;
+      if (offset == 0 || offset > (size_t) (op - dst))
+	return false;
+
+      if (match_len == 15 && !lz4_get_extra_length (&ip, end, &match_len))
+	return false;
+      match_len += LZ4_MIN_MATCH;
+      if (match_len > (size_t) (op_end - op))
+	return false;
+
+      /* The match may overlap the bytes it produces.  */
+      for (; match_len > 0; match_len--, op++)
+	*op = *(op - offset);
+    }
+
+  return op == op_end;
+}
+
+/* Compress the data accumulated in STREAM with zlib and pass it to the
+   callback of STREAM.  */
+
+static void
+lto_zlib_compress (struct lto_compression_stream *stream)
 {
   unsigned char *cursor = (unsigned char *) stream->buffer;
   size_t remaining = stream->bytes;
@@ -174,8 +387,6 @@ lto_end_compression (struct lto_compression_stream *stream)
   size_t compressed_bytes = 0;
   int status;
 
-  gcc_assert (stream->is_compression);
-
   out_stream.next_out = outbuf;
   out_stream.avail_out = outbuf_length;
   out_stream.next_in = cursor;
@@ -217,10 +428,71 @@ lto_end_compression (struct lto_compression_stream *stream)
   if (status != Z_OK)
     internal_error ("compressed stream: %s", zError (status));
 
-  lto_destroy_compression_stream (stream);
   free (outbuf);
 }
 
+/* Compress the data accumulated in STREAM with lz4 and pass it to the
+   callback of STREAM, one block at a time.  */
+
+static void
+lto_lz4_compress (struct lto_compression_stream *stream)
+{
+  const unsigned char *cursor = (const unsigned char *) stream->buffer;
+  size_t remaining = stream->bytes;
+  unsigned char *outbuf
+    = XNEWVEC (unsigned char,
+	       LZ4_HEADER_LENGTH + LZ4_COMPRESS_BOUND (LZ4_BLOCK_LENGTH));
+  unsigned int *table = XNEWVEC (unsigned int, 1 << LZ4_HASH_LOG);
+
+  /* An empty stream is still written as one block, so that the section
+     is recognized as compressed by lz4.  */
+  do
+    {
+      size_t in_bytes = MIN (remaining, LZ4_BLOCK_LENGTH);
+      size_t out_bytes = lz4_compress (cursor, in_bytes,
+				       outbuf + LZ4_HEADER_LENGTH, table);
+
+      memcpy (outbuf, LZ4_MAGIC, sizeof LZ4_MAGIC);
+      lz4_put_length (outbuf + 4, in_bytes);
+      lz4_put_length (outbuf + 8, out_bytes);
+      out_bytes += LZ4_HEADER_LENGTH;
+
+      stream->callback ((const char *) outbuf, out_bytes, stream->opaque);
+      lto_stats.num_compressed_il_bytes += out_bytes;
+
+      cursor += in_bytes;
+      remaining -= in_bytes;
+    }
+  while (remaining > 0);
+
+  free (table);
+  free (outbuf);
+}
+
+/* Finalize STREAM compression, and free stream allocations.  */
+
+void
+lto_end_compression (struct lto_compression_stream *stream)
+{
+  gcc_assert (stream->is_compression);
+
+  switch (flag_lto_compression_algorithm)
+    {
+    case LTO_COMPRESSION_ZLIB:
+      lto_zlib_compress (stream);
+      break;
+
+    case LTO_COMPRESSION_LZ4:
+      lto_lz4_compress (stream);
+      break;
+
+    default:
+      gcc_unreachable ();
+    }
+
+  lto_destroy_compression_stream (stream);
+}
+
 /* Return a new uncompression stream, with CALLBACK flush function passed
    OPAQUE token.  */
 
@@ -243,11 +515,43 @@ lto_uncompress_block (struct lto_compression_stream *stream,
   lto_stats.num_input_il_bytes += num_chars;
 }
 
+/* Uncompress the lz4 block at *CURSOR, which has *REMAINING bytes after
+   it, pass it to the callback of STREAM and advance *CURSOR past it.  */
+
+static void
+lto_lz4_uncompress (struct lto_compression_stream *stream,
+		    unsigned char **cursor, size_t *remaining)
+{
+  size_t in_bytes, out_bytes;
+  unsigned char *outbuf;
+
+  if (*remaining < LZ4_HEADER_LENGTH)
+    internal_error ("compressed stream: truncated lz4 block header");
+  out_bytes = lz4_get_length (*cursor + 4);
+  in_bytes = lz4_get_length (*cursor + 8);
+  *cursor += LZ4_HEADER_LENGTH;
+  *remaining -= LZ4_HEADER_LENGTH;
+  if (in_bytes > *remaining || out_bytes > LZ4_BLOCK_LENGTH)
+    internal_error ("compressed stream: invalid lz4 block header");
+
+  outbuf = XNEWVEC (unsigned char, out_bytes);
+  if (!lz4_uncompress (*cursor, in_bytes, outbuf, out_bytes))
+    internal_error ("compressed stream: invalid lz4 block");
+
+  stream->callback ((const char *) outbuf, out_bytes, stream->opaque);
+  lto_stats.num_uncompressed_il_bytes += out_bytes;
+  free (outbuf);
+
+  *cursor += in_bytes;
+  *remaining -= in_bytes;
+}
+
 /* Finalize STREAM uncompression, and free stream allocations.
 
    Because of the way LTO IL streams are compressed, there may be several
    concatenated compressed segments in the accumulated data, so for this
-   function we iterate decompressions until no data remains.  */
+   function we iterate decompressions until no data remains.  Each segment
+   is either a zlib stream or an lz4 block.  */
 
 void
 lto_end_uncompression (struct lto_compression_stream *stream)
@@ -266,6 +570,13 @@ lto_end_uncompression (struct lto_compression_stream *stream)
       size_t out_bytes;
       int status;
 
+      if (remaining >= sizeof LZ4_MAGIC
+	  && memcmp (cursor, LZ4_MAGIC, sizeof LZ4_MAGIC) == 0)
+	{
+	  lto_lz4_uncompress (stream, &cursor, &remaining);
+	  continue;
+	}
+
       in_stream.next_out = outbuf;
       in_stream.avail_out = outbuf_length;
       in_stream.next_in = cursor;
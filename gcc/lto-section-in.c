@@ -225,8 +225,9 @@ lto_get_section_data (struct lto_file_decl_data *file_data,
     return NULL;
 
   /* FIXME lto: WPA mode does not write compressed sections, so for now
-     suppress uncompression if flag_ltrans.  */
-  if (flag_ltrans)
+     suppress uncompression if flag_ltrans.  Function bodies are the
+     exception, see copy_function.  */
+  if (flag_ltrans && section_type != LTO_section_function_body)
     return data;
 
   /* Create a mapping header containing the underlying data and length,
@@ -269,7 +270,7 @@ lto_free_section_data (struct lto_file_decl_data *file_data,
 
   /* FIXME lto: WPA mode does not write compressed sections, so for now
      suppress uncompression mapping if flag_ltrans.  */
-  if (flag_ltrans)
+  if (flag_ltrans && section_type != LTO_section_function_body)
     {
       (free_section_f) (file_data, section_type, name, data, len);
       return;
@@ -282,6 +283,38 @@ lto_free_section_data (struct lto_file_decl_data *file_data,
 }
 
 
+/* Return a char pointer to the data of a section, as it is stored in
+   the object file and without uncompressing it.  The arguments are the
+   same as for lto_get_section_data.  The data is mapped rather than
+   read into memory where the host allows it.  */
+
+const char *
+lto_get_raw_section_data (struct lto_file_decl_data *file_data,
+			  enum lto_section_type section_type,
+			  const char *name,
+			  size_t *len)
+{
+  const char *data = (get_section_f) (file_data, section_type, name, len);
+  lto_stats.section_size[section_type] += *len;
+  return data;
+}
+
+
+/* Free the data found by lto_get_raw_section_data.  The arguments are
+   the same as for lto_free_section_data.  */
+
+void
+lto_free_raw_section_data (struct lto_file_decl_data *file_data,
+			   enum lto_section_type section_type,
+			   const char *name,
+			   const char *data,
+			   size_t len)
+{
+  gcc_assert (free_section_f);
+  (free_section_f) (file_data, section_type, name, data, len);
+}
+
+
 /* Load a section of type SECTION_TYPE from FILE_DATA, parse the
    header and then return an input block pointing to the section.  The
    raw pointer to the section is returned in DATAR and LEN.  These are
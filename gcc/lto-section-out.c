@@ -152,6 +152,18 @@ lto_end_section (void)
 }
 
 
+/* Write SIZE bytes starting at DATA to the current section as they are,
+   without going through an output stream.  The section must not be
+   compressed.  */
+
+void
+lto_write_raw_data (const void *data, size_t size)
+{
+  gcc_assert (compression_stream == NULL);
+  lang_hooks.lto.append_data (data, size, NULL);
+}
+
+
 /* Write all of the chars in OBS to the assembler.  Recycle the blocks
    in obs as this is being done.  */
 
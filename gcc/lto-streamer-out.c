@@ -1849,7 +1849,10 @@ produce_asm (struct output_block *ob, tree fn)
   else
     section_name = lto_get_section_name (section_type, NULL, NULL);
 
-  lto_begin_section (section_name, !flag_wpa);
+  /* Function bodies are compressed even in WPA, so that copy_function
+     can pass them through without uncompressing them.  */
+  lto_begin_section (section_name,
+		     !flag_wpa || section_type == LTO_section_function_body);
   free (section_name);
 
   /* The entire header is stream computed here.  */
@@ -2105,14 +2108,15 @@ output_unreferenced_globals (cgraph_node_set set, varpool_node_set vset)
 }
 
 
-/* Copy the function body of NODE without deserializing. */
+/* Copy the function body of NODE without deserializing.  The body is
+   copied as it is stored in the input file, still compressed, so WPA
+   never holds it uncompressed in memory.  */
 
 static void
 copy_function (struct cgraph_node *node)
 {
   tree function = node->decl;
   struct lto_file_decl_data *file_data = node->local.lto_file_data;
-  struct lto_output_stream *output_stream = XCNEW (struct lto_output_stream);
   const char *data;
   size_t len;
   const char *name = IDENTIFIER_POINTER (DECL_ASSEMBLER_NAME (function));
@@ -2122,19 +2126,18 @@ copy_function (struct cgraph_node *node)
   struct lto_in_decl_state *in_state;
   struct lto_out_decl_state *out_state = lto_get_out_decl_state ();
 
-  lto_begin_section (section_name, !flag_wpa);
+  lto_begin_section (section_name, false);
   free (section_name);
 
   /* We may have renamed the declaration, e.g., a static function.  */
   name = lto_get_decl_name_mapping (file_data, name);
 
-  data = lto_get_section_data (file_data, LTO_section_function_body,
-                               name, &len);
+  data = lto_get_raw_section_data (file_data, LTO_section_function_body,
+				   name, &len);
   gcc_assert (data);
 
   /* Do a bit copy of the function body.  */
-  lto_output_data_stream (output_stream, data, len);
-  lto_write_stream (output_stream);
+  lto_write_raw_data (data, len);
 
   /* Copy decls. */
   in_state =
@@ -2156,9 +2159,8 @@ copy_function (struct cgraph_node *node)
       encoder->next_index = n;
     }
 
-  lto_free_section_data (file_data, LTO_section_function_body, name,
-			 data, len);
-  free (output_stream);
+  lto_free_raw_section_data (file_data, LTO_section_function_body, name,
+			     data, len);
   lto_end_section ();
 }
 
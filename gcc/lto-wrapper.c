@@ -43,6 +43,10 @@ along with GCC; see the file COPYING3.  If not see
 #include "intl.h"
 #include "obstack.h"
 
+#ifdef HAVE_SYS_SELECT_H
+#include <sys/select.h>
+#endif
+
 int debug;				/* true if -save-temps.  */
 int verbose;				/* true if -v.  */
 
@@ -63,6 +67,40 @@ static char **input_names;
 static char **output_names;
 static char *makefile;
 
+/* An LTRANS job run by the job pool of lto-wrapper.  */
+
+struct ltrans_job
+{
+  /* The index of the partition in INPUT_NAMES and OUTPUT_NAMES.  */
+  unsigned int partition;
+
+  /* The size of the IL of the partition.  Larger partitions are
+     started first.  */
+  off_t size;
+
+  /* The command to run, and the file its arguments are passed in.  */
+  char **argv;
+  char *args_name;
+
+  /* The running process, and the pipe its standard output is read
+     from, or NULL.  */
+  struct pex_obj *pex;
+  FILE *output;
+
+  /* True once the process has finished successfully.  */
+  bool done;
+};
+
+static struct ltrans_job *ltrans_jobs;
+static unsigned int nr_ltrans_jobs;
+
+/* For each partition, the job compiling it, or NULL for pass-through
+   files.  */
+static struct ltrans_job **partition_jobs;
+
+/* The number of LTRANS output names already given to the linker.  */
+static unsigned int nr_printed;
+
 static void maybe_unlink_file (const char *);
 
  /* Delete tempfiles.  */
@@ -88,7 +126,16 @@ lto_wrapper_cleanup (void)
     maybe_unlink_file (args_name);
   if (makefile)
     maybe_unlink_file (makefile);
-  for (i = 0; i < nr; ++i)
+  for (i = 0; i < nr_ltrans_jobs; ++i)
+    {
+      /* This waits for the process if it is still running.  On a
+	 signal from the terminal, the jobs get it too.  */
+      if (ltrans_jobs[i].pex)
+	pex_free (ltrans_jobs[i].pex);
+      if (ltrans_jobs[i].args_name)
+	maybe_unlink_file (ltrans_jobs[i].args_name);
+    }
+  for (i = nr_printed; i < nr; ++i)
     {
       maybe_unlink_file (input_names[i]);
       if (output_names[i])
@@ -144,10 +191,10 @@ fatal_perror (const char *cmsgid, ...)
 
 
 /* Execute a program, and wait for the reply. ARGV are the arguments. The
-   last one must be NULL. */
+   last one must be NULL.  FLAGS are passed to pex_init.  */
 
 static struct pex_obj *
-collect_execute (char **argv)
+collect_execute (char **argv, int flags)
 {
   struct pex_obj *pex;
   const char *errmsg;
@@ -167,7 +214,7 @@ collect_execute (char **argv)
   fflush (stdout);
   fflush (stderr);
 
-  pex = pex_init (0, "lto-wrapper", NULL);
+  pex = pex_init (flags, "lto-wrapper", NULL);
   if (pex == NULL)
     fatal_perror ("pex_init failed");
 
@@ -240,10 +287,12 @@ maybe_unlink_file (const char *file)
 }
 
 
-/* Execute program ARGV[0] with arguments ARGV. Wait for it to finish.  */
+/* Start program ARGV[0] with arguments ARGV, which are passed in a
+   temporary file whose name is stored in *ARGS_FILE.  FLAGS are passed
+   to pex_init.  */
 
-static void
-fork_execute (char **argv)
+static struct pex_obj *
+start_execute (char **argv, char **args_file, int flags)
 {
   struct pex_obj *pex;
   char *new_argv[3];
@@ -251,16 +300,16 @@ fork_execute (char **argv)
   FILE *args;
   int status;
 
-  args_name = make_temp_file (".args");
-  at_args = concat ("@", args_name, NULL);
-  args = fopen (args_name, "w");
+  *args_file = make_temp_file (".args");
+  at_args = concat ("@", *args_file, NULL);
+  args = fopen (*args_file, "w");
   if (args == NULL)
-    fatal ("failed to open %s", args_name);
+    fatal ("failed to open %s", *args_file);
 
   status = writeargv (&argv[1], args);
 
   if (status)
-    fatal ("could not write to temporary file %s",  args_name);
+    fatal ("could not write to temporary file %s",  *args_file);
 
   fclose (args);
 
@@ -268,12 +317,180 @@ fork_execute (char **argv)
   new_argv[1] = at_args;
   new_argv[2] = NULL;
 
-  pex = collect_execute (new_argv);
-  collect_wait (new_argv[0], pex);
+  pex = collect_execute (new_argv, flags);
+  free (at_args);
+  return pex;
+}
+
+/* Execute program ARGV[0] with arguments ARGV. Wait for it to finish.  */
+
+static void
+fork_execute (char **argv)
+{
+  struct pex_obj *pex;
+
+  pex = start_execute (argv, &args_name, 0);
+  collect_wait (argv[0], pex);
 
   maybe_unlink_file (args_name);
   args_name = NULL;
-  free (at_args);
+}
+
+/* Return the number of processors available to run LTRANS jobs on.  */
+
+static int
+available_processors (void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+  long n = sysconf (_SC_NPROCESSORS_ONLN);
+  if (n > 1)
+    return (int) n;
+#endif
+  return 1;
+}
+
+/* Compare LTRANS jobs, ordering larger partitions first.  */
+
+static int
+ltrans_job_cmp (const void *p1, const void *p2)
+{
+  const struct ltrans_job *j1 = (const struct ltrans_job *) p1;
+  const struct ltrans_job *j2 = (const struct ltrans_job *) p2;
+
+  if (j1->size != j2->size)
+    return j1->size < j2->size ? 1 : -1;
+  return j1->partition < j2->partition ? -1 : 1;
+}
+
+/* Start the process of the LTRANS job JOB.  */
+
+static void
+start_ltrans_job (struct ltrans_job *job)
+{
+#ifdef HAVE_SYS_SELECT_H
+  /* The standard output of the process goes to a pipe, whose end of file
+     tells the process has finished.  */
+  job->pex = start_execute (job->argv, &job->args_name, PEX_USE_PIPES);
+  job->output = pex_read_output (job->pex, 0);
+  if (job->output == NULL)
+    fatal_perror ("can't read output of %s", job->argv[0]);
+#else
+  job->pex = start_execute (job->argv, &job->args_name, 0);
+#endif
+}
+
+/* Wait for one of the running jobs among the first N_STARTED jobs in
+   LTRANS_JOBS to finish, and return it.  */
+
+static struct ltrans_job *
+wait_ltrans_job (unsigned int n_started)
+{
+  unsigned int i;
+#ifdef HAVE_SYS_SELECT_H
+  char buf[512];
+
+  for (;;)
+    {
+      fd_set fds;
+      int max_fd = -1;
+
+      FD_ZERO (&fds);
+      for (i = 0; i < n_started; i++)
+	if (ltrans_jobs[i].pex)
+	  {
+	    int fd = fileno (ltrans_jobs[i].output);
+	    FD_SET (fd, &fds);
+	    if (fd > max_fd)
+	      max_fd = fd;
+	  }
+
+      if (select (max_fd + 1, &fds, NULL, NULL, NULL) < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  fatal_perror ("select");
+	}
+
+      for (i = 0; i < n_started; i++)
+	if (ltrans_jobs[i].pex
+	    && FD_ISSET (fileno (ltrans_jobs[i].output), &fds))
+	  {
+	    /* Anything the job prints is discarded, as it would be
+	       if its standard output went to a temporary file.  */
+	    ssize_t len = read (fileno (ltrans_jobs[i].output),
+				buf, sizeof buf);
+	    if (len < 0 && errno != EINTR)
+	      fatal_perror ("can't read output of %s",
+			    ltrans_jobs[i].argv[0]);
+	    if (len == 0)
+	      return &ltrans_jobs[i];
+	  }
+    }
+#else
+  /* Without a way to wait for any of the jobs, wait for the oldest.  */
+  for (i = 0; i < n_started; i++)
+    if (ltrans_jobs[i].pex)
+      break;
+  return &ltrans_jobs[i];
+#endif
+}
+
+/* Print the names of the LTRANS outputs that are ready and follow all
+   those printed before, so that the linker can read them while the
+   remaining partitions are compiled.  */
+
+static void
+print_ltrans_outputs (void)
+{
+  while (nr_printed < nr
+	 && (!partition_jobs[nr_printed] || partition_jobs[nr_printed]->done))
+    {
+      fputs (output_names[nr_printed], stdout);
+      putc ('\n', stdout);
+      maybe_unlink_file (input_names[nr_printed]);
+      nr_printed++;
+    }
+  fflush (stdout);
+}
+
+/* Run the LTRANS jobs, at most N_PARALLEL at a time.  */
+
+static void
+run_ltrans_jobs (unsigned int n_parallel)
+{
+  unsigned int n_started = 0, running = 0;
+
+  qsort (ltrans_jobs, nr_ltrans_jobs, sizeof (struct ltrans_job),
+	 ltrans_job_cmp);
+  for (n_started = 0; n_started < nr_ltrans_jobs; n_started++)
+    partition_jobs[ltrans_jobs[n_started].partition]
+      = &ltrans_jobs[n_started];
+
+  n_started = 0;
+  while (n_started < nr_ltrans_jobs || running > 0)
+    {
+      struct ltrans_job *job;
+      struct pex_obj *pex;
+
+      while (running < n_parallel && n_started < nr_ltrans_jobs)
+	{
+	  start_ltrans_job (&ltrans_jobs[n_started++]);
+	  running++;
+	}
+
+      job = wait_ltrans_job (n_started);
+      pex = job->pex;
+      job->pex = NULL;
+      job->output = NULL;
+      collect_wait (job->argv[0], pex);
+      running--;
+      maybe_unlink_file (job->args_name);
+      free (job->args_name);
+      job->args_name = NULL;
+      job->done = true;
+
+      print_ltrans_outputs ();
+    }
 }
 
 /* Template of LTRANS dumpbase suffix.  */
@@ -371,6 +588,12 @@ run_gcc (unsigned argc, char *argv[])
 		    jobserver = 1;
 		    parallel = 1;
 		  }
+		else if (!strcmp (option + 6, "auto"))
+		  {
+		    parallel = available_processors ();
+		    if (parallel <= 1)
+		      parallel = 0;
+		  }
 		else
 		  {
 		    parallel = atoi (option + 6);
@@ -518,14 +741,17 @@ cont:
       maybe_unlink_file (ltrans_output_file);
       ltrans_output_file = NULL;
 
-      if (parallel)
+      partition_jobs = XCNEWVEC (struct ltrans_job *, nr);
+      if (jobserver)
 	{
 	  makefile = make_temp_file (".mk");
 	  mstream = fopen (makefile, "w");
 	}
+      else if (parallel)
+	ltrans_jobs = XCNEWVEC (struct ltrans_job, nr);
 
       /* Execute the LTRANS stage for each input file (or prepare a
-	 makefile to invoke this in parallel).  */
+	 makefile or the job pool to invoke this in parallel).  */
       for (i = 0; i < nr; ++i)
 	{
 	  char *output_name;
@@ -558,61 +784,62 @@ cont:
 	  argv_ptr[3] = output_name;
 	  argv_ptr[4] = input_name;
 	  argv_ptr[5] = NULL;
-	  if (parallel)
+	  if (jobserver)
 	    {
 	      fprintf (mstream, "%s:\n\t@%s ", output_name, new_argv[0]);
 	      for (j = 1; new_argv[j] != NULL; ++j)
 		fprintf (mstream, " '%s'", new_argv[j]);
 	      fprintf (mstream, "\n");
 	    }
+	  else if (parallel)
+	    {
+	      struct ltrans_job *job = &ltrans_jobs[nr_ltrans_jobs++];
+	      struct stat st;
+
+	      job->partition = i;
+	      job->size = stat (input_name, &st) == 0 ? st.st_size : 0;
+	      job->argv = dupargv (CONST_CAST (char **, new_argv));
+	    }
 	  else
 	    fork_execute (CONST_CAST (char **, new_argv));
 
 	  output_names[i] = output_name;
 	}
-      if (parallel)
+      if (jobserver)
 	{
 	  struct pex_obj *pex;
-	  char jobs[32];
 
 	  fprintf (mstream, "all:");
 	  for (i = 0; i < nr; ++i)
 	    fprintf (mstream, " \\\n\t%s", output_names[i]);
 	  fprintf (mstream, "\n");
 	  fclose (mstream);
-	  if (!jobserver)
-	    {
-	      /* Avoid passing --jobserver-fd= and similar flags 
-		 unless jobserver mode is explicitly enabled.  */
-	      putenv (xstrdup ("MAKEFLAGS="));
-	      putenv (xstrdup ("MFLAGS="));
-	    }
 	  new_argv[0] = getenv ("MAKE");
 	  if (!new_argv[0])
 	    new_argv[0] = "make";
 	  new_argv[1] = "-f";
 	  new_argv[2] = makefile;
-	  i = 3;
-	  if (!jobserver)
-	    {
-	      snprintf (jobs, 31, "-j%d", parallel);
-	      new_argv[i++] = jobs;
-	    }
-	  new_argv[i++] = "all";
-	  new_argv[i++] = NULL;
-	  pex = collect_execute (CONST_CAST (char **, new_argv));
+	  new_argv[3] = "all";
+	  new_argv[4] = NULL;
+	  pex = collect_execute (CONST_CAST (char **, new_argv), 0);
 	  collect_wait (new_argv[0], pex);
 	  maybe_unlink_file (makefile);
 	  makefile = NULL;
 	}
+      else if (parallel)
+	run_ltrans_jobs (parallel);
+      print_ltrans_outputs ();
       for (i = 0; i < nr; ++i)
-	{
-	  fputs (output_names[i], stdout);
-	  putc ('\n', stdout);
-	  maybe_unlink_file (input_names[i]);
-	  free (input_names[i]);
-	}
+	free (input_names[i]);
+      for (i = 0; i < nr_ltrans_jobs; ++i)
+	freeargv (ltrans_jobs[i].argv);
       nr = 0;
+      nr_printed = 0;
+      nr_ltrans_jobs = 0;
+      free (ltrans_jobs);
+      ltrans_jobs = NULL;
+      free (partition_jobs);
+      partition_jobs = NULL;
       free (output_names);
       free (input_names);
       free (list_option_full);
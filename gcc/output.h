@@ -229,6 +229,9 @@ extern void assemble_align (int);
 /* Assemble a string constant with the specified C string as contents.  */
 extern void assemble_string (const char *, int);
 
+/* Assemble binary data, such as a string constant that is not text.  */
+extern void assemble_bytes (const unsigned char *, unsigned HOST_WIDE_INT);
+
 /* Similar, for calling a library function FUN.  */
 extern void assemble_external_libcall (rtx);
 
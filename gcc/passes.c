@@ -73,6 +73,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "predict.h"
 #include "lto-streamer.h"
 #include "plugin.h"
+#include "arena.h"
 
 #if defined (DWARF2_UNWIND_INFO) || defined (DWARF2_DEBUGGING_INFO)
 #include "dwarf2out.h"
@@ -1492,6 +1493,226 @@ execute_all_ipa_transforms (void)
     }
 }
 
+/* Helper for function_ir_size, called through walk_gimple_seq.  */
+
+static tree
+count_gimple_stmt (gimple_stmt_iterator *gsi ATTRIBUTE_UNUSED,
+		   bool *handled_ops_p ATTRIBUTE_UNUSED,
+		   struct walk_stmt_info *wi)
+{
+  ++*(long *) wi->info;
+  return NULL_TREE;
+}
+
+/* Return the number of statements or insns in the body of cfun, or -1
+   if there is no function or it has no body.  */
+
+static long
+function_ir_size (void)
+{
+  long size = 0;
+
+  if (!cfun)
+    return -1;
+
+  if (cfun->curr_properties & PROP_rtl)
+    {
+      rtx insn;
+
+      for (insn = get_insns (); insn; insn = NEXT_INSN (insn))
+	if (INSN_P (insn))
+	  size++;
+    }
+  else if ((cfun->curr_properties & PROP_cfg) && cfun->cfg)
+    {
+      basic_block bb;
+      gimple_stmt_iterator gsi;
+
+      FOR_EACH_BB (bb)
+	for (gsi = gsi_start_bb (bb); !gsi_end_p (gsi); gsi_next (&gsi))
+	  size++;
+    }
+  else if (cfun->curr_properties & PROP_trees)
+    {
+      struct walk_stmt_info wi;
+
+      memset (&wi, 0, sizeof (wi));
+      wi.info = &size;
+      walk_gimple_seq (gimple_body (current_function_decl),
+		       count_gimple_stmt, NULL, &wi);
+    }
+  else
+    return -1;
+
+  return size;
+}
+
+/* How an expensive pass is degraded on a function that exceeds its
+   compile-time budget.  */
+
+enum budget_action
+{
+  BUDGET_NONE,
+  BUDGET_SKIP,
+  BUDGET_IRA_ONE_REGION,
+  BUDGET_NO_VAR_TRACKING
+};
+
+/* The expensive passes, by name, and what to do with them.  */
+
+static const struct expensive_pass
+{
+  const char *name;
+  enum budget_action action;
+} expensive_passes[] = {
+  { "pre", BUDGET_SKIP },
+  { "sched1", BUDGET_SKIP },
+  { "ira", BUDGET_IRA_ONE_REGION },
+  { "vartrack", BUDGET_NO_VAR_TRACKING }
+};
+
+/* The compile-time budget spent on a function: the run time spent on
+   it before the compiler last started working on it, and whether it has
+   already exceeded its budget.  */
+
+struct function_budget
+{
+  /* The DECL_UID of the function.  */
+  int uid;
+  long time;
+  bool exceeded;
+};
+
+/* The budgets of the functions whose body is still around, keyed by
+   their DECL_UID, so that a budget survives the compiler working on
+   other functions in between.  */
+
+static htab_t function_budgets;
+
+static hashval_t
+function_budget_hash (const void *p)
+{
+  return ((const struct function_budget *) p)->uid;
+}
+
+static int
+function_budget_eq (const void *p1, const void *p2)
+{
+  return (((const struct function_budget *) p1)->uid
+	  == ((const struct function_budget *) p2)->uid);
+}
+
+/* The function whose budget is being spent, its budget and the run
+   time at which the compiler last started working on it.  */
+
+static tree budget_decl;
+static struct function_budget *budget;
+static long budget_start_time;
+
+/* Return what should be done with PASS, which is about to run on cfun,
+   given the compile-time budget of the function.  Give a note if PASS
+   is degraded.  */
+
+static enum budget_action
+function_budget_action (struct opt_pass *pass)
+{
+  int max_time = PARAM_VALUE (PARAM_MAX_FUNCTION_COMPILE_TIME_MS);
+  int max_size = PARAM_VALUE (PARAM_MAX_FUNCTION_BUDGET_SIZE);
+  enum budget_action action = BUDGET_NONE;
+  size_t i;
+
+  if (!max_time && !max_size)
+    return BUDGET_NONE;
+
+  if (budget_decl != current_function_decl)
+    {
+      long now = get_run_time ();
+      struct function_budget key;
+      void **slot;
+
+      if (budget)
+	budget->time += now - budget_start_time;
+      if (!function_budgets)
+	function_budgets = htab_create (37, function_budget_hash,
+					function_budget_eq, free);
+      key.uid = DECL_UID (current_function_decl);
+      slot = htab_find_slot_with_hash (function_budgets, &key, key.uid,
+				       INSERT);
+      if (!*slot)
+	{
+	  *slot = XCNEW (struct function_budget);
+	  ((struct function_budget *) *slot)->uid = key.uid;
+	}
+      budget_decl = current_function_decl;
+      budget = (struct function_budget *) *slot;
+      budget_start_time = now;
+    }
+
+  if (!pass->name)
+    return BUDGET_NONE;
+  for (i = 0; i < ARRAY_SIZE (expensive_passes); i++)
+    if (strcmp (pass->name, expensive_passes[i].name) == 0)
+      {
+	action = expensive_passes[i].action;
+	break;
+      }
+  if (action == BUDGET_NONE)
+    return BUDGET_NONE;
+
+  if (!budget->exceeded)
+    budget->exceeded
+      = ((max_time
+	  && ((budget->time + get_run_time () - budget_start_time) / 1000
+	      > max_time))
+	 || (max_size && function_ir_size () > max_size));
+  if (!budget->exceeded)
+    return BUDGET_NONE;
+
+  switch (action)
+    {
+    case BUDGET_SKIP:
+      inform (DECL_SOURCE_LOCATION (current_function_decl),
+	      "compile-time budget of %qD exceeded, skipping pass %qs",
+	      current_function_decl, pass->name);
+      break;
+
+    case BUDGET_IRA_ONE_REGION:
+      inform (DECL_SOURCE_LOCATION (current_function_decl),
+	      "compile-time budget of %qD exceeded, allocating registers "
+	      "in a single region", current_function_decl);
+      break;
+
+    case BUDGET_NO_VAR_TRACKING:
+      inform (DECL_SOURCE_LOCATION (current_function_decl),
+	      "compile-time budget of %qD exceeded, not tracking variable "
+	      "locations", current_function_decl);
+      break;
+
+    default:
+      gcc_unreachable ();
+    }
+
+  return action;
+}
+
+/* Forget the compile-time budget of DECL, whose body is released.  */
+
+void
+release_function_budget (tree decl)
+{
+  struct function_budget key;
+
+  if (decl == budget_decl)
+    {
+      budget_decl = NULL_TREE;
+      budget = NULL;
+    }
+  if (!function_budgets)
+    return;
+  key.uid = DECL_UID (decl);
+  htab_remove_elt_with_hash (function_budgets, &key, key.uid);
+}
+
 /* Execute PASS. */
 
 bool
@@ -1499,6 +1720,11 @@ execute_one_pass (struct opt_pass *pass)
 {
   bool initializing_dump;
   unsigned int todo_after = 0;
+  struct timevar_time_def profile_start;
+  long size_before = -1;
+  enum budget_action budget_action = BUDGET_NONE;
+  enum ira_region saved_ira_region = flag_ira_region;
+  int saved_var_tracking_assignments = flag_var_tracking_assignments;
 
   bool gate_status;
 
@@ -1524,6 +1750,16 @@ execute_one_pass (struct opt_pass *pass)
       return false;
     }
 
+  /* Expensive passes are degraded on functions that are over their
+     compile-time budget.  */
+  if (cfun)
+    budget_action = function_budget_action (pass);
+  if (budget_action == BUDGET_SKIP)
+    {
+      current_pass = NULL;
+      return false;
+    }
+
   /* Pass execution event trigger: useful to identify passes being
      executed.  */
   invoke_plugin_callbacks (PLUGIN_PASS_EXECUTION, pass);
@@ -1537,6 +1773,12 @@ execute_one_pass (struct opt_pass *pass)
 
   initializing_dump = pass_init_dump_file (pass);
 
+  if (timevar_profile_file)
+    {
+      size_before = function_ir_size ();
+      timevar_get_time (&profile_start);
+    }
+
   /* Run pre-pass verification.  */
   execute_todo (pass->todo_flags_start);
 
@@ -1549,6 +1791,16 @@ execute_one_pass (struct opt_pass *pass)
   if (pass->tv_id != TV_NONE)
     timevar_push (pass->tv_id);
 
+  /* Memory left in the function arenas by another function is dead
+     by now.  */
+  if (cfun)
+    claim_function_arenas (cfun);
+
+  if (budget_action == BUDGET_IRA_ONE_REGION)
+    flag_ira_region = IRA_REGION_ONE;
+  else if (budget_action == BUDGET_NO_VAR_TRACKING)
+    flag_var_tracking_assignments = -1;
+
   /* Do it!  */
   if (pass->execute)
     {
@@ -1556,6 +1808,9 @@ execute_one_pass (struct opt_pass *pass)
       do_per_function (clear_last_verified, NULL);
     }
 
+  flag_ira_region = saved_ira_region;
+  flag_var_tracking_assignments = saved_var_tracking_assignments;
+
   /* Stop timevar.  */
   if (pass->tv_id != TV_NONE)
     timevar_pop (pass->tv_id);
@@ -1577,6 +1832,12 @@ execute_one_pass (struct opt_pass *pass)
   /* Run post-pass cleanup and verification.  */
   execute_todo (todo_after | pass->todo_flags_finish);
   verify_interpass_invariants ();
+
+  if (timevar_profile_file)
+    timevar_record_pass (pass->name,
+			 cfun ? current_function_name () : NULL,
+			 &profile_start, size_before, function_ir_size ());
+
   if (pass->type == IPA_PASS)
     {
       struct cgraph_node *node;
@@ -1592,8 +1853,15 @@ execute_one_pass (struct opt_pass *pass)
   pass_fini_dump_file (pass);
 
   if (pass->type != SIMPLE_IPA_PASS && pass->type != IPA_PASS)
-    gcc_assert (!(cfun->curr_properties & PROP_trees)
-		|| pass->type != RTL_PASS);
+    {
+      gcc_assert (!(cfun->curr_properties & PROP_trees)
+		  || pass->type != RTL_PASS);
+
+      /* Once the body of the function is gone, so are the temporaries
+	 that passes allocated for it.  */
+      if (!(cfun->curr_properties & (PROP_trees | PROP_rtl)))
+	release_function_arenas ();
+    }
 
   current_pass = NULL;
 
@@ -0,0 +1,46 @@
+/* Test that array constants output as runs of bytes have the right
+   contents.  */
+/* { dg-do run } */
+/* { dg-options "-O2 --param min-byte-run-constant-size=16" } */
+
+extern void abort (void);
+
+unsigned char uc[64] = { 1, 2, 255, [40] = 7, [50 ... 55] = 0x80 };
+short s[32] = { -1, 2, -3, [20] = 0x1234 };
+int i[40] = { [1] = -100000, [39] = 0x7fffffff };
+long long ll[8] = { 1LL << 40, -2, [7] = 0x0102030405060708LL };
+float f[8] = { 1.5f, -0.25f, [6] = 3.0e10f };
+double d[8] = { 1.0 / 3, [5] = -2.5e-300 };
+char str[3][16] = { "abc", "\"\\\n\t\001", [2] = "0123456789abcdef" };
+int table[4][8] = { { 1, 2, 3 }, [3] = { [7] = 9 } };
+
+int
+main (void)
+{
+  int k;
+
+  for (k = 0; k < 64; k++)
+    if (uc[k] != (k == 0 ? 1 : k == 1 ? 2 : k == 2 ? 255 : k == 40 ? 7
+		  : k >= 50 && k <= 55 ? 0x80 : 0))
+      abort ();
+  if (s[0] != -1 || s[1] != 2 || s[2] != -3 || s[3] != 0 || s[20] != 0x1234
+      || s[31] != 0)
+    abort ();
+  if (i[0] != 0 || i[1] != -100000 || i[2] != 0 || i[39] != 0x7fffffff)
+    abort ();
+  if (ll[0] != 1LL << 40 || ll[1] != -2 || ll[2] != 0
+      || ll[7] != 0x0102030405060708LL)
+    abort ();
+  if (f[0] != 1.5f || f[1] != -0.25f || f[2] != 0 || f[6] != 3.0e10f)
+    abort ();
+  if (d[0] != 1.0 / 3 || d[1] != 0 || d[5] != -2.5e-300)
+    abort ();
+  if (str[0][0] != 'a' || str[0][3] != 0 || str[1][0] != '"'
+      || str[1][1] != '\\' || str[1][2] != '\n' || str[1][3] != '\t'
+      || str[1][4] != 1 || str[1][5] != 0 || str[2][15] != 'f')
+    abort ();
+  if (table[0][2] != 3 || table[0][3] != 0 || table[1][0] != 0
+      || table[3][7] != 9)
+    abort ();
+  return 0;
+}
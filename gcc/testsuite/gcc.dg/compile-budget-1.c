@@ -0,0 +1,31 @@
+/* Expensive passes are degraded on functions over their budget.  Only
+   PRE and IRA run on every target, so the first scheduling pass is not
+   checked.  */
+/* { dg-do run } */
+/* { dg-options "-O2 --param max-function-budget-size=1" } */
+
+extern void abort (void);
+
+int
+sum (int *a, int n) /* { dg-message "skipping pass .pre." } */
+{
+  int i, s = 0;
+
+  for (i = 0; i < n; i++)
+    s += a[i] * (n > 2 ? a[i] : 1);
+  return s;
+}
+
+int
+main (void) /* { dg-message "skipping pass .pre." } */
+{
+  int a[4] = { 1, 2, 3, 4 };
+
+  if (sum (a, 4) != 30)
+    abort ();
+  return 0;
+}
+
+/* { dg-message "single region" "" { target *-*-* } 10 } */
+/* { dg-message "single region" "" { target *-*-* } 20 } */
+/* { dg-prune-output "skipping pass .sched1." } */
@@ -0,0 +1,45 @@
+/* Test that -fmacro-expansion-cache reuses expansions only while the
+   macros they depend on are unchanged.  */
+
+/* { dg-do run } */
+/* { dg-options "-fmacro-expansion-cache" } */
+
+#include <string.h>
+#include <stdlib.h>
+
+#define STR(x) STR_I(x)
+#define STR_I(x) #x
+#define ID(x) x
+#define CAT(a, b) CAT_I(a, b)
+#define CAT_I(a, b) a ## b
+#define INC(n) CAT(INC_, n)
+#define INC_0 1
+#define INC_1 2
+
+const char *a1 = STR(INC(INC(0)));
+const char *a2 = STR(INC(INC(0)));
+
+#undef INC_1
+#define INC_1 3
+const char *a3 = STR(INC(INC(0)));
+
+#define INC_2 INC(0)
+const char *a4 = STR(ID(INC_2));
+#undef INC_0
+const char *a5 = STR(ID(INC_2));
+
+/* A macro is not expanded inside its own expansion.  */
+#define REC(x) ID(x) REC
+#define CALL(x) ID(REC(x))
+const char *a6 = STR(CALL(1)(2));
+const char *a7 = STR(CALL(1)(2));
+
+int
+main (void)
+{
+  if (strcmp (a1, "2") || strcmp (a2, "2") || strcmp (a3, "3")
+      || strcmp (a4, "1") || strcmp (a5, "INC_0")
+      || strcmp (a6, "1 REC(2)") || strcmp (a7, "1 REC(2)"))
+    abort ();
+  return 0;
+}
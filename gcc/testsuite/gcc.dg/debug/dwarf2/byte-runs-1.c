@@ -0,0 +1,14 @@
+/* Verify that -fdebug-byte-runs outputs the DIEs as byte strings.  */
+
+/* { dg-do compile } */
+/* { dg-options "-O0 -gdwarf-2 -fdebug-byte-runs" } */
+/* { dg-final { scan-assembler "\\.ascii" } } */
+/* { dg-final { scan-assembler-not "\\(abbrev code\\)" } } */
+
+struct s { int i; char *p; } v;
+
+int
+foo (struct s *x)
+{
+  return x->i + v.i;
+}
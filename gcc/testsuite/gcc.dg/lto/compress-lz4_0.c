@@ -0,0 +1,15 @@
+/* { dg-lto-options {{-O2 -flto -flto-partition=1to1 -flto-compression-algorithm=lz4}} } */
+/* { dg-lto-do run } */
+
+extern void abort (void);
+extern int sum (const int *, int);
+
+static const int data[] = { 1, 2, 3, 4, 5, 6, 7, 8, 1, 2, 3, 4, 5, 6, 7, 8 };
+
+int
+main (void)
+{
+  if (sum (data, 16) != 72)
+    abort ();
+  return 0;
+}
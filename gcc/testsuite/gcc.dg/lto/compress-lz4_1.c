@@ -0,0 +1,11 @@
+/* { dg-options "-flto-compression-algorithm=zlib" } */
+
+int
+sum (const int *p, int n)
+{
+  int i, s = 0;
+
+  for (i = 0; i < n; i++)
+    s += p[i];
+  return s;
+}
@@ -0,0 +1,16 @@
+/* Check that a precompiled header built while another one was loaded
+   can be used after it.  */
+/* { dg-options "-I." } */
+#include <layer-1a.h>
+#include "layer-1.h"
+
+#ifndef LAYER_1
+LAYER_1 not defined
+#endif
+
+int
+f (void)
+{
+  struct point p = { 1, 2 };
+  return scaled (p);
+}
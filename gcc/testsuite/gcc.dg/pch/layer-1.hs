@@ -0,0 +1,4 @@
+/* { dg-options "-I." } */
+#include <layer-1a.h>
+static inline int scaled (struct point p) { return SCALE * norm1 (p); }
+#define LAYER_1
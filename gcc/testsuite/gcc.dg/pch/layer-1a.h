@@ -0,0 +1,7 @@
+/* The header layer-1.hs is precompiled on top of.  */
+#ifndef LAYER_1A_H
+#define LAYER_1A_H
+struct point { int x, y; };
+static inline int norm1 (struct point p) { return p.x + p.y; }
+#define SCALE 3
+#endif
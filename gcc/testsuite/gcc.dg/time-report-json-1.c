@@ -0,0 +1,18 @@
+/* Check the per-pass profile written by -ftime-report-format=json.  */
+/* { dg-do compile } */
+/* { dg-options "-O2 -ftime-report -ftime-report-format=json" } */
+
+int
+f (int *p, int n)
+{
+  int i, s = 0;
+  for (i = 0; i < n; i++)
+    s += p[i];
+  return s;
+}
+
+/* { dg-final { scan-file time-report-json-1.time.json "^\{\n  \"passes\": \\\[" } } */
+/* { dg-final { scan-file time-report-json-1.time.json "\{ \"pass\": \"optimized\", \"function\": \"f\", \"user\": \[0-9.\]+, \"sys\": \[0-9.\]+, \"wall\": \[0-9.\]+, \"ggc\": \[0-9\]+, \"size_before\": \[0-9\]+, \"size_after\": \[0-9\]+ \}" } } */
+/* { dg-final { scan-file time-report-json-1.time.json "\"function\": null" } } */
+/* { dg-final { scan-file time-report-json-1.time.json "\"total\": \{ \"user\": \[0-9.\]+, \"sys\": \[0-9.\]+, \"wall\": \[0-9.\]+, \"ggc\": \[0-9\]+ \}\n\}\n$" } } */
+/* { dg-final { remove-build-file "time-report-json-1.time.json" } } */
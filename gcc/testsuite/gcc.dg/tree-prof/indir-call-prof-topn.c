@@ -0,0 +1,47 @@
+/* { dg-options "-O2 -fdump-tree-optimized -fdump-ipa-tree_profile_ipa" } */
+
+extern void abort (void);
+
+static int a1 (void)
+{
+    return 10;
+}
+
+static int a2 (void)
+{
+    return 0;
+}
+
+static int a3 (void)
+{
+    return 3;
+}
+
+typedef int (*tp) (void);
+
+static tp aa [] = {a1, a2, a3};
+
+int
+main (void)
+{
+  int (*p) (void);
+  int i, s = 0;
+
+  /* a1 is called 60% of the time, a2 30% and a3 10%.  */
+  for (i = 0; i < 100; i ++)
+    {
+	p = aa [i % 10 < 6 ? 0 : i % 10 < 9 ? 1 : 2];
+	s += p ();
+    }
+
+  if (s != 60 * 10 + 10 * 3)
+    abort ();
+  return 0;
+}
+
+/* { dg-final-use { scan-ipa-dump "Indirect call -> direct call.* a1 transformation on insn" "tree_profile_ipa"} } */
+/* { dg-final-use { scan-ipa-dump "Indirect call -> direct call.* a2 transformation on insn" "tree_profile_ipa"} } */
+/* { dg-final-use { scan-ipa-dump-not "Indirect call -> direct call.* a3 transformation on insn" "tree_profile_ipa"} } */
+/* { dg-final-use { scan-tree-dump-not "Invalid sum" "optimized"} } */
+/* { dg-final-use { cleanup-tree-dump "optimized" } } */
+/* { dg-final-use { cleanup-ipa-dump "tree_profile_ipa" } } */
@@ -0,0 +1,36 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -ftree-loop-if-convert-stores -fdump-tree-ifcvt-details" } */
+
+/* The loads from s.m are within bounds only when the offset of m is
+   known: they are not if-converted after a variable length member.  */
+
+int
+f (int *c, int k)
+{
+  struct { int n[k]; int m[64]; } s;
+  int i, sum = 0;
+
+  for (i = 0; i < 64; i++)
+    s.m[i] = i;
+  for (i = 0; i < 64; i++)
+    if (c[i])
+      sum += s.m[i];
+  return sum;
+}
+
+int
+g (int *c)
+{
+  struct { int n[4]; int m[64]; } s;
+  int i, sum = 0;
+
+  for (i = 0; i < 64; i++)
+    s.m[i] = i;
+  for (i = 0; i < 64; i++)
+    if (c[i])
+      sum += s.m[i];
+  return sum;
+}
+
+/* { dg-final { scan-tree-dump-times "Applying if-conversion" 1 "ifcvt" } } */
+/* { dg-final { cleanup-tree-dump "ifcvt" } } */
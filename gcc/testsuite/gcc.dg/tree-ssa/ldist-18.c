@@ -0,0 +1,57 @@
+/* { dg-do compile } */
+/* { dg-options "-O3 -fdump-tree-ldist-details" } */
+
+int a[1000], b[1000], c[1000];
+struct S { int x, y; } sa[1000], sb[1000];
+
+void copy (int n)
+{
+  int i;
+
+  for (i = 0; i < n; ++i)
+    b[i] = c[i];
+}
+
+void copy_struct (int n)
+{
+  int i;
+
+  for (i = 0; i < n; ++i)
+    sa[i] = sb[i];
+}
+
+void move_down (int n)
+{
+  int i;
+
+  for (i = 0; i < n; ++i)
+    a[i] = a[i + 1];
+}
+
+void propagate (int n)
+{
+  int i;
+
+  /* Each iteration reads what the previous one stored: not a memmove.  */
+  for (i = 0; i < n; ++i)
+    a[i + 1] = a[i];
+}
+
+unsigned int copy_and_hash (int n)
+{
+  int i;
+  unsigned int h = 0;
+
+  for (i = 0; i < n; ++i)
+    {
+      b[i] = c[i];
+      h = h * 31 + i;
+    }
+
+  return h;
+}
+
+/* { dg-final { scan-tree-dump-times "generated memcpy" 3 "ldist" } } */
+/* { dg-final { scan-tree-dump-times "generated memmove" 1 "ldist" } } */
+/* { dg-final { scan-tree-dump-times "distributed: split to 2" 1 "ldist" } } */
+/* { dg-final { cleanup-tree-dump "ldist" } } */
@@ -0,0 +1,69 @@
+/* { dg-do run } */
+/* { dg-options "-O3" } */
+
+extern void abort (void);
+
+#define N 64
+
+int a[N + 2], b[N], c[N];
+
+void __attribute__((noinline))
+move_down (int n)
+{
+  int i;
+
+  for (i = 0; i < n; ++i)
+    a[i] = a[i + 2];
+}
+
+void __attribute__((noinline))
+propagate (int n)
+{
+  int i;
+
+  for (i = 0; i < n; ++i)
+    a[i + 1] = a[i];
+}
+
+int __attribute__((noinline))
+copy_and_sum (int n)
+{
+  int i, s = 0;
+
+  for (i = 0; i < n; ++i)
+    {
+      int t = c[i];
+      b[i] = t;
+      s += t;
+    }
+
+  return s;
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < N + 2; ++i)
+    a[i] = i;
+  move_down (N);
+  for (i = 0; i < N; ++i)
+    if (a[i] != i + 2)
+      abort ();
+
+  propagate (N);
+  for (i = 0; i < N + 1; ++i)
+    if (a[i] != 2)
+      abort ();
+
+  for (i = 0; i < N; ++i)
+    c[i] = i;
+  if (copy_and_sum (N) != N * (N - 1) / 2)
+    abort ();
+  for (i = 0; i < N; ++i)
+    if (b[i] != i)
+      abort ();
+
+  return 0;
+}
@@ -0,0 +1,47 @@
+/* { dg-do compile } */
+/* { dg-options "-O3 -fdump-tree-ldist-details" } */
+
+typedef __SIZE_TYPE__ size_t;
+
+/* The loops below implement the builtins themselves: replacing them by
+   calls to these builtins would make the functions call themselves.  */
+
+void *
+memset (void *s, int c, size_t n)
+{
+  char *p = (char *) s;
+  size_t i;
+
+  for (i = 0; i < n; ++i)
+    p[i] = 0;
+  return s;
+}
+
+void *
+memcpy (void *__restrict d, const void *__restrict s, size_t n)
+{
+  char *p = (char *) d;
+  const char *q = (const char *) s;
+  size_t i;
+
+  for (i = 0; i < n; ++i)
+    p[i] = q[i];
+  return d;
+}
+
+void *
+memmove (void *d, const void *s, size_t n)
+{
+  char *p = (char *) d;
+  const char *q = (const char *) s;
+  size_t i;
+
+  for (i = 0; i < n; ++i)
+    p[i] = q[i];
+  return d;
+}
+
+/* { dg-final { scan-tree-dump-not "generated memset" "ldist" } } */
+/* { dg-final { scan-tree-dump-not "generated memcpy" "ldist" } } */
+/* { dg-final { scan-tree-dump-not "generated memmove" "ldist" } } */
+/* { dg-final { cleanup-tree-dump "ldist" } } */
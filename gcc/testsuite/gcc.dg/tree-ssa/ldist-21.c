@@ -0,0 +1,38 @@
+/* { dg-do compile } */
+/* { dg-options "-O3 -fdump-tree-ldist-details" } */
+
+typedef __SIZE_TYPE__ size_t;
+
+/* These functions are defined under other names, but are the builtins
+   themselves once renamed by their asm labels.  */
+
+void *impl_memset (void *, int, size_t) __asm__ ("memset");
+void *impl_memcpy (void *__restrict, const void *__restrict, size_t)
+  __asm__ ("memcpy");
+
+void *
+impl_memset (void *s, int c, size_t n)
+{
+  char *p = (char *) s;
+  size_t i;
+
+  for (i = 0; i < n; ++i)
+    p[i] = 0;
+  return s;
+}
+
+void *
+impl_memcpy (void *__restrict d, const void *__restrict s, size_t n)
+{
+  char *p = (char *) d;
+  const char *q = (const char *) s;
+  size_t i;
+
+  for (i = 0; i < n; ++i)
+    p[i] = q[i];
+  return d;
+}
+
+/* { dg-final { scan-tree-dump-not "generated memset" "ldist" } } */
+/* { dg-final { scan-tree-dump-not "generated memcpy" "ldist" } } */
+/* { dg-final { cleanup-tree-dump "ldist" } } */
@@ -0,0 +1,49 @@
+/* { dg-require-effective-target vect_float } */
+/* { dg-require-effective-target vect_condition } */
+
+#include <stdarg.h>
+#include "tree-vect.h"
+
+#define N 64
+
+float a[N], b[N];
+
+/* The store to a[i] is conditional, but a[i] is within the bounds of a
+   writable array for every iteration, so it can be replaced by an
+   unconditional store of a selected value.  */
+
+__attribute__ ((noinline)) void
+foo (void)
+{
+  int i;
+
+  for (i = 0; i < N; i++)
+    if (b[i] > 0)
+      a[i] = b[i];
+}
+
+int
+main (void)
+{
+  int i;
+
+  check_vect ();
+
+  for (i = 0; i < N; i++)
+    {
+      a[i] = -1;
+      b[i] = (i & 1) ? i : -i;
+      __asm__ volatile ("");
+    }
+
+  foo ();
+
+  for (i = 0; i < N; i++)
+    if (a[i] != ((i & 1) ? i : -1))
+      abort ();
+
+  return 0;
+}
+
+/* { dg-final { scan-tree-dump-times "vectorized 1 loops" 1 "vect" } } */
+/* { dg-final { cleanup-tree-dump "vect" } } */
@@ -0,0 +1,83 @@
+/* { dg-require-effective-target vect_gather } */
+/* { dg-require-effective-target vect_float } */
+
+#include <stdarg.h>
+#include "tree-vect.h"
+
+#define N 64
+
+float fa[N * 2];
+float fb[N];
+int ia[N * 2 + 1];
+int ib[N];
+int idx[N];
+unsigned char cidx[N];
+
+__attribute__ ((noinline)) void
+foo (void)
+{
+  int i;
+
+  /* Gather of float indexed by int.  */
+  for (i = 0; i < N; i++)
+    fb[i] = fa[idx[i]] + 1.0f;
+
+  /* Gather with a scaled and offset index.  */
+  for (i = 0; i < N; i++)
+    ib[i] = ia[2 * idx[i] + 1];
+}
+
+__attribute__ ((noinline)) int
+bar (void)
+{
+  int i, sum = 0;
+
+  /* Gather indexed by unsigned char.  */
+  for (i = 0; i < N; i++)
+    sum += ia[cidx[i]];
+
+  return sum;
+}
+
+int
+main (void)
+{
+  int i, sum = 0;
+
+  check_vect ();
+
+  for (i = 0; i < N * 2; i++)
+    {
+      fa[i] = i * 3;
+      ia[i] = i * 5;
+      __asm__ volatile ("");
+    }
+  ia[N * 2] = 7;
+
+  for (i = 0; i < N; i++)
+    {
+      idx[i] = (i * 7) % N;
+      cidx[i] = (i * 11) % (N * 2);
+      __asm__ volatile ("");
+    }
+
+  foo ();
+
+  for (i = 0; i < N; i++)
+    {
+      if (fb[i] != fa[idx[i]] + 1.0f
+	  || ib[i] != ia[2 * idx[i] + 1])
+	abort ();
+      sum += ia[cidx[i]];
+    }
+
+  if (bar () != sum)
+    abort ();
+
+  return 0;
+}
+
+/* { dg-final { scan-tree-dump-times "vectorized 2 loops" 1 "vect" } } */
+/* { dg-final { scan-tree-dump-times "vectorized 1 loops" 1 "vect" } } */
+/* { dg-final { scan-tree-dump "gather load with offset" "vect" } } */
+/* { dg-final { cleanup-tree-dump "vect" } } */
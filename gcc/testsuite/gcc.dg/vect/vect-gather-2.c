@@ -0,0 +1,31 @@
+/* { dg-do compile } */
+/* { dg-require-effective-target vect_gather } */
+
+#define N 256
+
+/* The gathered loads cannot alias the store through the restrict
+   pointer, so the loop is vectorized.  */
+
+void
+foo (int *__restrict p, int *__restrict q, int *__restrict idx)
+{
+  int i;
+
+  for (i = 0; i < N; i++)
+    p[i] = q[idx[i]];
+}
+
+/* Here the store may clobber elements the later iterations gather.  */
+
+void
+bar (int *p, int *q, int *idx)
+{
+  int i;
+
+  for (i = 0; i < N; i++)
+    p[i] = q[idx[i]];
+}
+
+/* { dg-final { scan-tree-dump-times "vectorized 1 loops" 1 "vect" } } */
+/* { dg-final { scan-tree-dump "possible dependence with gather" "vect" } } */
+/* { dg-final { cleanup-tree-dump "vect" } } */
@@ -0,0 +1,81 @@
+/* { dg-require-effective-target vect_int } */
+
+#include <stdarg.h>
+#include "tree-vect.h"
+
+#define N 64
+
+int A[3 * N + 8], B[3 * N + 8];
+
+/* The reads from IN have the same base and step, so a single check of
+   the segment they cover together is needed against OUT.  */
+
+__attribute__ ((noinline)) void
+foo (int *out, int *in)
+{
+  int i;
+
+  for (i = 0; i < N; i++)
+    out[i] = in[i] + in[i + 1] + in[i + 2] + in[i + 3] + in[i + 4] + in[i + 5];
+}
+
+__attribute__ ((noinline)) void
+init (void)
+{
+  int i;
+
+  for (i = 0; i < 3 * N + 8; i++)
+    {
+      A[i] = B[i] = i * 3;
+      __asm__ volatile ("");
+    }
+}
+
+/* Compute the expected results in B.  */
+
+__attribute__ ((noinline)) void
+check (int *out, int *in)
+{
+  int i, j, s;
+
+  for (i = 0; i < N; i++)
+    {
+      s = 0;
+      for (j = 0; j < 6; j++)
+	{
+	  s += in[i + j];
+	  __asm__ volatile ("");
+	}
+      out[i] = s;
+    }
+
+  for (i = 0; i < 3 * N + 8; i++)
+    if (A[i] != B[i])
+      abort ();
+}
+
+int
+main (void)
+{
+  int d;
+
+  check_vect ();
+
+  /* Overlapping and disjoint segments.  */
+  for (d = -8; d <= 8; d++)
+    {
+      init ();
+      foo (A + N + d, A + N);
+      check (B + N + d, B + N);
+    }
+
+  init ();
+  foo (A, A + 2 * N);
+  check (B, B + 2 * N);
+
+  return 0;
+}
+
+/* { dg-final { scan-tree-dump-times "vectorized 1 loops" 1 "vect" } } */
+/* { dg-final { scan-tree-dump-times "improved number of alias checks from 6 to 1" 1 "vect" } } */
+/* { dg-final { cleanup-tree-dump "vect" } } */
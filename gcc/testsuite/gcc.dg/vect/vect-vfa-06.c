@@ -0,0 +1,24 @@
+/* { dg-do compile } */
+/* { dg-require-effective-target vect_int } */
+
+#define N 128
+
+/* Pairwise, the accesses need 15 run-time alias checks, more than
+   allowed by --param vect-max-version-for-alias-checks.  Merging the
+   accesses to A and to B leaves 5 checks.  */
+
+void
+foo (int *o1, int *o2, int *a, int *b)
+{
+  int i;
+
+  for (i = 0; i < N; i++)
+    {
+      o1[i] = a[i] + a[i + 1] + b[i] + b[i + 1] + b[i + 2];
+      o2[i] = a[i] - a[i + 2] - b[i] + b[i + 3];
+    }
+}
+
+/* { dg-final { scan-tree-dump-times "vectorized 1 loops" 1 "vect" } } */
+/* { dg-final { scan-tree-dump-times "improved number of alias checks from 15 to 5" 1 "vect" } } */
+/* { dg-final { cleanup-tree-dump "vect" } } */
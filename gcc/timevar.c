@@ -109,6 +109,15 @@ bool timevar_enable;
 
 size_t timevar_ggc_mem_total;
 
+/* If nonnull, every pass executed is recorded in this file, in JSON
+   format.  */
+
+FILE *timevar_profile_file;
+
+/* Nonzero if no pass has been recorded in timevar_profile_file yet.  */
+
+static bool profile_empty;
+
 /* The amount of memory that will cause us to report the timevar even
    if the time spent is not significant.  */
 
@@ -366,6 +375,134 @@ timevar_stop (timevar_id_t timevar)
   timevar_accumulate (&tv->elapsed, &tv->start_time, &now);
 }
 
+/* Write STR to FP as a JSON string, or null if STR is null.  */
+
+static void
+print_json_string (FILE *fp, const char *str)
+{
+  if (!str)
+    {
+      fputs ("null", fp);
+      return;
+    }
+
+  putc ('"', fp);
+  for (; *str; str++)
+    {
+      unsigned char c = *str;
+
+      if (c == '"' || c == '\\')
+	fprintf (fp, "\\%c", c);
+      else if (c < 0x20)
+	fprintf (fp, "\\u%04x", c);
+      else
+	putc (c, fp);
+    }
+  putc ('"', fp);
+}
+
+/* Write the times in TIME to FP as members of a JSON object.  */
+
+static void
+print_json_times (FILE *fp, const struct timevar_time_def *time)
+{
+  fprintf (fp, "\"user\": %.6f, \"sys\": %.6f, \"wall\": %.6f, "
+	   "\"ggc\": %u", time->user, time->sys, time->wall, time->ggc_mem);
+}
+
+/* Start recording a profile of every pass to FP.  The file is
+   completed and closed by timevar_print.  */
+
+void
+timevar_open_profile (FILE *fp)
+{
+  timevar_profile_file = fp;
+  profile_empty = true;
+  fputs ("{\n  \"passes\": [", fp);
+}
+
+/* Fill the current times into NOW, for a later call to
+   timevar_record_pass.  */
+
+void
+timevar_get_time (struct timevar_time_def *now)
+{
+  get_time (now);
+}
+
+/* Record in the profile that pass PASS, run on FUNCTION (null for an
+   interprocedural pass), started at START and changed the size of the
+   function from SIZE_BEFORE to SIZE_AFTER statements or insns.  A
+   negative size means it is unknown.  */
+
+void
+timevar_record_pass (const char *pass, const char *function,
+		     const struct timevar_time_def *start,
+		     long size_before, long size_after)
+{
+  FILE *fp = timevar_profile_file;
+  struct timevar_time_def now, elapsed;
+
+  get_time (&now);
+  memset (&elapsed, 0, sizeof (elapsed));
+  timevar_accumulate (&elapsed, CONST_CAST (struct timevar_time_def *, start),
+		      &now);
+
+  fputs (profile_empty ? "\n    { " : ",\n    { ", fp);
+  profile_empty = false;
+  fputs ("\"pass\": ", fp);
+  print_json_string (fp, pass);
+  fputs (", \"function\": ", fp);
+  print_json_string (fp, function);
+  fputs (", ", fp);
+  print_json_times (fp, &elapsed);
+  if (size_before >= 0)
+    fprintf (fp, ", \"size_before\": %ld", size_before);
+  else
+    fputs (", \"size_before\": null", fp);
+  if (size_after >= 0)
+    fprintf (fp, ", \"size_after\": %ld", size_after);
+  else
+    fputs (", \"size_after\": null", fp);
+  fputs (" }", fp);
+
+  /* Keep the records written so far if the compiler crashes.  */
+  fflush (fp);
+}
+
+/* Complete the profile with the totals of all timing variables and
+   close it.  */
+
+static void
+timevar_close_profile (void)
+{
+  FILE *fp = timevar_profile_file;
+  unsigned int /* timevar_id_t */ id;
+  bool first = true;
+
+  fputs ("\n  ],\n  \"timevars\": [", fp);
+  for (id = 0; id < (unsigned int) TIMEVAR_LAST; ++id)
+    {
+      struct timevar_def *tv = &timevars[(timevar_id_t) id];
+
+      if (!tv->used || (timevar_id_t) id == TV_TOTAL)
+	continue;
+
+      fputs (first ? "\n    { \"name\": " : ",\n    { \"name\": ", fp);
+      first = false;
+      print_json_string (fp, tv->name);
+      fputs (", ", fp);
+      print_json_times (fp, &tv->elapsed);
+      fputs (" }", fp);
+    }
+  fputs ("\n  ],\n  \"total\": { ", fp);
+  print_json_times (fp, &timevars[TV_TOTAL].elapsed);
+  fputs (" }\n}\n", fp);
+
+  fclose (fp);
+  timevar_profile_file = NULL;
+}
+
 /* Summarize timing variables to FP.  The timing variable TV_TOTAL has
    a special meaning -- it's considered to be the total elapsed time,
    for normalizing the others, and is displayed last.  */
@@ -399,6 +536,13 @@ timevar_print (FILE *fp)
      TIMEVAR.  */
   start_time = now;
 
+  /* The JSON profile replaces the table.  */
+  if (timevar_profile_file)
+    {
+      timevar_close_profile ();
+      return;
+    }
+
   fputs ("\nExecution times (seconds)\n", fp);
   for (id = 0; id < (unsigned int) TIMEVAR_LAST; ++id)
     {
@@ -87,6 +87,10 @@ extern bool timevar_enable;
 /* Total amount of memory allocated by garbage collector.  */
 extern size_t timevar_ggc_mem_total;
 
+/* If nonnull, every pass executed is recorded in this file, in JSON
+   format.  */
+extern FILE *timevar_profile_file;
+
 /* Execute the sequence: timevar_pop (TV), return (E);  */
 #define POP_TIMEVAR_AND_RETURN(TV, E)  do { timevar_pop (TV); return (E); }while(0)
 
@@ -96,6 +100,11 @@ extern void timevar_pop_1 (timevar_id_t);
 extern void timevar_start (timevar_id_t);
 extern void timevar_stop (timevar_id_t);
 extern void timevar_print (FILE *);
+extern void timevar_open_profile (FILE *);
+extern void timevar_get_time (struct timevar_time_def *);
+extern void timevar_record_pass (const char *, const char *,
+				 const struct timevar_time_def *,
+				 long, long);
 
 /* Provided for backward compatibility.  */
 static inline void
@@ -72,6 +72,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "coverage.h"
 #include "value-prof.h"
 #include "alloc-pool.h"
+#include "arena.h"
 #include "tree-mudflap.h"
 #include "tree-pass.h"
 #include "gimple.h"
@@ -1824,6 +1825,7 @@ dump_memory_report (bool final)
   dump_gimple_statistics ();
   dump_rtx_statistics ();
   dump_alloc_pool_statistics ();
+  dump_function_arena_statistics ();
   dump_bitmap_statistics ();
   dump_vec_loc_statistics ();
   dump_ggc_loc_statistics (final);
@@ -1868,6 +1870,18 @@ finalize (bool no_backend)
       ira_finish_once ();
     }
 
+  /* Dump the statistics of the garbage collector.  */
+  {
+    int flags;
+    FILE *stream = dump_begin (TDI_ggc, &flags);
+
+    if (stream)
+      {
+	ggc_dump_statistics (stream);
+	dump_end (TDI_ggc, stream);
+      }
+  }
+
   if (mem_report)
     dump_memory_report (true);
 
@@ -1887,6 +1901,11 @@ do_compile (void)
 
   process_options ();
 
+  /* The per-pass profile is named after the auxiliary output files,
+     which process_options sets up.  */
+  if (time_report && flag_time_report_format == TIME_REPORT_FORMAT_JSON)
+    timevar_open_profile (open_auxiliary_file ("time.json"));
+
   /* Don't do any more if an error has already occurred.  */
   if (!seen_error ())
     {
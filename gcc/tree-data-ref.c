@@ -5192,11 +5192,69 @@ stmt_with_adjacent_zero_store_dr_p (gimple stmt)
   return res;
 }
 
+/* Returns true when the statement at STMT is of the form "A[i] = B[i]":
+   an aggregate copy, or a store of a value loaded in the same basic
+   block, where both data references have the same stride, of the size
+   of their unit type.  */
+
+bool
+stmt_with_adjacent_copy_dr_p (gimple stmt)
+{
+  tree op0, op1, val;
+  gimple load;
+  bool res;
+  struct data_reference *dst, *src;
+
+  if (!stmt
+      || !gimple_vdef (stmt)
+      || !is_gimple_assign (stmt)
+      || !gimple_assign_single_p (stmt)
+      || gimple_has_volatile_ops (stmt))
+    return false;
+
+  val = gimple_assign_rhs1 (stmt);
+  if (REFERENCE_CLASS_P (val))
+    load = stmt;
+  else if (TREE_CODE (val) == SSA_NAME)
+    load = SSA_NAME_DEF_STMT (val);
+  else
+    return false;
+
+  if (!is_gimple_assign (load)
+      || !gimple_assign_single_p (load)
+      || !gimple_vuse (load)
+      || gimple_has_volatile_ops (load)
+      || gimple_bb (load) != gimple_bb (stmt))
+    return false;
+
+  op0 = gimple_assign_lhs (stmt);
+  op1 = gimple_assign_rhs1 (load);
+  if (!tree_int_cst_equal (TYPE_SIZE_UNIT (TREE_TYPE (op0)),
+			   TYPE_SIZE_UNIT (TREE_TYPE (op1))))
+    return false;
+
+  dst = XCNEW (struct data_reference);
+  DR_STMT (dst) = stmt;
+  DR_REF (dst) = op0;
+  src = XCNEW (struct data_reference);
+  DR_STMT (src) = load;
+  DR_REF (src) = op1;
+
+  res = dr_analyze_innermost (dst)
+    && dr_analyze_innermost (src)
+    && stride_of_unit_type_p (DR_STEP (dst), TREE_TYPE (op0))
+    && operand_equal_p (DR_STEP (dst), DR_STEP (src), 0);
+
+  free_data_ref (dst);
+  free_data_ref (src);
+  return res;
+}
+
 /* Initialize STMTS with all the statements of LOOP that contain a
-   store to memory of the form "A[i] = 0".  */
+   store to memory of the form "A[i] = 0" or "A[i] = B[i]".  */
 
 void
-stores_zero_from_loop (struct loop *loop, VEC (gimple, heap) **stmts)
+stores_builtin_from_loop (struct loop *loop, VEC (gimple, heap) **stmts)
 {
   unsigned int i;
   basic_block bb;
@@ -5207,7 +5265,8 @@ stores_zero_from_loop (struct loop *loop, VEC (gimple, heap) **stmts)
   for (i = 0; i < loop->num_nodes; i++)
     for (bb = bbs[i], si = gsi_start_bb (bb); !gsi_end_p (si); gsi_next (&si))
       if ((stmt = gsi_stmt (si))
-	  && stmt_with_adjacent_zero_store_dr_p (stmt))
+	  && (stmt_with_adjacent_zero_store_dr_p (stmt)
+	      || stmt_with_adjacent_copy_dr_p (stmt)))
 	VEC_safe_push (gimple, heap, *stmts, gsi_stmt (si));
 
   free (bbs);
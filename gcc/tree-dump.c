@@ -781,6 +781,7 @@ static struct dump_file_info dump_files[TDI_end] =
   {".nested", "tree-nested", NULL, TDF_TREE, 0, 5},
   {".vcg", "tree-vcg", NULL, TDF_TREE, 0, 6},
   {".ads", "ada-spec", NULL, 0, 0, 7},
+  {".ggc", "ggc", NULL, 0, 0, -1},
 #define FIRST_AUTO_NUMBERED_DUMP 8
 
   {NULL, "tree-all", NULL, TDF_TREE, 0, 0},
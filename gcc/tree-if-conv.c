@@ -461,12 +461,101 @@ struct ifc_dr {
 #define DR_WRITTEN_AT_LEAST_ONCE(DR) (IFC_DR (DR)->written_at_least_once)
 #define DR_RW_UNCONDITIONALLY(DR) (IFC_DR (DR)->rw_unconditionally)
 
+/* Returns true when REF, a memory reference in LOOP, stays within the
+   bounds of a declared object on every iteration of LOOP: REF is made of
+   components at constant offsets and array references into a VAR_DECL,
+   and the index of each array reference is a constant or an affine
+   function of the iteration of LOOP, whose number of iterations is a
+   known constant, that stays within the bounds of the array.  */
+
+static bool
+ifcvt_ref_within_array_bounds (struct loop *loop, tree ref)
+{
+  tree niter = number_of_latch_executions (loop);
+
+  if (!host_integerp (niter, 0))
+    return false;
+
+  for (; handled_component_p (ref); ref = TREE_OPERAND (ref, 0))
+    {
+      tree idx, low, up, ev, base, step;
+      double_int first, last;
+
+      switch (TREE_CODE (ref))
+	{
+	case ARRAY_REF:
+	  break;
+
+	case COMPONENT_REF:
+	  if (TREE_CODE (component_ref_field_offset (ref)) != INTEGER_CST)
+	    return false;
+	  continue;
+
+	case BIT_FIELD_REF:
+	case REALPART_EXPR:
+	case IMAGPART_EXPR:
+	  continue;
+
+	default:
+	  /* ARRAY_RANGE_REFs, and VIEW_CONVERT_EXPRs that may access more
+	     than the object.  */
+	  return false;
+	}
+
+      idx = TREE_OPERAND (ref, 1);
+      low = array_ref_low_bound (ref);
+      up = array_ref_up_bound (ref);
+      if (!up
+	  || TREE_CODE (low) != INTEGER_CST
+	  || TREE_CODE (up) != INTEGER_CST)
+	return false;
+
+      if (TREE_CODE (idx) == SSA_NAME)
+	ev = instantiate_scev (loop_preheader_edge (loop)->src, loop,
+			       analyze_scalar_evolution (loop, idx));
+      else
+	ev = idx;
+
+      if (TREE_CODE (ev) == INTEGER_CST)
+	{
+	  base = ev;
+	  step = integer_zero_node;
+	}
+      else if (TREE_CODE (ev) == POLYNOMIAL_CHREC
+	       && CHREC_VARIABLE (ev) == (unsigned) loop->num
+	       && TREE_CODE (CHREC_LEFT (ev)) == INTEGER_CST
+	       && TREE_CODE (CHREC_RIGHT (ev)) == INTEGER_CST)
+	{
+	  base = CHREC_LEFT (ev);
+	  step = CHREC_RIGHT (ev);
+	}
+      else
+	return false;
+
+      /* The index is affine, so its extreme values are taken on the first
+	 and on the last iteration.  */
+      first = tree_to_double_int (base);
+      last = double_int_add (first,
+			     double_int_mul (tree_to_double_int (step),
+					     tree_to_double_int (niter)));
+      if (double_int_scmp (first, tree_to_double_int (low)) < 0
+	  || double_int_scmp (last, tree_to_double_int (low)) < 0
+	  || double_int_scmp (first, tree_to_double_int (up)) > 0
+	  || double_int_scmp (last, tree_to_double_int (up)) > 0)
+	return false;
+    }
+
+  return TREE_CODE (ref) == VAR_DECL;
+}
+
 /* Returns true when the memory references of STMT are read or written
    unconditionally.  In other words, this function returns true when
    for every data reference A in STMT there exist other accesses to
    a data reference with the same base with predicates that add up (OR-up) to
    the true predicate: this ensures that the data reference A is touched
-   (read or written) on every iteration of the if-converted loop.  */
+   (read or written) on every iteration of the if-converted loop.  A data
+   reference that provably stays within the bounds of a declared array
+   need not be touched: it is valid on every iteration anyway.  */
 
 static bool
 memrefs_read_or_written_unconditionally (gimple stmt,
@@ -488,6 +577,10 @@ memrefs_read_or_written_unconditionally (gimple stmt,
 	if (x == 1)
 	  continue;
 
+	if (ifcvt_ref_within_array_bounds (loop_containing_stmt (stmt),
+					   DR_REF (a)))
+	  continue;
+
 	for (j = 0; VEC_iterate (data_reference_p, drs, j, b); j++)
           {
             tree ref_base_a = DR_REF (a);
@@ -506,7 +599,7 @@ memrefs_read_or_written_unconditionally (gimple stmt,
                    || TREE_CODE (ref_base_b) == REALPART_EXPR)
               ref_base_b = TREE_OPERAND (ref_base_b, 0);
 
-  	    if (!operand_equal_p (ref_base_a, ref_base_b, 0))
+  	    if (operand_equal_p (ref_base_a, ref_base_b, 0))
 	      {
 	        tree cb = bb_predicate (gimple_bb (DR_STMT (b)));
 
@@ -533,12 +626,27 @@ memrefs_read_or_written_unconditionally (gimple stmt,
   return true;
 }
 
+/* Returns true when REF is a reference into a declared variable that
+   is not read-only, which can therefore be written to.  */
+
+static bool
+ifcvt_base_object_writable_p (tree ref)
+{
+  tree base = get_base_address (ref);
+
+  return (base
+	  && TREE_CODE (base) == VAR_DECL
+	  && !TREE_READONLY (base));
+}
+
 /* Returns true when the memory references of STMT are unconditionally
    written.  In other words, this function returns true when for every
    data reference A written in STMT, there exist other writes to the
    same data reference with predicates that add up (OR-up) to the true
    predicate: this ensures that the data reference A is written on
-   every iteration of the if-converted loop.  */
+   every iteration of the if-converted loop.  A data reference into a
+   variable that is not read-only need not be written elsewhere: the
+   memory it refers to is writable anyway.  */
 
 static bool
 write_memrefs_written_at_least_once (gimple stmt,
@@ -561,6 +669,9 @@ write_memrefs_written_at_least_once (gimple stmt,
 	if (x == 1)
 	  continue;
 
+	if (ifcvt_base_object_writable_p (DR_REF (a)))
+	  continue;
+
 	for (j = 0; VEC_iterate (data_reference_p, drs, j, b); j++)
 	  if (DR_STMT (b) != stmt
 	      && DR_IS_WRITE (b)
@@ -599,14 +710,15 @@ write_memrefs_written_at_least_once (gimple stmt,
    into "A[i] = cond ? foo : A[i]", and as the write to memory may not
    be executed at all in the original code, it may be a readonly
    memory.  To check that A is not const-qualified, we check that
-   there exists at least an unconditional write to A in the current
-   function.
+   A is a variable that is not read-only, or that there exists at
+   least an unconditional write to A in the current function.
 
    - reads or writes to memory are valid memory accesses for every
    iteration.  To check that the memory accesses are correctly formed
    and that we are allowed to read and write in these locations, we
    check that the memory accesses to be if-converted occur at every
-   iteration unconditionally.  */
+   iteration unconditionally, or that they stay within the bounds of
+   a declared array.  */
 
 static bool
 ifcvt_memrefs_wont_trap (gimple stmt, VEC (data_reference_p, heap) *refs)
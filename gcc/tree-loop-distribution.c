@@ -231,45 +231,60 @@ build_size_arg_loc (location_t loc, tree nb_iter, tree op,
   return x;
 }
 
-/* Generate a call to memset.  Return true when the operation succeeded.  */
+/* Build the address of the first byte accessed by DR in the
+   iterations of its loop, that access NB_BYTES bytes.  */
 
-static void
-generate_memset_zero (gimple stmt, tree op0, tree nb_iter,
-		      gimple_stmt_iterator bsi)
+static tree
+build_addr_arg_loc (location_t loc, struct data_reference *dr,
+		    tree nb_bytes, gimple_seq *stmt_list)
 {
-  tree addr_base, nb_bytes;
-  bool res = false;
-  gimple_seq stmt_list = NULL, stmts;
-  gimple fn_call;
-  tree mem, fn;
-  struct data_reference *dr = XCNEW (struct data_reference);
-  location_t loc = gimple_location (stmt);
-
-  DR_STMT (dr) = stmt;
-  DR_REF (dr) = op0;
-  res = dr_analyze_innermost (dr);
-  gcc_assert (res && stride_of_unit_type_p (DR_STEP (dr), TREE_TYPE (op0)));
+  gimple_seq stmts;
+  tree addr_base, op = DR_REF (dr);
 
-  nb_bytes = build_size_arg_loc (loc, nb_iter, op0, &stmt_list);
   addr_base = size_binop_loc (loc, PLUS_EXPR, DR_OFFSET (dr), DR_INIT (dr));
   addr_base = fold_convert_loc (loc, sizetype, addr_base);
 
   /* Test for a negative stride, iterating over every element.  */
   if (integer_zerop (size_binop (PLUS_EXPR,
-				 TYPE_SIZE_UNIT (TREE_TYPE (op0)),
+				 TYPE_SIZE_UNIT (TREE_TYPE (op)),
 				 fold_convert (sizetype, DR_STEP (dr)))))
     {
       addr_base = size_binop_loc (loc, MINUS_EXPR, addr_base,
 				  fold_convert_loc (loc, sizetype, nb_bytes));
       addr_base = size_binop_loc (loc, PLUS_EXPR, addr_base,
-				  TYPE_SIZE_UNIT (TREE_TYPE (op0)));
+				  TYPE_SIZE_UNIT (TREE_TYPE (op)));
     }
 
   addr_base = fold_build2_loc (loc, POINTER_PLUS_EXPR,
 			       TREE_TYPE (DR_BASE_ADDRESS (dr)),
 			       DR_BASE_ADDRESS (dr), addr_base);
-  mem = force_gimple_operand (addr_base, &stmts, true, NULL);
-  gimple_seq_add_seq (&stmt_list, stmts);
+  addr_base = force_gimple_operand (addr_base, &stmts, true, NULL);
+  gimple_seq_add_seq (stmt_list, stmts);
+
+  return addr_base;
+}
+
+/* Generate a call to memset.  Return true when the operation succeeded.  */
+
+static void
+generate_memset_zero (gimple stmt, tree op0, tree nb_iter,
+		      gimple_stmt_iterator bsi)
+{
+  tree nb_bytes;
+  bool res = false;
+  gimple_seq stmt_list = NULL;
+  gimple fn_call;
+  tree mem, fn;
+  struct data_reference *dr = XCNEW (struct data_reference);
+  location_t loc = gimple_location (stmt);
+
+  DR_STMT (dr) = stmt;
+  DR_REF (dr) = op0;
+  res = dr_analyze_innermost (dr);
+  gcc_assert (res && stride_of_unit_type_p (DR_STEP (dr), TREE_TYPE (op0)));
+
+  nb_bytes = build_size_arg_loc (loc, nb_iter, op0, &stmt_list);
+  mem = build_addr_arg_loc (loc, dr, nb_bytes, &stmt_list);
 
   fn = build_fold_addr_expr (implicit_built_in_decls [BUILT_IN_MEMSET]);
   fn_call = gimple_build_call (fn, 3, mem, integer_zero_node, nb_bytes);
@@ -282,20 +297,92 @@ generate_memset_zero (gimple stmt, tree op0, tree nb_iter,
   free_data_ref (dr);
 }
 
+/* Returns the statement loading the value stored by the copy STMT of
+   the form "A[i] = B[i]": STMT itself for an aggregate copy.  */
+
+static gimple
+copy_load_stmt (gimple stmt)
+{
+  tree val = gimple_assign_rhs1 (stmt);
+
+  return TREE_CODE (val) == SSA_NAME ? SSA_NAME_DEF_STMT (val) : stmt;
+}
+
+/* Generate a call to memcpy for the copy STMT of the form
+   "A[i] = B[i]", or to memmove when A and B may overlap.  */
+
+static void
+generate_memcpy (gimple stmt, tree nb_iter, gimple_stmt_iterator bsi)
+{
+  tree nb_bytes, dest, src, fn;
+  bool res;
+  gimple_seq stmt_list = NULL;
+  gimple fn_call, load = copy_load_stmt (stmt);
+  enum built_in_function kind;
+  struct data_reference *dst_dr = XCNEW (struct data_reference);
+  struct data_reference *src_dr = XCNEW (struct data_reference);
+  location_t loc = gimple_location (stmt);
+
+  DR_STMT (dst_dr) = stmt;
+  DR_REF (dst_dr) = gimple_assign_lhs (stmt);
+  DR_STMT (src_dr) = load;
+  DR_REF (src_dr) = gimple_assign_rhs1 (load);
+  res = dr_analyze_innermost (dst_dr) && dr_analyze_innermost (src_dr);
+  gcc_assert (res);
+
+  if (ptr_derefs_may_alias_p (DR_BASE_ADDRESS (dst_dr),
+			      DR_BASE_ADDRESS (src_dr)))
+    kind = BUILT_IN_MEMMOVE;
+  else
+    kind = BUILT_IN_MEMCPY;
+
+  nb_bytes = build_size_arg_loc (loc, nb_iter, DR_REF (dst_dr), &stmt_list);
+  dest = build_addr_arg_loc (loc, dst_dr, nb_bytes, &stmt_list);
+  src = build_addr_arg_loc (loc, src_dr, nb_bytes, &stmt_list);
+
+  fn = build_fold_addr_expr (implicit_built_in_decls [kind]);
+  fn_call = gimple_build_call (fn, 3, dest, src, nb_bytes);
+  gimple_seq_add_stmt (&stmt_list, fn_call);
+  gsi_insert_seq_after (&bsi, stmt_list, GSI_CONTINUE_LINKING);
+
+  if (dump_file && (dump_flags & TDF_DETAILS))
+    fprintf (dump_file, "generated %s\n",
+	     kind == BUILT_IN_MEMCPY ? "memcpy" : "memmove");
+
+  free_data_ref (dst_dr);
+  free_data_ref (src_dr);
+}
+
+static bool can_generate_builtin (struct graph *, bitmap);
+static bool stmt_has_scalar_dependences_outside_loop (gimple);
+
 /* Tries to generate a builtin function for the instructions of LOOP
-   pointed to by the bits set in PARTITION.  Returns true when the
-   operation succeeded.  */
+   pointed to by the bits set in PARTITION of RDG.  Returns true when
+   the operation succeeded.  */
 
 static bool
-generate_builtin (struct loop *loop, bitmap partition, bool copy_p)
+generate_builtin (struct loop *loop, struct graph *rdg, bitmap partition,
+		  bool copy_p)
 {
   bool res = false;
   unsigned i, x = 0;
   basic_block *bbs;
   gimple write = NULL;
   gimple_stmt_iterator bsi;
-  tree nb_iter = number_of_exit_cond_executions (loop);
+  bitmap_iterator bi;
+  tree nb_iter;
+
+  if (!can_generate_builtin (rdg, partition))
+    return false;
 
+  /* The loop is removed after the last partition: the scalars that it
+     computes for its uses after the loop must come from a loop.  */
+  if (!copy_p)
+    EXECUTE_IF_SET_IN_BITMAP (partition, 0, i, bi)
+      if (stmt_has_scalar_dependences_outside_loop (RDG_STMT (rdg, i)))
+	return false;
+
+  nb_iter = number_of_exit_cond_executions (loop);
   if (!nb_iter || nb_iter == chrec_dont_know)
     return false;
 
@@ -328,12 +415,14 @@ generate_builtin (struct loop *loop, bitmap partition, bool copy_p)
 	}
     }
 
-  if (!stmt_with_adjacent_zero_store_dr_p (write))
-    goto end;
-
   /* The new statements will be placed before LOOP.  */
   bsi = gsi_last_bb (loop_preheader_edge (loop)->src);
-  generate_memset_zero (write, gimple_assign_lhs (write), nb_iter, bsi);
+  if (stmt_with_adjacent_zero_store_dr_p (write))
+    generate_memset_zero (write, gimple_assign_lhs (write), nb_iter, bsi);
+  else if (stmt_with_adjacent_copy_dr_p (write))
+    generate_memcpy (write, nb_iter, bsi);
+  else
+    goto end;
   res = true;
 
   /* If this is the last partition for which we generate code, we have
@@ -365,9 +454,10 @@ generate_builtin (struct loop *loop, bitmap partition, bool copy_p)
    generate a built-in.  */
 
 static bool
-generate_code_for_partition (struct loop *loop, bitmap partition, bool copy_p)
+generate_code_for_partition (struct loop *loop, struct graph *rdg,
+			     bitmap partition, bool copy_p)
 {
-  if (generate_builtin (loop, partition, copy_p))
+  if (generate_builtin (loop, rdg, partition, copy_p))
     return true;
 
   return generate_loops_for_partition (loop, partition, copy_p);
@@ -731,9 +821,116 @@ rdg_build_components (struct graph *rdg, VEC (int, heap) *starting_vertices,
   BITMAP_FREE (saved_components);
 }
 
+/* Returns false when the memory dependence E of RDG prevents the
+   copy, whose store is the vertex STORE and whose load the vertex
+   LOAD, from being generated as a call to memmove: when E links the
+   copy to another memory access of the loop, or when the store writes
+   a location that the load reads in a later iteration.  */
+
+static bool
+copy_dependence_ok_p (struct graph_edge *e, int store, int load)
+{
+  ddr_p ddr = RDGE_RELATION (e);
+  struct loop *loop;
+  lambda_vector dist_v;
+  unsigned i;
+
+  if (ddr == NULL || RDGE_TYPE (e) == input_dd)
+    return true;
+
+  if ((e->src != store && e->src != load)
+      || (e->dest != store && e->dest != load))
+    return false;
+
+  if (DDR_ARE_DEPENDENT (ddr) == chrec_known)
+    return true;
+
+  /* The data references are collected in the order of the loop body,
+     reads before writes in a statement, so the relation is between the
+     load and the store, in this order, as it has to be for reading the
+     distances below.  */
+  if (DDR_ARE_DEPENDENT (ddr) == chrec_dont_know
+      || !DR_IS_READ (DDR_A (ddr))
+      || DDR_NUM_DIST_VECTS (ddr) == 0)
+    return false;
+
+  loop = loop_containing_stmt (DR_STMT (DDR_B (ddr)));
+  FOR_EACH_VEC_ELT (lambda_vector, DDR_DIST_VECTS (ddr), i, dist_v)
+    if (dist_v[index_in_loop_nest (loop->num, DDR_LOOP_NEST (ddr))] > 0
+	&& !DDR_REVERSED_P (ddr))
+      return false;
+
+  return true;
+}
+
+/* Returns true when the vertex V of RDG is a store of the form
+   "A[i] = B[i]" that can be generated as a call to memcpy or
+   memmove.  */
+
+static bool
+copy_builtin_vertex_p (struct graph *rdg, int v)
+{
+  gimple stmt = RDG_STMT (rdg, v);
+  struct graph_edge *e;
+  int load, vs[2];
+  unsigned i;
+
+  if (!stmt_with_adjacent_copy_dr_p (stmt))
+    return false;
+
+  load = rdg_vertex_for_stmt (rdg, copy_load_stmt (stmt));
+  if (load < 0)
+    return false;
+
+  vs[0] = v;
+  vs[1] = load;
+  for (i = 0; i < 2; i++)
+    {
+      for (e = rdg->vertices[vs[i]].pred; e; e = e->pred_next)
+	if (!copy_dependence_ok_p (e, v, load))
+	  return false;
+
+      for (e = rdg->vertices[vs[i]].succ; e; e = e->succ_next)
+	if (!copy_dependence_ok_p (e, v, load))
+	  return false;
+    }
+
+  return true;
+}
+
+/* Returns true when the current function is the implementation of the
+   builtin KIND, for instance memset itself: a loop of its body must not
+   be replaced by a call to KIND, that would recurse forever.  This is
+   the case when the function is the builtin, or when it has the
+   assembler name of the builtin, as an implementation defined under
+   another name and renamed with an asm label.  */
+
+static bool
+in_builtin_implementation_p (enum built_in_function kind)
+{
+  tree fn = current_function_decl;
+  tree implicit = implicit_built_in_decls[kind];
+  tree explicit_decl = built_in_decls[kind];
+
+  if (implicit == NULL_TREE)
+    return true;
+
+  if (DECL_BUILT_IN_CLASS (fn) == BUILT_IN_NORMAL
+      && DECL_FUNCTION_CODE (fn) == kind)
+    return true;
+
+  if (fn == implicit || fn == explicit_decl)
+    return true;
+
+  return (decl_assembler_name_equal (fn, DECL_ASSEMBLER_NAME (implicit))
+	  || (explicit_decl != NULL_TREE
+	      && decl_assembler_name_equal (fn,
+					    DECL_ASSEMBLER_NAME (explicit_decl))));
+}
+
 /* Returns true when it is possible to generate a builtin pattern for
-   the PARTITION of RDG.  For the moment we detect only the memset
-   zero pattern.  */
+   the PARTITION of RDG.  For the moment we detect the memset zero
+   pattern, and the copies that become memcpy or memmove.  */
 
 static bool
 can_generate_builtin (struct graph *rdg, bitmap partition)
@@ -743,18 +940,110 @@ can_generate_builtin (struct graph *rdg, bitmap partition)
   int nb_reads = 0;
   int nb_writes = 0;
   int stores_zero = 0;
+  int copies = 0;
+  int copy_loads = 0;
 
   EXECUTE_IF_SET_IN_BITMAP (partition, 0, i, bi)
-    if (RDG_MEM_READS_STMT (rdg, i))
-      nb_reads++;
-    else if (RDG_MEM_WRITE_STMT (rdg, i))
+    if (RDG_MEM_WRITE_STMT (rdg, i))
       {
 	nb_writes++;
 	if (stmt_with_adjacent_zero_store_dr_p (RDG_STMT (rdg, i)))
 	  stores_zero++;
+	else if (copy_builtin_vertex_p (rdg, i))
+	  {
+	    copies++;
+	    if (!RDG_MEM_READS_STMT (rdg, i))
+	      copy_loads++;
+	  }
       }
+    else if (RDG_MEM_READS_STMT (rdg, i))
+      nb_reads++;
 
-  return stores_zero == 1 && nb_writes == 1 && nb_reads == 0;
+  return nb_writes == 1
+    && ((stores_zero == 1 && nb_reads == 0
+	 && !in_builtin_implementation_p (BUILT_IN_MEMSET))
+	|| (copies == 1 && nb_reads == copy_loads
+	    && !in_builtin_implementation_p (BUILT_IN_MEMCPY)
+	    && !in_builtin_implementation_p (BUILT_IN_MEMMOVE)));
+}
+
+/* Returns true when one of the PARTITIONS of RDG can be generated as a
+   builtin.  */
+
+static bool
+builtin_partition_p (struct graph *rdg, VEC (bitmap, heap) *partitions)
+{
+  int i;
+  bitmap partition;
+
+  FOR_EACH_VEC_ELT (bitmap, partitions, i, partition)
+    if (can_generate_builtin (rdg, partition))
+      return true;
+
+  return false;
+}
+
+/* Returns false when the PARTITION of RDG contains statements that the
+   vectorizer does not handle: calls, memory accesses that do not
+   advance by a constant step, and scalar cycles that are neither
+   inductions nor reductions.  */
+
+static bool
+partition_vectorizable_p (struct graph *rdg, bitmap partition)
+{
+  unsigned i;
+  bitmap_iterator bi;
+
+  EXECUTE_IF_SET_IN_BITMAP (partition, 0, i, bi)
+    {
+      gimple stmt = RDG_STMT (rdg, i);
+      struct loop *loop = loop_containing_stmt (stmt);
+
+      if (gimple_code (stmt) == GIMPLE_PHI)
+	{
+	  tree res = PHI_RESULT (stmt), next;
+	  gimple def;
+	  affine_iv iv;
+
+	  if (!is_gimple_reg (res)
+	      || gimple_bb (stmt) != loop->header
+	      || simple_iv (loop, loop, res, &iv, true))
+	    continue;
+
+	  next = PHI_ARG_DEF_FROM_EDGE (stmt, loop_latch_edge (loop));
+	  if (TREE_CODE (next) != SSA_NAME)
+	    return false;
+	  def = SSA_NAME_DEF_STMT (next);
+	  if (!is_gimple_assign (def)
+	      || !commutative_tree_code (gimple_assign_rhs_code (def))
+	      || !associative_tree_code (gimple_assign_rhs_code (def))
+	      || (gimple_assign_rhs1 (def) != res
+		  && gimple_assign_rhs2 (def) != res))
+	    return false;
+	}
+      else if (is_gimple_call (stmt))
+	return false;
+      else if (RDG_MEM_WRITE_STMT (rdg, i) || RDG_MEM_READS_STMT (rdg, i))
+	{
+	  struct data_reference *dr;
+	  bool res;
+
+	  if (!gimple_assign_single_p (stmt))
+	    return false;
+
+	  dr = XCNEW (struct data_reference);
+	  DR_STMT (dr) = stmt;
+	  DR_REF (dr) = RDG_MEM_WRITE_STMT (rdg, i)
+	    ? gimple_assign_lhs (stmt) : gimple_assign_rhs1 (stmt);
+	  res = dr_analyze_innermost (dr)
+	    && TREE_CODE (DR_STEP (dr)) == INTEGER_CST;
+	  free_data_ref (dr);
+	  if (!res)
+	    return false;
+	}
+    }
+
+  return true;
 }
 
 /* Returns true when PARTITION1 and PARTITION2 have similar memory
@@ -782,7 +1071,8 @@ similar_memory_accesses (struct graph *rdg, bitmap partition1,
 /* Fuse all the partitions from PARTITIONS that contain similar memory
    references, i.e., we're taking care of cache locality.  This
    function does not fuse those partitions that contain patterns that
-   can be code generated with builtins.  */
+   can be code generated with builtins, nor, when vectorizing, the
+   partitions that the vectorizer handles with those it does not.  */
 
 static void
 fuse_partitions_with_similar_memory_accesses (struct graph *rdg,
@@ -796,7 +1086,10 @@ fuse_partitions_with_similar_memory_accesses (struct graph *rdg,
       FOR_EACH_VEC_ELT (bitmap, *partitions, p2, partition2)
 	if (p1 != p2
 	    && !can_generate_builtin (rdg, partition2)
-	    && similar_memory_accesses (rdg, partition1, partition2))
+	    && similar_memory_accesses (rdg, partition1, partition2)
+	    && (!flag_tree_vectorize
+		|| (partition_vectorizable_p (rdg, partition1)
+		    == partition_vectorizable_p (rdg, partition2))))
 	  {
 	    bitmap_ior_into (partition1, partition2);
 	    VEC_ordered_remove (bitmap, *partitions, p2);
@@ -1053,6 +1346,37 @@ partition_contains_all_rw (struct graph *rdg, VEC (bitmap, heap) *partitions)
   return false;
 }
 
+/* Fuse the consecutive PARTITIONS of RDG that are not generated as
+   builtins and that the vectorizer handles, or does not handle, alike:
+   distributing them would only add loops to vectorize, or loops that
+   stay scalar.  */
+
+static void
+fuse_partitions_for_vectorization (struct graph *rdg,
+				   VEC (bitmap, heap) **partitions)
+{
+  unsigned p = 0;
+  bitmap partition1, partition2;
+
+  while (p + 1 < VEC_length (bitmap, *partitions))
+    {
+      partition1 = VEC_index (bitmap, *partitions, p);
+      partition2 = VEC_index (bitmap, *partitions, p + 1);
+
+      if (!can_generate_builtin (rdg, partition1)
+	  && !can_generate_builtin (rdg, partition2)
+	  && (partition_vectorizable_p (rdg, partition1)
+	      == partition_vectorizable_p (rdg, partition2)))
+	{
+	  bitmap_ior_into (partition1, partition2);
+	  BITMAP_FREE (partition2);
+	  VEC_ordered_remove (bitmap, *partitions, p + 1);
+	}
+      else
+	p++;
+    }
+}
+
 /* Generate code from STARTING_VERTICES in RDG.  Returns the number of
    distributed loops.  */
 
@@ -1098,17 +1422,25 @@ ldist_gen (struct loop *loop, struct graph *rdg,
   rdg_build_partitions (rdg, components, &other_stores, &partitions,
 			processed);
   BITMAP_FREE (processed);
+
+  if (flag_tree_vectorize)
+    fuse_partitions_for_vectorization (rdg, &partitions);
+
   nbp = VEC_length (bitmap, partitions);
 
-  if (nbp <= 1
-      || partition_contains_all_rw (rdg, partitions))
+  /* Distributing the loop pays off when one of the partitions becomes
+     a builtin, even the only one.  */
+  if (nbp == 0
+      || (!builtin_partition_p (rdg, partitions)
+	  && (nbp == 1
+	      || partition_contains_all_rw (rdg, partitions))))
     goto ldist_done;
 
   if (dump_file && (dump_flags & TDF_DETAILS))
     dump_rdg_partitions (dump_file, partitions);
 
   FOR_EACH_VEC_ELT (bitmap, partitions, i, partition)
-    if (!generate_code_for_partition (loop, partition, i < nbp - 1))
+    if (!generate_code_for_partition (loop, rdg, partition, i < nbp - 1))
       goto ldist_done;
 
   rewrite_into_loop_closed_ssa (NULL, TODO_update_ssa);
@@ -1183,7 +1515,11 @@ distribute_loop (struct loop *loop, VEC (gimple, heap) *stmts)
     {
       int v = rdg_vertex_for_stmt (rdg, s);
 
-      if (v >= 0)
+      /* Do not separate a copy that will not become a builtin: when
+	 all the stores are asked for, it still ends in a partition.  */
+      if (v >= 0
+	  && (!stmt_with_adjacent_copy_dr_p (s)
+	      || copy_builtin_vertex_p (rdg, v)))
 	{
 	  VEC_safe_push (int, heap, vertices, v);
 
@@ -1228,8 +1564,8 @@ tree_loop_distribution (void)
 	{
 	  /* With the following working list, we're asking
 	     distribute_loop to separate from the rest of the loop the
-	     stores of the form "A[i] = 0".  */
-	  stores_zero_from_loop (loop, &work_list);
+	     stores of the form "A[i] = 0" and "A[i] = B[i]".  */
+	  stores_builtin_from_loop (loop, &work_list);
 
 	  /* Do nothing if there are no patterns to be distributed.  */
 	  if (VEC_length (gimple, work_list) > 0)
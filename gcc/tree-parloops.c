@@ -31,6 +31,8 @@ along with GCC; see the file COPYING3.  If not see
 #include "tree-pass.h"
 #include "langhooks.h"
 #include "tree-vectorizer.h"
+#include "tree-inline.h"
+#include "params.h"
 
 /* This pass tries to distribute iterations of loops into several threads.
    The implementation is straightforward -- for each loop we test whether its
@@ -55,7 +57,8 @@ along with GCC; see the file COPYING3.  If not see
       possible to generate the threads just once (using synchronization to
       ensure that cross-loop dependences are obeyed).
    -- handling of common scalar dependence patterns (accumulation, ...)
-   -- handling of non-innermost loops  */
+   -- reductions into arrays, and of a minimum or maximum together with
+      its index  */
 
 /*
   Reduction handling:
@@ -153,16 +156,17 @@ parloop
 
 */
 
-/* Minimal number of iterations of a loop that should be executed in each
-   thread.  */
-#define MIN_PER_THREAD 100
-
 /* Element of the hashtable, representing a
    reduction in the current loop.  */
 struct reduction_info
 {
   gimple reduc_stmt;		/* reduction statement.  */
   gimple reduc_phi;		/* The phi node defining the reduction.  */
+  tree reduc_result;		/* The value of the reduction variable at the
+				   end of an iteration: the lhs of reduc_stmt,
+				   or for a double reduction, whose reduc_stmt
+				   is in an inner loop, the loop closed phi
+				   result after that loop.  */
   enum tree_code reduction_code;/* code for the reduction operation.  */
   unsigned reduc_version;	/* SSA_NAME_VERSION of original reduc_phi
 				   result.  */
@@ -1002,8 +1006,8 @@ create_phi_for_local_result (void **slot, void *data)
   new_phi = create_phi_node (local_res, store_bb);
   SSA_NAME_DEF_STMT (local_res) = new_phi;
   add_phi_arg (new_phi, reduc->init, e, locus);
-  add_phi_arg (new_phi, gimple_assign_lhs (reduc->reduc_stmt),
-	       FALLTHRU_EDGE (loop->latch), locus);
+  add_phi_arg (new_phi, reduc->reduc_result, FALLTHRU_EDGE (loop->latch),
+	       locus);
   reduc->new_phi = new_phi;
 
   return 1;
@@ -1695,12 +1699,14 @@ create_parallel_loop (struct loop *loop, tree loop_fn, tree data,
 /* Generates code to execute the iterations of LOOP in N_THREADS
    threads in parallel.
 
-   NITER describes number of iterations of LOOP.
+   NITER describes number of iterations of LOOP, and the original loop
+   is executed instead when it is less than MIN_ITERATIONS.
    REDUCTION_LIST describes the reductions existent in the LOOP.  */
 
 static void
 gen_parallel_loop (struct loop *loop, htab_t reduction_list,
-		   unsigned n_threads, struct tree_niter_desc *niter)
+		   unsigned n_threads, struct tree_niter_desc *niter,
+		   unsigned HOST_WIDE_INT min_iterations)
 {
   loop_iterator li;
   tree many_iterations_cond, type, nit;
@@ -1732,7 +1738,7 @@ gen_parallel_loop (struct loop *loop, htab_t reduction_list,
      ---------------------------------------------------------------------
 
      if (MAY_BE_ZERO
-     || NITER < MIN_PER_THREAD * N_THREADS)
+     || NITER < MIN_ITERATIONS)
      goto original;
 
      BODY1;
@@ -1774,7 +1780,7 @@ gen_parallel_loop (struct loop *loop, htab_t reduction_list,
 
   many_iterations_cond =
     fold_build2 (GE_EXPR, boolean_type_node,
-		 nit, build_int_cst (type, MIN_PER_THREAD * n_threads));
+		 nit, build_int_cst (type, min_iterations));
   many_iterations_cond
     = fold_build2 (TRUTH_AND_EXPR, boolean_type_node,
 		   invert_truthvalue (unshare_expr (niter->may_be_zero)),
@@ -1851,6 +1857,60 @@ gen_parallel_loop (struct loop *loop, htab_t reduction_list,
   omp_expand_local (parallel_head);
 }
 
+/* Return the estimated cost of an iteration of LOOP, counting the
+   iterations of its inner loops.  */
+
+static unsigned HOST_WIDE_INT
+loop_iteration_cost (struct loop *loop)
+{
+  basic_block *body = get_loop_body (loop);
+  gimple_stmt_iterator gsi;
+  unsigned HOST_WIDE_INT cost = 0, inner_cost;
+  struct loop *inner;
+  unsigned i;
+
+  for (i = 0; i < loop->num_nodes; i++)
+    if (body[i]->loop_father == loop)
+      for (gsi = gsi_start_bb (body[i]); !gsi_end_p (gsi); gsi_next (&gsi))
+	cost += estimate_num_insns (gsi_stmt (gsi), &eni_time_weights);
+  free (body);
+
+  for (inner = loop->inner; inner; inner = inner->next)
+    {
+      inner_cost = loop_iteration_cost (inner)
+		   * MAX (expected_loop_iterations (inner), 1);
+      cost = MIN (cost + inner_cost, (unsigned HOST_WIDE_INT) INT_MAX);
+    }
+
+  return MAX (cost, 1);
+}
+
+/* Return the number of iterations of LOOP from which running it in
+   N_THREADS threads is expected to be no slower than running it
+   serially.  The iterations saved by the other threads must pay for the
+   cost of starting and joining each of them, and each thread must get
+   an iteration.  */
+
+static unsigned HOST_WIDE_INT
+parallel_loop_min_iterations (struct loop *loop, unsigned n_threads)
+{
+  unsigned HOST_WIDE_INT start_cost
+    = PARAM_VALUE (PARAM_PARLOOPS_THREAD_START_COST);
+  unsigned HOST_WIDE_INT cost = loop_iteration_cost (loop);
+  unsigned HOST_WIDE_INT min_iterations;
+
+  /* N * COST >= (N_THREADS - 1) * START_COST + N * COST / N_THREADS,
+     that is N * COST >= N_THREADS * START_COST.  */
+  min_iterations = (start_cost * n_threads + cost - 1) / cost;
+
+  if (dump_file && (dump_flags & TDF_DETAILS))
+    fprintf (dump_file, "iteration cost " HOST_WIDE_INT_PRINT_UNSIGNED
+	     ", parallel from " HOST_WIDE_INT_PRINT_UNSIGNED
+	     " iterations\n", cost, MAX (min_iterations, n_threads));
+
+  return MAX (min_iterations, n_threads);
+}
+
 /* Returns true when LOOP contains vector phi nodes.  */
 
 static bool
@@ -1876,7 +1936,8 @@ loop_has_vector_phi_nodes (struct loop *loop ATTRIBUTE_UNUSED)
    and PHI, insert it to the REDUCTION_LIST.  */
 
 static void
-build_new_reduction (htab_t reduction_list, gimple reduc_stmt, gimple phi)
+build_new_reduction (htab_t reduction_list, gimple reduc_stmt, gimple phi,
+		     tree result)
 {
   PTR *slot;
   struct reduction_info *new_reduction;
@@ -1895,6 +1956,7 @@ build_new_reduction (htab_t reduction_list, gimple reduc_stmt, gimple phi)
 
   new_reduction->reduc_stmt = reduc_stmt;
   new_reduction->reduc_phi = phi;
+  new_reduction->reduc_result = result;
   new_reduction->reduc_version = SSA_NAME_VERSION (gimple_phi_result (phi));
   new_reduction->reduction_code = gimple_assign_rhs_code (reduc_stmt);
   slot = htab_find_slot (reduction_list, new_reduction, INSERT);
@@ -1911,6 +1973,88 @@ set_reduc_phi_uids (void **slot, void *data ATTRIBUTE_UNUSED)
   return 1;
 }
 
+/* PHI, in the header of LOOP, was found by the vectorizer to be a double
+   reduction, whose value is updated in the inner loop of LOOP and comes
+   back to PHI through the loop closed phi node EXIT_PHI:
+
+     outer header:  s1 = PHI <init, s4>
+     inner header:  s2 = PHI <s1, s3>
+		    s3 = s2 OP x;
+     inner exit:    s4 = PHI <s3>
+
+   Check that the inner cycle is a reduction that can be reassociated,
+   and return the statement computing s3, or NULL.  */
+
+static gimple
+double_reduction_stmt (struct loop *loop, gimple phi, gimple exit_phi)
+{
+  struct loop *inner = loop->inner;
+  tree s1 = PHI_RESULT (phi), s2 = NULL_TREE, s3, type;
+  gimple_stmt_iterator gsi;
+  gimple stmt, use_stmt;
+  imm_use_iterator imm_iter;
+  use_operand_p use_p;
+  enum tree_code code;
+  int n_uses;
+
+  if (inner == NULL || inner->next != NULL
+      || gimple_phi_num_args (exit_phi) != 1)
+    return NULL;
+  s3 = PHI_ARG_DEF (exit_phi, 0);
+  if (TREE_CODE (s3) != SSA_NAME)
+    return NULL;
+  stmt = SSA_NAME_DEF_STMT (s3);
+  if (!is_gimple_assign (stmt)
+      || gimple_bb (stmt)->loop_father != inner)
+    return NULL;
+
+  for (gsi = gsi_start_phis (inner->header); !gsi_end_p (gsi); gsi_next (&gsi))
+    if (PHI_ARG_DEF_FROM_EDGE (gsi_stmt (gsi), loop_preheader_edge (inner))
+	== s1)
+      {
+	s2 = PHI_RESULT (gsi_stmt (gsi));
+	if (PHI_ARG_DEF_FROM_EDGE (gsi_stmt (gsi), loop_latch_edge (inner))
+	    != s3)
+	  return NULL;
+	break;
+      }
+  if (s2 == NULL_TREE)
+    return NULL;
+
+  /* The operation must be one whose partial results the threads can
+     combine in any order.  */
+  code = gimple_assign_rhs_code (stmt);
+  type = TREE_TYPE (s3);
+  if (get_gimple_rhs_class (code) != GIMPLE_BINARY_RHS
+      || !commutative_tree_code (code)
+      || !associative_tree_code (code)
+      || (gimple_assign_rhs1 (stmt) != s2 && gimple_assign_rhs2 (stmt) != s2)
+      || (FLOAT_TYPE_P (type) && !flag_associative_math)
+      || (INTEGRAL_TYPE_P (type) && TYPE_OVERFLOW_TRAPS (type))
+      || SAT_FIXED_POINT_TYPE_P (type))
+    return NULL;
+
+  /* And the intermediate values must not be used for anything else.  */
+  n_uses = 0;
+  FOR_EACH_IMM_USE_FAST (use_p, imm_iter, s2)
+    if (!is_gimple_debug (USE_STMT (use_p)))
+      n_uses++;
+  if (n_uses != 1
+      || (gimple_assign_rhs1 (stmt) == s2 && gimple_assign_rhs2 (stmt) == s2))
+    return NULL;
+  FOR_EACH_IMM_USE_FAST (use_p, imm_iter, s3)
+    {
+      use_stmt = USE_STMT (use_p);
+      if (!is_gimple_debug (use_stmt)
+	  && use_stmt != exit_phi
+	  && !(gimple_code (use_stmt) == GIMPLE_PHI
+	       && gimple_bb (use_stmt) == inner->header))
+	return NULL;
+    }
+
+  return stmt;
+}
+
 /* Detect all reductions in the LOOP, insert them into REDUCTION_LIST.  */
 
 static void
@@ -1939,7 +2083,16 @@ gather_scalar_reductions (loop_p loop, htab_t reduction_list)
 							    phi, true,
 							    &double_reduc);
 	   if (reduc_stmt && !double_reduc)
-              build_new_reduction (reduction_list, reduc_stmt, phi);
+              build_new_reduction (reduction_list, reduc_stmt, phi,
+				   gimple_assign_lhs (reduc_stmt));
+	   else if (reduc_stmt)
+	     {
+	       gimple inner_stmt = double_reduction_stmt (loop, phi,
+							  reduc_stmt);
+	       if (inner_stmt)
+		 build_new_reduction (reduction_list, inner_stmt, phi,
+				      PHI_RESULT (reduc_stmt));
+	     }
         }
     }
   destroy_loop_vec_info (simple_loop_info, true);
@@ -2084,6 +2237,7 @@ parallelize_loops (void)
   htab_t reduction_list;
   struct obstack parloop_obstack;
   HOST_WIDE_INT estimated;
+  unsigned HOST_WIDE_INT min_iterations;
   LOC loop_loc;
 
   /* Do not parallelize loops in the functions created by parallelization.  */
@@ -2135,11 +2289,12 @@ parallelize_loops (void)
 	  || loop_has_vector_phi_nodes (loop))
 	continue;
       estimated = estimated_loop_iterations_int (loop, false);
+      min_iterations = parallel_loop_min_iterations (loop, n_threads);
       /* FIXME: Bypass this check as graphite doesn't update the
       count and frequency correctly now.  */
       if (!flag_loop_parallelize_all
 	  && ((estimated !=-1 
-	     && estimated <= (HOST_WIDE_INT) n_threads * MIN_PER_THREAD)
+	     && (unsigned HOST_WIDE_INT) estimated < min_iterations)
 	      /* Do not bother with loops in cold areas.  */
 	      || optimize_loop_nest_for_size_p (loop)))
 	continue;
@@ -2167,7 +2322,7 @@ parallelize_loops (void)
 		   LOC_FILE (loop_loc), LOC_LINE (loop_loc));
       }
       gen_parallel_loop (loop, reduction_list,
-			 n_threads, &niter_desc);
+			 n_threads, &niter_desc, min_iterations);
       verify_flow_info ();
       verify_dominators (CDI_DOMINATORS);
       verify_loop_structure ();
@@ -39,6 +39,8 @@ enum tree_dump_index
   TDI_vcg,			/* create a VCG graph file for each
 				   function's flowgraph.  */
   TDI_ada,                      /* dump declarations in Ada syntax.  */
+  TDI_ggc,			/* dump statistics of the garbage
+				   collector.  */
   TDI_tree_all,                 /* enable all the GENERIC/GIMPLE dumps.  */
   TDI_rtl_all,                  /* enable all the RTL dumps.  */
   TDI_ipa_all,                  /* enable all the IPA dumps.  */
@@ -609,6 +611,7 @@ extern void execute_pass_list (struct opt_pass *);
 extern void execute_ipa_pass_list (struct opt_pass *);
 extern void execute_ipa_summary_passes (struct ipa_opt_pass_d *);
 extern void execute_all_ipa_transforms (void);
+extern void release_function_budget (tree);
 extern void execute_all_ipa_stmt_fixups (struct cgraph_node *, gimple *);
 extern bool pass_init_dump_file (struct opt_pass *);
 extern void pass_fini_dump_file (struct opt_pass *);
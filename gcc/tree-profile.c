@@ -158,7 +158,7 @@ gimple_init_edge_profiler (void)
 					  ptr_void,
 					  ptr_void, NULL_TREE);
       tree_indirect_call_profiler_fn
-	      = build_fn_decl ("__gcov_indirect_call_profiler",
+	      = build_fn_decl ("__gcov_indirect_call_topn_profiler",
 				     ic_profiler_fn_type);
       TREE_NOTHROW (tree_indirect_call_profiler_fn) = 1;
       DECL_ATTRIBUTES (tree_indirect_call_profiler_fn)
@@ -339,7 +339,7 @@ gimple_gen_ic_profiler (histogram_value value, unsigned tag, unsigned base)
 
 
 /* Output instructions as GIMPLE trees for code to find the most
-   common called function in indirect call. Insert instructions at the
+   common called functions in indirect call. Insert instructions at the
    beginning of every possible called function.
   */
 
@@ -541,6 +541,26 @@ vect_analyze_data_ref_dependence (struct data_dependence_relation *ddr,
       || !STMT_VINFO_VECTORIZABLE (stmtinfo_b))
     return false;
 
+  /* The addresses of a gather are unknown at compile time, so it must be
+     independent of every store in the loop.  The dependence analysis
+     failed on the gather, so ask the alias oracle about the references.  */
+  if (STMT_VINFO_GATHER_P (stmtinfo_a) || STMT_VINFO_GATHER_P (stmtinfo_b))
+    {
+      if (DDR_ARE_DEPENDENT (ddr) == chrec_known
+	  || (DR_IS_READ (dra) && DR_IS_READ (drb))
+	  || !refs_may_alias_p (DR_REF (dra), DR_REF (drb)))
+	return false;
+
+      if (vect_print_dump_info (REPORT_DR_DETAILS))
+	{
+	  fprintf (vect_dump, "possible dependence with gather between ");
+	  print_generic_expr (vect_dump, DR_REF (dra), TDF_SLIM);
+	  fprintf (vect_dump, " and ");
+	  print_generic_expr (vect_dump, DR_REF (drb), TDF_SLIM);
+	}
+      return true;
+    }
+
   if (DDR_ARE_DEPENDENT (ddr) == chrec_known)
     {
       /* Independent data accesses.  */
@@ -776,6 +796,14 @@ vect_compute_data_ref_alignment (struct data_reference *dr)
   /* Initialize misalignment to unknown.  */
   SET_DR_MISALIGNMENT (dr, -1);
 
+  /* The elements of a gather are loaded one by one, so it is never
+     accessed as a vector in memory.  */
+  if (STMT_VINFO_GATHER_P (stmt_info))
+    {
+      SET_DR_MISALIGNMENT (dr, 0);
+      return true;
+    }
+
   misalign = DR_INIT (dr);
   aligned_to = DR_ALIGNED_TO (dr);
   base_addr = DR_BASE_ADDRESS (dr);
@@ -958,6 +986,10 @@ vect_update_misalignment_for_peel (struct data_reference *dr,
   stmt_vec_info stmt_info = vinfo_for_stmt (DR_STMT (dr));
   stmt_vec_info peel_stmt_info = vinfo_for_stmt (DR_STMT (dr_peel));
 
+  /* Peeling does not change the alignment of the elements of a gather.  */
+  if (STMT_VINFO_GATHER_P (stmt_info))
+    return;
+
  /* For interleaved data accesses the step in the loop must be multiplied by
      the size of the interleaving group.  */
   if (STMT_VINFO_STRIDED_ACCESS (stmt_info))
@@ -1461,9 +1493,10 @@ vect_enhance_data_refs_alignment (loop_vec_info loop_vinfo)
       stmt_info = vinfo_for_stmt (stmt);
 
       /* For interleaving, only the alignment of the first access
-         matters.  */
-      if (STMT_VINFO_STRIDED_ACCESS (stmt_info)
-          && DR_GROUP_FIRST_DR (stmt_info) != stmt)
+         matters.  Peeling for a gather makes no sense.  */
+      if ((STMT_VINFO_STRIDED_ACCESS (stmt_info)
+           && DR_GROUP_FIRST_DR (stmt_info) != stmt)
+          || STMT_VINFO_GATHER_P (stmt_info))
         continue;
 
       supportable_dr_alignment = vect_supportable_dr_alignment (dr, true);
@@ -2238,6 +2271,13 @@ vect_analyze_data_ref_access (struct data_reference *dr)
   if (loop_vinfo)
     loop = LOOP_VINFO_LOOP (loop_vinfo);
 
+  /* A gather does not access consecutive elements.  */
+  if (STMT_VINFO_GATHER_P (stmt_info))
+    {
+      DR_GROUP_FIRST_DR (stmt_info) = NULL;
+      return true;
+    }
+
   if (loop_vinfo && !step)
     {
       if (vect_print_dump_info (REPORT_DETAILS))
@@ -2336,18 +2376,149 @@ vect_analyze_data_ref_accesses (loop_vec_info loop_vinfo, bb_vec_info bb_vinfo)
   return true;
 }
 
+/* Function vect_vfa_segment_size.
+
+   Return the length in bytes of the segment of memory accessed by DR in
+   VECT_FACTOR iterations of the loop, taking into account that
+   realignment loads may access one more vector.  The length is negative
+   when DR is accessed downwards.  */
+
+static HOST_WIDE_INT
+vect_vfa_segment_size (struct data_reference *dr, int vect_factor)
+{
+  HOST_WIDE_INT step = tree_low_cst (DR_STEP (dr), 0);
+  HOST_WIDE_INT segment_length = step * vect_factor;
+
+  if (vect_supportable_dr_alignment (dr, false)
+      == dr_explicit_realign_optimized)
+    {
+      tree vectype = STMT_VINFO_VECTYPE (vinfo_for_stmt (DR_STMT (dr)));
+      HOST_WIDE_INT vector_size = tree_low_cst (TYPE_SIZE_UNIT (vectype), 1);
+
+      segment_length += step < 0 ? -vector_size : vector_size;
+    }
+
+  return segment_length;
+}
+
+/* Return the segment of memory checked at run-time for DR in a loop with
+   vectorization factor VECT_FACTOR.  For interleaved accesses it is the
+   segment of the whole group, which starts at its first data reference.  */
+
+static dr_with_seg_len
+vect_vfa_segment (struct data_reference *dr, int vect_factor)
+{
+  dr_with_seg_len seg;
+  gimple first = DR_GROUP_FIRST_DR (vinfo_for_stmt (DR_STMT (dr)));
+
+  if (first)
+    dr = STMT_VINFO_DATA_REF (vinfo_for_stmt (first));
+
+  seg.dr = dr;
+  seg.seg_len = ssize_int (vect_vfa_segment_size (dr, vect_factor));
+  return seg;
+}
+
+/* Return true if the segments SEG_A and SEG_B are the same.  */
+
+static bool
+vect_same_segment_p (const dr_with_seg_len *seg_a,
+		     const dr_with_seg_len *seg_b)
+{
+  return (vect_same_range_drs (seg_a->dr, seg_b->dr)
+	  && tree_int_cst_equal (seg_a->seg_len, seg_b->seg_len));
+}
+
+/* If the segments SEG_A and SEG_B are accessed from the same base with
+   the same step, and overlap or are adjacent, extend SEG_A to cover
+   SEG_B as well and return true.  Otherwise return false.  */
+
+static bool
+vect_merge_segments (dr_with_seg_len *seg_a, const dr_with_seg_len *seg_b)
+{
+  struct data_reference *dr_a = seg_a->dr;
+  struct data_reference *dr_b = seg_b->dr;
+  HOST_WIDE_INT init_a, init_b, len_a, len_b;
+  HOST_WIDE_INT low_a, high_a, low_b, high_b;
+
+  if (!operand_equal_p (DR_BASE_ADDRESS (dr_a), DR_BASE_ADDRESS (dr_b), 0)
+      || !operand_equal_p (DR_OFFSET (dr_a), DR_OFFSET (dr_b), 0)
+      || !operand_equal_p (DR_STEP (dr_a), DR_STEP (dr_b), 0)
+      || !host_integerp (DR_INIT (dr_a), 0)
+      || !host_integerp (DR_INIT (dr_b), 0))
+    return false;
+
+  init_a = tree_low_cst (DR_INIT (dr_a), 0);
+  init_b = tree_low_cst (DR_INIT (dr_b), 0);
+  len_a = tree_low_cst (seg_a->seg_len, 0);
+  len_b = tree_low_cst (seg_b->seg_len, 0);
+
+  /* The bytes of the segments relative to the common base.  As the steps
+     are the same, both segments extend in the same direction.  */
+  low_a = MIN (init_a, init_a + len_a);
+  high_a = MAX (init_a, init_a + len_a);
+  low_b = MIN (init_b, init_b + len_b);
+  high_b = MAX (init_b, init_b + len_b);
+  if (low_b > high_a || low_a > high_b)
+    return false;
+
+  /* The merged segment starts at the lowest data reference when accessed
+     upwards and at the highest one when accessed downwards.  */
+  if (len_a >= 0)
+    {
+      if (init_b < init_a)
+	seg_a->dr = dr_b;
+      seg_a->seg_len = ssize_int (MAX (high_a, high_b) - MIN (init_a, init_b));
+    }
+  else
+    {
+      if (init_b > init_a)
+	seg_a->dr = dr_b;
+      seg_a->seg_len = ssize_int (MIN (low_a, low_b) - MAX (init_a, init_b));
+    }
+
+  return true;
+}
+
+/* Try to merge the pair of segments PAIR_B into PAIR_A: if they have a
+   segment in common, the check of PAIR_A is extended to the union of
+   their other segments.  Return true on success.  */
+
+static bool
+vect_merge_segment_pairs (dr_with_seg_len_pair *pair_a,
+			  const dr_with_seg_len_pair *pair_b)
+{
+  return ((vect_same_segment_p (&pair_a->first, &pair_b->first)
+	   && vect_merge_segments (&pair_a->second, &pair_b->second))
+	  || (vect_same_segment_p (&pair_a->first, &pair_b->second)
+	      && vect_merge_segments (&pair_a->second, &pair_b->first))
+	  || (vect_same_segment_p (&pair_a->second, &pair_b->first)
+	      && vect_merge_segments (&pair_a->first, &pair_b->second))
+	  || (vect_same_segment_p (&pair_a->second, &pair_b->second)
+	      && vect_merge_segments (&pair_a->first, &pair_b->first)));
+}
+
 /* Function vect_prune_runtime_alias_test_list.
 
-   Prune a list of ddrs to be tested at run-time by versioning for alias.
-   Return FALSE if resulting list of ddrs is longer then allowed by
-   PARAM_VECT_MAX_VERSION_FOR_ALIAS_CHECKS, otherwise return TRUE.  */
+   Prune a list of ddrs to be tested at run-time by versioning for alias,
+   and compute the segments of memory whose overlap is tested for them in
+   LOOP_VINFO_COMP_ALIAS_DDRS, merging the segments of the data references
+   with the same base and step when they are checked against the same
+   segment.  Return FALSE if the resulting list of checks is longer than
+   allowed by PARAM_VECT_MAX_VERSION_FOR_ALIAS_CHECKS, otherwise return
+   TRUE.  */
 
 bool
 vect_prune_runtime_alias_test_list (loop_vec_info loop_vinfo)
 {
   VEC (ddr_p, heap) * ddrs =
     LOOP_VINFO_MAY_ALIAS_DDRS (loop_vinfo);
+  VEC (dr_with_seg_len_pair, heap) *comp_alias_ddrs;
+  int vect_factor = LOOP_VINFO_VECT_FACTOR (loop_vinfo);
+  dr_with_seg_len_pair *pair;
+  ddr_p ddr;
   unsigned i, j;
+  bool merged;
 
   if (vect_print_dump_info (REPORT_DETAILS))
     fprintf (vect_dump, "=== vect_prune_runtime_alias_test_list ===");
@@ -2390,7 +2561,62 @@ vect_prune_runtime_alias_test_list (loop_vec_info loop_vinfo)
       i++;
     }
 
-  if (VEC_length (ddr_p, ddrs) >
+  comp_alias_ddrs = VEC_alloc (dr_with_seg_len_pair, heap,
+			       VEC_length (ddr_p, ddrs));
+  FOR_EACH_VEC_ELT (ddr_p, ddrs, i, ddr)
+    {
+      dr_with_seg_len_pair new_pair;
+
+      new_pair.first = vect_vfa_segment (DDR_A (ddr), vect_factor);
+      new_pair.second = vect_vfa_segment (DDR_B (ddr), vect_factor);
+      VEC_quick_push (dr_with_seg_len_pair, comp_alias_ddrs, &new_pair);
+    }
+
+  /* Merge the checks against the same segment.  As merging extends the
+     segments, it may enable more merging, so iterate until nothing
+     changes.  */
+  do
+    {
+      merged = false;
+      for (i = 0; VEC_iterate (dr_with_seg_len_pair, comp_alias_ddrs, i, pair);
+	   i++)
+	for (j = i + 1; j < VEC_length (dr_with_seg_len_pair, comp_alias_ddrs); )
+	  {
+	    dr_with_seg_len_pair *pair_j
+	      = VEC_index (dr_with_seg_len_pair, comp_alias_ddrs, j);
+
+	    if (vect_merge_segment_pairs (pair, pair_j))
+	      {
+		if (vect_print_dump_info (REPORT_DR_DETAILS))
+		  {
+		    fprintf (vect_dump, "merged alias checks between ");
+		    print_generic_expr (vect_dump, DR_REF (pair->first.dr),
+					TDF_SLIM);
+		    fprintf (vect_dump, " and ");
+		    print_generic_expr (vect_dump, DR_REF (pair->second.dr),
+					TDF_SLIM);
+		  }
+		VEC_ordered_remove (dr_with_seg_len_pair, comp_alias_ddrs, j);
+		merged = true;
+	      }
+	    else
+	      j++;
+	  }
+    }
+  while (merged);
+
+  if (vect_print_dump_info (REPORT_DETAILS)
+      && VEC_length (dr_with_seg_len_pair, comp_alias_ddrs)
+	 < VEC_length (ddr_p, ddrs))
+    fprintf (vect_dump, "improved number of alias checks from %u to %u",
+	     VEC_length (ddr_p, ddrs),
+	     VEC_length (dr_with_seg_len_pair, comp_alias_ddrs));
+
+  VEC_free (dr_with_seg_len_pair, heap,
+	    LOOP_VINFO_COMP_ALIAS_DDRS (loop_vinfo));
+  LOOP_VINFO_COMP_ALIAS_DDRS (loop_vinfo) = comp_alias_ddrs;
+
+  if (VEC_length (dr_with_seg_len_pair, comp_alias_ddrs) >
        (unsigned) PARAM_VALUE (PARAM_VECT_MAX_VERSION_FOR_ALIAS_CHECKS))
     {
       if (vect_print_dump_info (REPORT_DR_DETAILS))
@@ -2401,6 +2627,7 @@ vect_prune_runtime_alias_test_list (loop_vec_info loop_vinfo)
 	}
 
       VEC_truncate (ddr_p, LOOP_VINFO_MAY_ALIAS_DDRS (loop_vinfo), 0);
+      VEC_truncate (dr_with_seg_len_pair, comp_alias_ddrs, 0);
 
       return false;
     }
@@ -2409,6 +2636,198 @@ vect_prune_runtime_alias_test_list (loop_vec_info loop_vinfo)
 }
 
 
+/* Function vect_check_gather.
+
+   Check whether the load STMT in the loop described by LOOP_VINFO reads
+   from an address of the form BASE + (sizetype) (OFFTYPE) OFF * SCALE,
+   where BASE is invariant in the loop and OFF is an SSA_NAME defined in
+   the loop, so that it can be vectorized as a gather of one element per
+   lane of the vectorized OFF.  If so, store the parts of the address in
+   *BASEP, *OFFP, *OFFTYPEP and *SCALEP (each of which may be NULL) and
+   return true.  */
+
+bool
+vect_check_gather (gimple stmt, loop_vec_info loop_vinfo, tree *basep,
+		   tree *offp, tree *offtypep, int *scalep)
+{
+  HOST_WIDE_INT scale = 1, pbitpos, pbitsize;
+  struct loop *loop = LOOP_VINFO_LOOP (loop_vinfo);
+  stmt_vec_info stmt_info = vinfo_for_stmt (stmt);
+  struct data_reference *dr = STMT_VINFO_DATA_REF (stmt_info);
+  tree scalar_type = TREE_TYPE (DR_REF (dr));
+  tree offtype = NULL_TREE;
+  tree base, off;
+  enum machine_mode pmode;
+  int punsignedp, pvolatilep;
+
+  /* Every lane is loaded by a separate scalar MEM_REF of the type of the
+     reference, which must therefore not be a bit-field or a member of a
+     packed structure.  */
+  if (contains_packed_reference (DR_REF (dr)))
+    return false;
+
+  base = get_inner_reference (DR_REF (dr), &pbitsize, &pbitpos, &off,
+			      &pmode, &punsignedp, &pvolatilep, false);
+  gcc_assert (base != NULL_TREE);
+  if (pbitpos % BITS_PER_UNIT != 0
+      || !host_integerp (TYPE_SIZE (scalar_type), 1)
+      || pbitsize != tree_low_cst (TYPE_SIZE (scalar_type), 1))
+    return false;
+
+  if (TREE_CODE (base) == MEM_REF)
+    {
+      if (!integer_zerop (TREE_OPERAND (base, 1)))
+	{
+	  if (off == NULL_TREE)
+	    off = double_int_to_tree (sizetype, mem_ref_offset (base));
+	  else
+	    off = size_binop (PLUS_EXPR, off,
+			      fold_convert (sizetype, TREE_OPERAND (base, 1)));
+	}
+      base = TREE_OPERAND (base, 0);
+    }
+  else
+    base = build_fold_addr_expr (base);
+
+  if (off == NULL_TREE)
+    off = size_zero_node;
+
+  /* If BASE is not invariant in the loop, it has to be the whole
+     variable part of the address.  */
+  if (!expr_invariant_in_loop_p (loop, base))
+    {
+      if (!integer_zerop (off))
+	return false;
+      off = base;
+      base = size_int (pbitpos / BITS_PER_UNIT);
+    }
+  else
+    {
+      base = fold_convert (sizetype, base);
+      base = size_binop (PLUS_EXPR, base, size_int (pbitpos / BITS_PER_UNIT));
+    }
+
+  /* Peel the loop invariant parts of OFF into BASE, and a constant
+     multiplier into SCALE, until OFF is an SSA_NAME that cannot be
+     decomposed further.  Stop at the first widening conversion: OFFTYPE
+     is then the type whose sign determines how OFF is extended.  */
+  STRIP_NOPS (off);
+  while (offtype == NULL_TREE)
+    {
+      enum tree_code code;
+      tree op0, op1, add;
+
+      if (TREE_CODE (off) == SSA_NAME)
+	{
+	  gimple def_stmt = SSA_NAME_DEF_STMT (off);
+
+	  if (expr_invariant_in_loop_p (loop, off))
+	    return false;
+
+	  if (gimple_code (def_stmt) != GIMPLE_ASSIGN)
+	    break;
+
+	  op0 = gimple_assign_rhs1 (def_stmt);
+	  code = gimple_assign_rhs_code (def_stmt);
+	  op1 = gimple_assign_rhs2 (def_stmt);
+	}
+      else
+	{
+	  if (get_gimple_rhs_class (TREE_CODE (off)) == GIMPLE_TERNARY_RHS)
+	    return false;
+	  code = TREE_CODE (off);
+	  extract_ops_from_tree (off, &code, &op0, &op1);
+	}
+
+      switch (code)
+	{
+	case POINTER_PLUS_EXPR:
+	case PLUS_EXPR:
+	  if (expr_invariant_in_loop_p (loop, op0))
+	    {
+	      add = op0;
+	      off = op1;
+	    }
+	  else if (expr_invariant_in_loop_p (loop, op1))
+	    {
+	      add = op1;
+	      off = op0;
+	    }
+	  else
+	    break;
+	  add = fold_convert (sizetype, add);
+	  if (scale != 1)
+	    add = size_binop (MULT_EXPR, add, size_int (scale));
+	  base = size_binop (PLUS_EXPR, base, add);
+	  continue;
+
+	case MINUS_EXPR:
+	  if (!expr_invariant_in_loop_p (loop, op1))
+	    break;
+	  add = fold_convert (sizetype, op1);
+	  if (scale != 1)
+	    add = size_binop (MULT_EXPR, add, size_int (scale));
+	  base = size_binop (MINUS_EXPR, base, add);
+	  off = op0;
+	  continue;
+
+	case MULT_EXPR:
+	  if (scale != 1 || !host_integerp (op1, 0))
+	    break;
+	  scale = tree_low_cst (op1, 0);
+	  off = op0;
+	  continue;
+
+	case SSA_NAME:
+	  off = op0;
+	  continue;
+
+	CASE_CONVERT:
+	  if (!POINTER_TYPE_P (TREE_TYPE (op0))
+	      && !INTEGRAL_TYPE_P (TREE_TYPE (op0)))
+	    break;
+	  if (TYPE_PRECISION (TREE_TYPE (op0))
+	      == TYPE_PRECISION (TREE_TYPE (off)))
+	    {
+	      off = op0;
+	      continue;
+	    }
+	  if (TYPE_PRECISION (TREE_TYPE (op0))
+	      < TYPE_PRECISION (TREE_TYPE (off)))
+	    {
+	      off = op0;
+	      offtype = TREE_TYPE (off);
+	      STRIP_NOPS (off);
+	      continue;
+	    }
+	  break;
+
+	default:
+	  break;
+	}
+      break;
+    }
+
+  /* OFF must be computed in the loop, where it gets vectorized.  */
+  if (TREE_CODE (off) != SSA_NAME
+      || expr_invariant_in_loop_p (loop, off))
+    return false;
+
+  if (offtype == NULL_TREE)
+    offtype = TREE_TYPE (off);
+
+  if (basep)
+    *basep = base;
+  if (offp)
+    *offp = off;
+  if (offtypep)
+    *offtypep = offtype;
+  if (scalep)
+    *scalep = scale;
+  return true;
+}
+
+
 /* Function vect_analyze_data_refs.
 
   Find all the data references in the loop or basic block.
@@ -2484,6 +2903,7 @@ vect_analyze_data_refs (loop_vec_info loop_vinfo,
       gimple stmt;
       stmt_vec_info stmt_info;
       tree base, offset, init;
+      bool gather = false;
       int vf;
 
       if (!dr || !DR_REF (dr))
@@ -2500,23 +2920,32 @@ vect_analyze_data_refs (loop_vec_info loop_vinfo,
       if (!DR_BASE_ADDRESS (dr) || !DR_OFFSET (dr) || !DR_INIT (dr)
           || !DR_STEP (dr))
         {
-          if (vect_print_dump_info (REPORT_UNVECTORIZED_LOCATIONS))
-            {
-              fprintf (vect_dump, "not vectorized: data ref analysis failed ");
-              print_gimple_stmt (vect_dump, stmt, 0, TDF_SLIM);
-            }
+	  /* A load from an address that does not evolve affinely in the
+	     loop may still be vectorized as a gather, checked below.  */
+	  gather = (loop_vinfo
+		    && DR_IS_READ (dr)
+		    && !nested_in_vect_loop_p (loop, stmt));
+	  if (!gather)
+	    {
+	      if (vect_print_dump_info (REPORT_UNVECTORIZED_LOCATIONS))
+		{
+		  fprintf (vect_dump,
+			   "not vectorized: data ref analysis failed ");
+		  print_gimple_stmt (vect_dump, stmt, 0, TDF_SLIM);
+		}
 
-          if (bb_vinfo)
-            {
-              /* Mark the statement as not vectorizable.  */
-              STMT_VINFO_VECTORIZABLE (stmt_info) = false;
-              continue;
-            }
-          else
-            return false;
+	      if (bb_vinfo)
+		{
+		  /* Mark the statement as not vectorizable.  */
+		  STMT_VINFO_VECTORIZABLE (stmt_info) = false;
+		  continue;
+		}
+	      else
+		return false;
+	    }
         }
 
-      if (TREE_CODE (DR_BASE_ADDRESS (dr)) == INTEGER_CST)
+      if (!gather && TREE_CODE (DR_BASE_ADDRESS (dr)) == INTEGER_CST)
         {
           if (vect_print_dump_info (REPORT_UNVECTORIZED_LOCATIONS))
             fprintf (vect_dump, "not vectorized: base addr of dr is a "
@@ -2554,7 +2983,7 @@ vect_analyze_data_refs (loop_vec_info loop_vinfo,
 	 inner-most enclosing loop).  We do that by building a reference to the
 	 first location accessed by the inner-loop, and analyze it relative to
 	 the outer-loop.  */
-      if (loop && nested_in_vect_loop_p (loop, stmt))
+      if (!gather && loop && nested_in_vect_loop_p (loop, stmt))
 	{
 	  tree outer_step, outer_base, outer_init;
 	  HOST_WIDE_INT pbitsize, pbitpos;
@@ -2692,6 +3121,38 @@ vect_analyze_data_refs (loop_vec_info loop_vinfo,
             return false;
         }
 
+      if (gather)
+	{
+	  tree off;
+
+	  if (!vect_check_gather (stmt, loop_vinfo, &base, &off, NULL, NULL)
+	      || !get_vectype_for_scalar_type (TREE_TYPE (off)))
+	    {
+	      if (vect_print_dump_info (REPORT_UNVECTORIZED_LOCATIONS))
+		{
+		  fprintf (vect_dump,
+			   "not vectorized: data ref analysis failed ");
+		  print_gimple_stmt (vect_dump, stmt, 0, TDF_SLIM);
+		}
+	      return false;
+	    }
+
+	  /* The elements are loaded one by one, so the data-ref has no
+	     step and no alignment of its own.  */
+	  DR_BASE_ADDRESS (dr) = base;
+	  DR_OFFSET (dr) = size_zero_node;
+	  DR_INIT (dr) = size_zero_node;
+	  DR_STEP (dr) = size_zero_node;
+	  DR_ALIGNED_TO (dr) = size_one_node;
+	  STMT_VINFO_GATHER_P (stmt_info) = true;
+
+	  if (vect_print_dump_info (REPORT_DETAILS))
+	    {
+	      fprintf (vect_dump, "gather load with offset ");
+	      print_generic_expr (vect_dump, off, TDF_SLIM);
+	    }
+	}
+
       /* Adjust the minimal vectorization factor according to the
 	 vector type.  */
       vf = TYPE_VECTOR_SUBPARTS (STMT_VINFO_VECTYPE (stmt_info));
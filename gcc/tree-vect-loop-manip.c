@@ -2345,38 +2345,6 @@ vect_create_cond_for_align_checks (loop_vec_info loop_vinfo,
 }
 
 
-/* Function vect_vfa_segment_size.
-
-   Create an expression that computes the size of segment
-   that will be accessed for a data reference.  The functions takes into
-   account that realignment loads may access one more vector.
-
-   Input:
-     DR: The data reference.
-     VECT_FACTOR: vectorization factor.
-
-   Return an expression whose value is the size of segment which will be
-   accessed by DR.  */
-
-static tree
-vect_vfa_segment_size (struct data_reference *dr, tree vect_factor)
-{
-  tree segment_length = fold_build2 (MULT_EXPR, integer_type_node,
-			             DR_STEP (dr), vect_factor);
-
-  if (vect_supportable_dr_alignment (dr, false)
-        == dr_explicit_realign_optimized)
-    {
-      tree vector_size = TYPE_SIZE_UNIT
-			  (STMT_VINFO_VECTYPE (vinfo_for_stmt (DR_STMT (dr))));
-
-      segment_length = fold_build2 (PLUS_EXPR, integer_type_node,
-				    segment_length, vector_size);
-    }
-  return fold_convert (sizetype, segment_length);
-}
-
-
 /* Function vect_create_cond_for_alias_checks.
 
    Create a conditional expression that represents the run-time checks for
@@ -2386,8 +2354,9 @@ vect_vfa_segment_size (struct data_reference *dr, tree vect_factor)
    Input:
    COND_EXPR  - input conditional expression.  New conditions will be chained
                 with logical AND operation.
-   LOOP_VINFO - field LOOP_VINFO_MAY_ALIAS_STMTS contains the list of ddrs
-	        to be checked.
+   LOOP_VINFO - field LOOP_VINFO_COMP_ALIAS_DDRS contains the list of pairs
+		of segments to be checked, computed from the ddrs by
+		vect_prune_runtime_alias_test_list.
 
    Output:
    COND_EXPR - conditional expression.
@@ -2405,12 +2374,10 @@ vect_create_cond_for_alias_checks (loop_vec_info loop_vinfo,
 				   gimple_seq * cond_expr_stmt_list)
 {
   struct loop *loop = LOOP_VINFO_LOOP (loop_vinfo);
-  VEC (ddr_p, heap) * may_alias_ddrs =
-    LOOP_VINFO_MAY_ALIAS_DDRS (loop_vinfo);
-  tree vect_factor =
-    build_int_cst (integer_type_node, LOOP_VINFO_VECT_FACTOR (loop_vinfo));
+  VEC (dr_with_seg_len_pair, heap) * comp_alias_ddrs =
+    LOOP_VINFO_COMP_ALIAS_DDRS (loop_vinfo);
 
-  ddr_p ddr;
+  dr_with_seg_len_pair *pair;
   unsigned int i;
   tree part_cond_expr;
 
@@ -2423,45 +2390,28 @@ vect_create_cond_for_alias_checks (loop_vec_info loop_vinfo,
      ((store_ptr_n + store_segment_length_n) < load_ptr_n)
      || (load_ptr_n + load_segment_length_n) < store_ptr_n))  */
 
-  if (VEC_empty (ddr_p, may_alias_ddrs))
+  if (VEC_empty (dr_with_seg_len_pair, comp_alias_ddrs))
     return;
 
-  FOR_EACH_VEC_ELT (ddr_p, may_alias_ddrs, i, ddr)
+  FOR_EACH_VEC_ELT (dr_with_seg_len_pair, comp_alias_ddrs, i, pair)
     {
-      struct data_reference *dr_a, *dr_b;
-      gimple dr_group_first_a, dr_group_first_b;
+      struct data_reference *dr_a = pair->first.dr;
+      struct data_reference *dr_b = pair->second.dr;
       tree addr_base_a, addr_base_b;
       tree segment_length_a, segment_length_b;
-      gimple stmt_a, stmt_b;
       tree seg_a_min, seg_a_max, seg_b_min, seg_b_max;
 
-      dr_a = DDR_A (ddr);
-      stmt_a = DR_STMT (DDR_A (ddr));
-      dr_group_first_a = DR_GROUP_FIRST_DR (vinfo_for_stmt (stmt_a));
-      if (dr_group_first_a)
-        {
-	  stmt_a = dr_group_first_a;
-	  dr_a = STMT_VINFO_DATA_REF (vinfo_for_stmt (stmt_a));
-	}
-
-      dr_b = DDR_B (ddr);
-      stmt_b = DR_STMT (DDR_B (ddr));
-      dr_group_first_b = DR_GROUP_FIRST_DR (vinfo_for_stmt (stmt_b));
-      if (dr_group_first_b)
-        {
-	  stmt_b = dr_group_first_b;
-	  dr_b = STMT_VINFO_DATA_REF (vinfo_for_stmt (stmt_b));
-	}
-
       addr_base_a =
-        vect_create_addr_base_for_vector_ref (stmt_a, cond_expr_stmt_list,
+        vect_create_addr_base_for_vector_ref (DR_STMT (dr_a),
+					      cond_expr_stmt_list,
 					      NULL_TREE, loop);
       addr_base_b =
-        vect_create_addr_base_for_vector_ref (stmt_b, cond_expr_stmt_list,
+        vect_create_addr_base_for_vector_ref (DR_STMT (dr_b),
+					      cond_expr_stmt_list,
 					      NULL_TREE, loop);
 
-      segment_length_a = vect_vfa_segment_size (dr_a, vect_factor);
-      segment_length_b = vect_vfa_segment_size (dr_b, vect_factor);
+      segment_length_a = fold_convert (sizetype, pair->first.seg_len);
+      segment_length_b = fold_convert (sizetype, pair->second.seg_len);
 
       if (vect_print_dump_info (REPORT_DR_DETAILS))
 	{
@@ -2475,13 +2425,13 @@ vect_create_cond_for_alias_checks (loop_vec_info loop_vinfo,
       seg_a_min = addr_base_a;
       seg_a_max = fold_build2 (POINTER_PLUS_EXPR, TREE_TYPE (addr_base_a), 
 			       addr_base_a, segment_length_a);
-      if (tree_int_cst_compare (DR_STEP (dr_a), size_zero_node) < 0)
+      if (tree_int_cst_sgn (pair->first.seg_len) < 0)
 	seg_a_min = seg_a_max, seg_a_max = addr_base_a;
 
       seg_b_min = addr_base_b;
       seg_b_max = fold_build2 (POINTER_PLUS_EXPR, TREE_TYPE (addr_base_b),
 			       addr_base_b, segment_length_b);
-      if (tree_int_cst_compare (DR_STEP (dr_b), size_zero_node) < 0)
+      if (tree_int_cst_sgn (pair->second.seg_len) < 0)
 	seg_b_min = seg_b_max, seg_b_max = addr_base_b;
 
       part_cond_expr =
@@ -2498,7 +2448,7 @@ vect_create_cond_for_alias_checks (loop_vec_info loop_vinfo,
 
   if (vect_print_dump_info (REPORT_VECTORIZED_LOCATIONS))
     fprintf (vect_dump, "created %u versioning for alias checks.\n",
-             VEC_length (ddr_p, may_alias_ddrs));
+             VEC_length (dr_with_seg_len_pair, comp_alias_ddrs));
 }
 
 
@@ -755,6 +755,7 @@ new_loop_vec_info (struct loop *loop)
   LOOP_VINFO_MAY_ALIAS_DDRS (res) =
     VEC_alloc (ddr_p, heap,
                PARAM_VALUE (PARAM_VECT_MAX_VERSION_FOR_ALIAS_CHECKS));
+  LOOP_VINFO_COMP_ALIAS_DDRS (res) = NULL;
   LOOP_VINFO_STRIDED_STORES (res) = VEC_alloc (gimple, heap, 10);
   LOOP_VINFO_REDUCTIONS (res) = VEC_alloc (gimple, heap, 10);
   LOOP_VINFO_SLP_INSTANCES (res) = VEC_alloc (slp_instance, heap, 10);
@@ -797,6 +798,8 @@ destroy_loop_vec_info (loop_vec_info loop_vinfo, bool clean_stmts)
       VEC_free (loop_p, heap, LOOP_VINFO_LOOP_NEST (loop_vinfo));
       VEC_free (gimple, heap, LOOP_VINFO_MAY_MISALIGN_STMTS (loop_vinfo));
       VEC_free (ddr_p, heap, LOOP_VINFO_MAY_ALIAS_DDRS (loop_vinfo));
+      VEC_free (dr_with_seg_len_pair, heap,
+		LOOP_VINFO_COMP_ALIAS_DDRS (loop_vinfo));
 
       free (loop_vinfo);
       loop->aux = NULL;
@@ -845,6 +848,8 @@ destroy_loop_vec_info (loop_vec_info loop_vinfo, bool clean_stmts)
   VEC_free (loop_p, heap, LOOP_VINFO_LOOP_NEST (loop_vinfo));
   VEC_free (gimple, heap, LOOP_VINFO_MAY_MISALIGN_STMTS (loop_vinfo));
   VEC_free (ddr_p, heap, LOOP_VINFO_MAY_ALIAS_DDRS (loop_vinfo));
+  VEC_free (dr_with_seg_len_pair, heap,
+	    LOOP_VINFO_COMP_ALIAS_DDRS (loop_vinfo));
   slp_instances = LOOP_VINFO_SLP_INSTANCES (loop_vinfo);
   FOR_EACH_VEC_ELT (slp_instance, slp_instances, j, instance)
     vect_free_slp_instance (instance);
@@ -1496,26 +1501,28 @@ vect_analyze_loop_2 (loop_vec_info loop_vinfo)
       return false;
     }
 
-  /* Prune the list of ddrs to be tested at run-time by versioning for alias.
-     It is important to call pruning after vect_analyze_data_ref_accesses,
-     since we use grouping information gathered by interleaving analysis.  */
-  ok = vect_prune_runtime_alias_test_list (loop_vinfo);
+  /* This pass will decide on using loop versioning and/or loop peeling in
+     order to enhance the alignment of data references in the loop.  */
+
+  ok = vect_enhance_data_refs_alignment (loop_vinfo);
   if (!ok)
     {
       if (vect_print_dump_info (REPORT_DETAILS))
-	fprintf (vect_dump, "too long list of versioning for alias "
-			    "run-time tests.");
+        fprintf (vect_dump, "bad data alignment.");
       return false;
     }
 
-  /* This pass will decide on using loop versioning and/or loop peeling in
-     order to enhance the alignment of data references in the loop.  */
-
-  ok = vect_enhance_data_refs_alignment (loop_vinfo);
+  /* Prune the list of ddrs to be tested at run-time by versioning for alias.
+     It is important to call pruning after vect_analyze_data_ref_accesses,
+     since we use grouping information gathered by interleaving analysis,
+     and after vect_enhance_data_refs_alignment, since the length of the
+     segments to check depends on how the data references are aligned.  */
+  ok = vect_prune_runtime_alias_test_list (loop_vinfo);
   if (!ok)
     {
       if (vect_print_dump_info (REPORT_DETAILS))
-        fprintf (vect_dump, "bad data alignment.");
+	fprintf (vect_dump, "too long list of versioning for alias "
+			    "run-time tests.");
       return false;
     }
 
@@ -2231,12 +2238,15 @@ vect_estimate_min_profitable_iters (loop_vec_info loop_vinfo)
                  "versioning to treat misalignment.\n");
     }
 
-  /* Requires loop versioning with alias checks.  */
+  /* Requires loop versioning with alias checks.  Each check compares the
+     bounds of two segments twice and combines the results with the other
+     checks.  */
   if (LOOP_REQUIRES_VERSIONING_FOR_ALIAS (loop_vinfo))
     {
-      /*  FIXME: Make cost depend on complexity of individual check.  */
       vec_outside_cost +=
-        VEC_length (ddr_p, LOOP_VINFO_MAY_ALIAS_DDRS (loop_vinfo));
+        VEC_length (dr_with_seg_len_pair,
+		    LOOP_VINFO_COMP_ALIAS_DDRS (loop_vinfo))
+	* 4 * vect_get_cost (scalar_stmt);
       if (vect_print_dump_info (REPORT_COST))
         fprintf (vect_dump, "cost model: Adding cost of checks for loop "
                  "versioning aliasing.\n");
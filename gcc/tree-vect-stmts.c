@@ -216,6 +216,8 @@ exist_non_indexing_operands_for_use_p (tree use, gimple stmt)
    - LIVE_P, RELEVANT - enum values to be set in the STMT_VINFO of the stmt
      that defined USE.  This is done by calling mark_relevant and passing it
      the WORKLIST (to add DEF_STMT to the WORKLIST in case it is relevant).
+   - FORCE is true if exception case 1 below should be ignored, which is
+     the case for the offset of a gather load.
 
    Outputs:
    Generally, LIVE_P and RELEVANT are used to define the liveness and
@@ -235,7 +237,8 @@ exist_non_indexing_operands_for_use_p (tree use, gimple stmt)
 
 static bool
 process_use (gimple stmt, tree use, loop_vec_info loop_vinfo, bool live_p,
-	     enum vect_relevant relevant, VEC(gimple,heap) **worklist)
+	     enum vect_relevant relevant, VEC(gimple,heap) **worklist,
+	     bool force)
 {
   struct loop *loop = LOOP_VINFO_LOOP (loop_vinfo);
   stmt_vec_info stmt_vinfo = vinfo_for_stmt (stmt);
@@ -247,7 +250,7 @@ process_use (gimple stmt, tree use, loop_vec_info loop_vinfo, bool live_p,
 
   /* case 1: we are only interested in uses that need to be vectorized.  Uses
      that are used for address computation are not considered relevant.  */
-  if (!exist_non_indexing_operands_for_use_p (use, stmt))
+  if (!force && !exist_non_indexing_operands_for_use_p (use, stmt))
      return true;
 
   if (!vect_is_simple_use (use, loop_vinfo, NULL, &def_stmt, &def, &dt))
@@ -532,7 +535,24 @@ vect_mark_stmts_to_be_vectorized (loop_vec_info loop_vinfo)
       FOR_EACH_PHI_OR_STMT_USE (use_p, stmt, iter, SSA_OP_USE)
 	{
 	  tree op = USE_FROM_PTR (use_p);
-	  if (!process_use (stmt, op, loop_vinfo, live_p, relevant, &worklist))
+	  if (!process_use (stmt, op, loop_vinfo, live_p, relevant, &worklist,
+			    false))
+	    {
+	      VEC_free (gimple, heap, worklist);
+	      return false;
+	    }
+	}
+
+      /* The offset of a gather is used as a vector, unlike the other
+	 operands of an address.  */
+      if (STMT_VINFO_GATHER_P (stmt_vinfo))
+	{
+	  tree off;
+
+	  if (!vect_check_gather (stmt, loop_vinfo, NULL, &off, NULL, NULL))
+	    gcc_unreachable ();
+	  if (!process_use (stmt, off, loop_vinfo, live_p, relevant,
+			    &worklist, true))
 	    {
 	      VEC_free (gimple, heap, worklist);
 	      return false;
@@ -802,8 +822,24 @@ vect_model_load_cost (stmt_vec_info stmt_info, int ncopies, slp_tree slp_node)
                  group_size);
     }
 
-  /* The loads themselves.  */
-  vect_get_load_cost (first_dr, ncopies,
+  /* The loads themselves.  A gather extracts each offset from its vector,
+     extends it and loads the element, and then builds the vector from the
+     elements.  */
+  if (STMT_VINFO_GATHER_P (stmt_info))
+    {
+      int nunits = TYPE_VECTOR_SUBPARTS (STMT_VINFO_VECTYPE (stmt_info));
+
+      inside_cost = ncopies
+	* (nunits * (vect_get_stmt_cost (vec_to_scalar)
+		     + vect_get_stmt_cost (scalar_stmt)
+		     + vect_get_stmt_cost (scalar_load))
+	   + vect_get_stmt_cost (vector_stmt));
+
+      if (vect_print_dump_info (REPORT_COST))
+        fprintf (vect_dump, "vect_model_load_cost: gather.");
+    }
+  else
+    vect_get_load_cost (first_dr, ncopies,
          ((!DR_GROUP_FIRST_DR (stmt_info)) || group_size > 1 || slp_node),
          &inside_cost, &outside_cost);
 
@@ -3784,6 +3820,162 @@ reverse_vec_elements (tree x, gimple stmt, gimple_stmt_iterator *gsi)
   return data_ref;
 }
 
+/* Function vect_build_gather_load.
+
+   Vectorize the gather load STMT (see vect_check_gather) into NCOPIES
+   vector stmts inserted at GSI.  Every element is loaded by a scalar load
+   from BASE + (sizetype) (OFFTYPE) OFF * SCALE, where OFF is the
+   corresponding element of the vectorized OFF, whose vector type is
+   OFF_VECTYPE, and the vector is built from the loaded elements.  The
+   first vector stmt is returned in *VEC_STMT.  */
+
+static void
+vect_build_gather_load (gimple stmt, gimple_stmt_iterator *gsi,
+			gimple *vec_stmt, int ncopies, tree base, tree off,
+			tree offtype, int scale, tree off_vectype)
+{
+  stmt_vec_info stmt_info = vinfo_for_stmt (stmt);
+  stmt_vec_info prev_stmt_info = NULL;
+  loop_vec_info loop_vinfo = STMT_VINFO_LOOP_VINFO (stmt_info);
+  struct loop *loop = LOOP_VINFO_LOOP (loop_vinfo);
+  struct data_reference *dr = STMT_VINFO_DATA_REF (stmt_info);
+  tree vectype = STMT_VINFO_VECTYPE (stmt_info);
+  tree scalar_dest = gimple_assign_lhs (stmt);
+  tree elem_type = TREE_TYPE (DR_REF (dr));
+  tree ptr_type = build_pointer_type (elem_type);
+  tree alias_off = build_int_cst (reference_alias_ptr_type (DR_REF (dr)), 0);
+  tree off_elem_type = TREE_TYPE (off_vectype);
+  tree off_elem_size = TYPE_SIZE (off_elem_type);
+  int nunits = TYPE_VECTOR_SUBPARTS (vectype);
+  int off_nunits = TYPE_VECTOR_SUBPARTS (off_vectype);
+  int off_ncopies = ncopies * nunits / off_nunits;
+  VEC (tree, heap) *vec_offs = VEC_alloc (tree, heap, off_ncopies);
+  tree vec_off = NULL_TREE;
+  tree off_var, offtype_var, size_var, ptr_var, elem_var, vec_dest;
+  gimple_seq seq = NULL;
+  gimple def_stmt;
+  tree def;
+  enum vect_def_type dt;
+  int i, j;
+
+  /* Compute the pointer to BASE before the loop.  */
+  base = force_gimple_operand (fold_convert (ptr_type, unshare_expr (base)),
+			       &seq, true, NULL_TREE);
+  if (seq)
+    {
+      basic_block new_bb
+	= gsi_insert_seq_on_edge_immediate (loop_preheader_edge (loop), seq);
+      gcc_assert (!new_bb);
+    }
+
+  /* The elements of OFF may be narrower or wider than those of the
+     loaded vector, so collect all its vector copies first.  */
+  if (!vect_is_simple_use (off, loop_vinfo, NULL, &def_stmt, &def, &dt))
+    gcc_unreachable ();
+  for (i = 0; i < off_ncopies; i++)
+    {
+      if (i == 0)
+	vec_off = vect_get_vec_def_for_operand (off, stmt, NULL);
+      else
+	vec_off = vect_get_vec_def_for_stmt_copy (dt, vec_off);
+      VEC_quick_push (tree, vec_offs, vec_off);
+    }
+
+  off_var = vect_get_new_vect_var (off_elem_type, vect_scalar_var, "goff_");
+  add_referenced_var (off_var);
+  offtype_var = vect_get_new_vect_var (offtype, vect_scalar_var, "goff_");
+  add_referenced_var (offtype_var);
+  size_var = vect_get_new_vect_var (sizetype, vect_scalar_var, "goff_");
+  add_referenced_var (size_var);
+  ptr_var = vect_get_new_vect_var (ptr_type, vect_scalar_var, "gptr_");
+  add_referenced_var (ptr_var);
+  elem_var = vect_get_new_vect_var (elem_type, vect_scalar_var, "gelem_");
+  add_referenced_var (elem_var);
+  vec_dest = vect_create_destination_var (scalar_dest, vectype);
+
+  for (j = 0; j < ncopies; j++)
+    {
+      VEC (constructor_elt, gc) *elts
+	= VEC_alloc (constructor_elt, gc, nunits);
+      gimple new_stmt;
+      tree new_temp;
+
+      for (i = 0; i < nunits; i++)
+	{
+	  int lane = j * nunits + i;
+	  tree t, ptr, elem;
+
+	  /* t = (sizetype) (OFFTYPE) BIT_FIELD_REF <vec_off, ...>;  */
+	  vec_off = VEC_index (tree, vec_offs, lane / off_nunits);
+	  t = build3 (BIT_FIELD_REF, off_elem_type, vec_off, off_elem_size,
+		      size_binop (MULT_EXPR, off_elem_size,
+				  bitsize_int (lane % off_nunits)));
+	  new_stmt = gimple_build_assign (off_var, t);
+	  t = make_ssa_name (off_var, new_stmt);
+	  gimple_assign_set_lhs (new_stmt, t);
+	  vect_finish_stmt_generation (stmt, new_stmt, gsi);
+
+	  if (!useless_type_conversion_p (offtype, off_elem_type))
+	    {
+	      new_stmt = gimple_build_assign_with_ops (NOP_EXPR, offtype_var,
+						       t, NULL_TREE);
+	      t = make_ssa_name (offtype_var, new_stmt);
+	      gimple_assign_set_lhs (new_stmt, t);
+	      vect_finish_stmt_generation (stmt, new_stmt, gsi);
+	    }
+
+	  if (!useless_type_conversion_p (sizetype, TREE_TYPE (t)))
+	    {
+	      new_stmt = gimple_build_assign_with_ops (NOP_EXPR, size_var,
+						       t, NULL_TREE);
+	      t = make_ssa_name (size_var, new_stmt);
+	      gimple_assign_set_lhs (new_stmt, t);
+	      vect_finish_stmt_generation (stmt, new_stmt, gsi);
+	    }
+
+	  /* ptr = BASE + t * SCALE;  */
+	  if (scale != 1)
+	    {
+	      new_stmt = gimple_build_assign_with_ops (MULT_EXPR, size_var, t,
+						       size_int (scale));
+	      t = make_ssa_name (size_var, new_stmt);
+	      gimple_assign_set_lhs (new_stmt, t);
+	      vect_finish_stmt_generation (stmt, new_stmt, gsi);
+	    }
+
+	  new_stmt = gimple_build_assign_with_ops (POINTER_PLUS_EXPR, ptr_var,
+						   base, t);
+	  ptr = make_ssa_name (ptr_var, new_stmt);
+	  gimple_assign_set_lhs (new_stmt, ptr);
+	  vect_finish_stmt_generation (stmt, new_stmt, gsi);
+
+	  /* elem = *ptr;  */
+	  new_stmt = gimple_build_assign (elem_var,
+					  build2 (MEM_REF, elem_type, ptr,
+						  alias_off));
+	  elem = make_ssa_name (elem_var, new_stmt);
+	  gimple_assign_set_lhs (new_stmt, elem);
+	  vect_finish_stmt_generation (stmt, new_stmt, gsi);
+
+	  CONSTRUCTOR_APPEND_ELT (elts, NULL_TREE, elem);
+	}
+
+      new_stmt = gimple_build_assign (vec_dest,
+				      build_constructor (vectype, elts));
+      new_temp = make_ssa_name (vec_dest, new_stmt);
+      gimple_assign_set_lhs (new_stmt, new_temp);
+      vect_finish_stmt_generation (stmt, new_stmt, gsi);
+
+      if (j == 0)
+	STMT_VINFO_VEC_STMT (stmt_info) = *vec_stmt = new_stmt;
+      else
+	STMT_VINFO_RELATED_STMT (prev_stmt_info) = new_stmt;
+      prev_stmt_info = vinfo_for_stmt (new_stmt);
+    }
+
+  VEC_free (tree, heap, vec_offs);
+}
+
 /* vectorizable_load.
 
    Check if STMT reads a non scalar data-ref (array/pointer/structure) that
@@ -3918,6 +4110,46 @@ vectorizable_load (gimple stmt, gimple_stmt_iterator *gsi, gimple *vec_stmt,
       return false;
     }
 
+  if (STMT_VINFO_GATHER_P (stmt_info))
+    {
+      tree gather_base, gather_off, gather_offtype, gather_off_vectype;
+      int gather_scale;
+      gimple def_stmt;
+      tree def;
+      enum vect_def_type dt;
+
+      /* FORNOW.  */
+      if (slp)
+	return false;
+
+      if (!vect_check_gather (stmt, loop_vinfo, &gather_base, &gather_off,
+			      &gather_offtype, &gather_scale))
+	gcc_unreachable ();
+      if (!vect_is_simple_use_1 (gather_off, loop_vinfo, NULL, &def_stmt,
+				 &def, &dt, &gather_off_vectype)
+	  || dt != vect_internal_def)
+	{
+	  if (vect_print_dump_info (REPORT_DETAILS))
+	    fprintf (vect_dump, "gather offset use not simple.");
+	  return false;
+	}
+
+      if (!vec_stmt) /* transformation not required.  */
+	{
+	  STMT_VINFO_TYPE (stmt_info) = load_vec_info_type;
+	  vect_model_load_cost (stmt_info, ncopies, NULL);
+	  return true;
+	}
+
+      if (vect_print_dump_info (REPORT_DETAILS))
+	fprintf (vect_dump, "transform gather load. ncopies = %d", ncopies);
+
+      vect_build_gather_load (stmt, gsi, vec_stmt, ncopies, gather_base,
+			      gather_off, gather_offtype, gather_scale,
+			      gather_off_vectype);
+      return true;
+    }
+
   /* Check if the load is a part of an interleaving chain.  */
   if (STMT_VINFO_STRIDED_ACCESS (stmt_info))
     {
@@ -4991,6 +5223,7 @@ new_stmt_vec_info (gimple stmt, loop_vec_info loop_vinfo,
   STMT_VINFO_IN_PATTERN_P (res) = false;
   STMT_VINFO_RELATED_STMT (res) = NULL;
   STMT_VINFO_DATA_REF (res) = NULL;
+  STMT_VINFO_GATHER_P (res) = false;
 
   STMT_VINFO_DR_BASE_ADDRESS (res) = NULL;
   STMT_VINFO_DR_OFFSET (res) = NULL;
@@ -169,6 +169,28 @@ typedef struct _vect_peel_extended_info
   unsigned int outside_cost;
 } *vect_peel_extended_info;
 
+/* A data reference and the segment of memory it accesses in one
+   iteration of the vectorized loop: SEG_LEN bytes (an ssizetype
+   constant) from the address of DR, downwards if SEG_LEN is negative.
+   The segment may have been extended to cover other data references
+   with the same base and step.  */
+typedef struct _dr_with_seg_len
+{
+  struct data_reference *dr;
+  tree seg_len;
+} dr_with_seg_len;
+
+/* A pair of segments that must not overlap for the vectorized version
+   of a loop to be executed.  */
+typedef struct _dr_with_seg_len_pair
+{
+  dr_with_seg_len first;
+  dr_with_seg_len second;
+} dr_with_seg_len_pair;
+
+DEF_VEC_O (dr_with_seg_len_pair);
+DEF_VEC_ALLOC_O (dr_with_seg_len_pair, heap);
+
 /*-----------------------------------------------------------------*/
 /* Info on vectorized loops.                                       */
 /*-----------------------------------------------------------------*/
@@ -229,6 +251,11 @@ typedef struct _loop_vec_info {
      for a run-time aliasing check.  */
   VEC (ddr_p, heap) *may_alias_ddrs;
 
+  /* The segments checked at run-time for overlap, computed from
+     MAY_ALIAS_DDRS by merging the data references with the same base and
+     step.  */
+  VEC (dr_with_seg_len_pair, heap) *comp_alias_ddrs;
+
   /* Statements in the loop that have data references that are candidates for a
      runtime (loop versioning) misalignment check.  */
   VEC(gimple,heap) *may_misalign_stmts;
@@ -273,6 +300,7 @@ typedef struct _loop_vec_info {
 #define LOOP_VINFO_MAY_MISALIGN_STMTS(L)   (L)->may_misalign_stmts
 #define LOOP_VINFO_LOC(L)                  (L)->loop_line_number
 #define LOOP_VINFO_MAY_ALIAS_DDRS(L)       (L)->may_alias_ddrs
+#define LOOP_VINFO_COMP_ALIAS_DDRS(L)      (L)->comp_alias_ddrs
 #define LOOP_VINFO_STRIDED_STORES(L)       (L)->strided_stores
 #define LOOP_VINFO_SLP_INSTANCES(L)        (L)->slp_instances
 #define LOOP_VINFO_SLP_UNROLLING_FACTOR(L) (L)->slp_unrolling_factor
@@ -485,6 +513,10 @@ typedef struct _stmt_vec_info {
      is 1.  */
   unsigned int gap;
 
+  /* True if this is a load whose address is not an affine function of the
+     loop index (e.g. a[idx[i]]), vectorized as a gather of the elements.  */
+  bool gather_p;
+
   /* Not all stmts in the loop need to be vectorized. e.g, the increment
      of the loop induction variable and computation of array indexes. relevant
      indicates whether the stmt needs to be vectorized.  */
@@ -535,6 +567,7 @@ typedef struct _stmt_vec_info {
 #define STMT_VINFO_DR_GROUP_SAME_DR_STMT(S)(S)->same_dr_stmt
 #define STMT_VINFO_DR_GROUP_READ_WRITE_DEPENDENCE(S)  (S)->read_write_dep
 #define STMT_VINFO_STRIDED_ACCESS(S)      ((S)->first_dr != NULL)
+#define STMT_VINFO_GATHER_P(S)            (S)->gather_p
 
 #define DR_GROUP_FIRST_DR(S)               (S)->first_dr
 #define DR_GROUP_NEXT_DR(S)                (S)->next_dr
@@ -841,6 +874,8 @@ extern int vect_get_place_in_interleaving_chain (gimple, gimple);
 extern tree vect_get_new_vect_var (tree, enum vect_var_kind, const char *);
 extern tree vect_create_addr_base_for_vector_ref (gimple, gimple_seq *,
                                                   tree, struct loop *);
+extern bool vect_check_gather (gimple, loop_vec_info, tree *, tree *, tree *,
+			       int *);
 
 /* In tree-vect-loop.c.  */
 /* FORNOW: Used in tree-parloops.c.  */
@@ -46,6 +46,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "timevar.h"
 #include "tree-pass.h"
 #include "pointer-set.h"
+#include "params.h"
 
 /* In this file value profile based optimizations are placed.  Currently the
    following optimizations are implemented (for more detailed descriptions
@@ -60,8 +61,8 @@ along with GCC; see the file COPYING3.  If not see
       FIXME: This transformation was removed together with RTL based value
       profiling.
 
-   3) Indirect/virtual call specialization. If we can determine most
-      common function callee in indirect/virtual call. We can use this
+   3) Indirect/virtual call specialization. If we can determine the most
+      common function callees in indirect/virtual call. We can use this
       information to improve code effectiveness (especially info for
       inliner).
 
@@ -291,12 +292,15 @@ dump_histogram_value (FILE *dump_file, histogram_value hist)
       fprintf (dump_file, "Indirect call ");
       if (hist->hvalue.counters)
 	{
-	   fprintf (dump_file, "value:"HOST_WIDEST_INT_PRINT_DEC
-		    " match:"HOST_WIDEST_INT_PRINT_DEC
-		    " all:"HOST_WIDEST_INT_PRINT_DEC,
-		    (HOST_WIDEST_INT) hist->hvalue.counters[0],
-		    (HOST_WIDEST_INT) hist->hvalue.counters[1],
-		    (HOST_WIDEST_INT) hist->hvalue.counters[2]);
+	   unsigned int i;
+
+	   fprintf (dump_file, "all:"HOST_WIDEST_INT_PRINT_DEC,
+		    (HOST_WIDEST_INT) hist->hvalue.counters[0]);
+	   for (i = 0; i < GCOV_ICALL_TOPN_VAL; i++)
+	     fprintf (dump_file, " value:"HOST_WIDEST_INT_PRINT_DEC
+		      " match:"HOST_WIDEST_INT_PRINT_DEC,
+		      (HOST_WIDEST_INT) hist->hvalue.counters[1 + 2 * i],
+		      (HOST_WIDEST_INT) hist->hvalue.counters[2 + 2 * i]);
 	}
       fprintf (dump_file, ".\n");
       break;
@@ -1085,6 +1089,9 @@ init_pid_map (void)
 static inline struct cgraph_node*
 find_func_by_pid (int	pid)
 {
+  if (pid < 0 || pid >= cgraph_max_pid)
+    return NULL;
+
   init_pid_map ();
 
   return pid_map [pid];
@@ -1237,20 +1244,59 @@ gimple_ic (gimple icall_stmt, struct cgraph_node *direct_call,
   return dcall_stmt;
 }
 
+/* A profiled target of an indirect call: the pid of the called function
+   and the number of calls it received.  */
+
+typedef struct
+{
+  gcov_type value;
+  gcov_type count;
+} ic_target;
+
+/* Compare the indirect call targets P1 and P2 for sorting them by
+   decreasing count.  */
+
+static int
+ic_target_cmp (const void *p1, const void *p2)
+{
+  const ic_target *t1 = (const ic_target *) p1;
+  const ic_target *t2 = (const ic_target *) p2;
+
+  if (t1->count != t2->count)
+    return t1->count > t2->count ? -1 : 1;
+  if (t1->value != t2->value)
+    return t1->value < t2->value ? -1 : 1;
+  return 0;
+}
+
 /*
-  For every checked indirect/virtual call determine if most common pid of
-  function/class method has probability more than 50%. If yes modify code of
-  this call to:
+  For every checked indirect/virtual call determine the most common pids
+  of function/class method.  Each of them that received at least
+  PARAM_INDIR_CALL_TOPN_MIN_PERCENT of the calls, at most
+  PARAM_INDIR_CALL_TOPN_MAX_TARGETS of them and starting with the most
+  common one, is promoted by modifying the code of this call to:
+
+  if (actual_callee_address == address_of_common_function/method)
+    do direct call
+  else
+    old call
+
+  where the old call is in turn modified for the next target.  The
+  direct calls can then be inlined, while the remaining indirect call
+  keeps its OBJ_TYPE_REF for a virtual call.
  */
 
 static bool
 gimple_ic_transform (gimple stmt)
 {
   histogram_value histogram;
-  gcov_type val, count, all, bb_all;
+  ic_target targets[GCOV_ICALL_TOPN_VAL];
+  gcov_type count, all, bb_all, rest;
   gcov_type prob;
   gimple modify;
   struct cgraph_node *direct_call;
+  unsigned int i, n_targets, max_targets;
+  bool transformed = false;
 
   if (gimple_code (stmt) != GIMPLE_CALL)
     return false;
@@ -1262,51 +1308,73 @@ gimple_ic_transform (gimple stmt)
   if (!histogram)
     return false;
 
-  val = histogram->hvalue.counters [0];
-  count = histogram->hvalue.counters [1];
-  all = histogram->hvalue.counters [2];
+  all = histogram->hvalue.counters [0];
+  n_targets = 0;
+  for (i = 0; i < GCOV_ICALL_TOPN_VAL; i++)
+    if (histogram->hvalue.counters [2 + 2 * i] > 0)
+      {
+	targets[n_targets].value = histogram->hvalue.counters [1 + 2 * i];
+	targets[n_targets].count = histogram->hvalue.counters [2 + 2 * i];
+	n_targets++;
+      }
   gimple_remove_histogram_value (cfun, stmt, histogram);
 
-  if (4 * count <= 3 * all)
+  if (n_targets == 0 || all <= 0)
     return false;
+  qsort (targets, n_targets, sizeof (ic_target), ic_target_cmp);
 
   bb_all = gimple_bb (stmt)->count;
-  /* The order of CHECK_COUNTER calls is important -
-     since check_counter can correct the third parameter
-     and we want to make count <= all <= bb_all. */
-  if ( check_counter (stmt, "ic", &all, &bb_all, bb_all)
-      || check_counter (stmt, "ic", &count, &all, all))
+  if (check_counter (stmt, "ic", &all, &bb_all, bb_all))
     return false;
 
-  if (all > 0)
-    prob = (count * REG_BR_PROB_BASE + all / 2) / all;
-  else
-    prob = 0;
-  direct_call = find_func_by_pid ((int)val);
+  max_targets = MIN (PARAM_VALUE (PARAM_INDIR_CALL_TOPN_MAX_TARGETS),
+		     GCOV_ICALL_TOPN_VAL);
+  rest = all;
+  for (i = 0; i < n_targets && i < max_targets; i++)
+    {
+      count = targets[i].count;
+      if (count * 100 < all * PARAM_VALUE (PARAM_INDIR_CALL_TOPN_MIN_PERCENT))
+	break;
 
-  if (direct_call == NULL)
-    return false;
+      /* COUNT <= REST <= ALL, since the counts of the targets are
+	 underestimates that sum to at most ALL.  */
+      if (check_counter (stmt, "ic", &count, &rest, rest)
+	  || count == 0)
+	break;
 
-  if (!check_ic_target (stmt, direct_call))
-    return false;
+      if (targets[i].value < 0 || targets[i].value > INT_MAX)
+	continue;
+      direct_call = find_func_by_pid ((int) targets[i].value);
+      if (direct_call == NULL)
+	continue;
 
-  modify = gimple_ic (stmt, direct_call, prob, count, all);
+      if (!check_ic_target (stmt, direct_call))
+	continue;
 
-  if (dump_file)
-    {
-      fprintf (dump_file, "Indirect call -> direct call ");
-      print_generic_expr (dump_file, gimple_call_fn (stmt), TDF_SLIM);
-      fprintf (dump_file, "=> ");
-      print_generic_expr (dump_file, direct_call->decl, TDF_SLIM);
-      fprintf (dump_file, " transformation on insn ");
-      print_gimple_stmt (dump_file, stmt, 0, TDF_SLIM);
-      fprintf (dump_file, " to ");
-      print_gimple_stmt (dump_file, modify, 0, TDF_SLIM);
-      fprintf (dump_file, "hist->count "HOST_WIDEST_INT_PRINT_DEC
-	       " hist->all "HOST_WIDEST_INT_PRINT_DEC"\n", count, all);
+      prob = (count * REG_BR_PROB_BASE + rest / 2) / rest;
+      modify = gimple_ic (stmt, direct_call, prob, count, rest);
+
+      if (dump_file)
+	{
+	  fprintf (dump_file, "Indirect call -> direct call ");
+	  print_generic_expr (dump_file, gimple_call_fn (stmt), TDF_SLIM);
+	  fprintf (dump_file, "=> ");
+	  print_generic_expr (dump_file, direct_call->decl, TDF_SLIM);
+	  fprintf (dump_file, " transformation on insn ");
+	  print_gimple_stmt (dump_file, stmt, 0, TDF_SLIM);
+	  fprintf (dump_file, " to ");
+	  print_gimple_stmt (dump_file, modify, 0, TDF_SLIM);
+	  fprintf (dump_file, "hist->count "HOST_WIDEST_INT_PRINT_DEC
+		   " hist->all "HOST_WIDEST_INT_PRINT_DEC"\n", count, rest);
+	}
+
+      rest -= count;
+      transformed = true;
+      if (rest == 0)
+	break;
     }
 
-  return true;
+  return transformed;
 }
 
 /* Return true if the stringop CALL with FNDECL shall be profiled.
@@ -1748,7 +1816,7 @@ gimple_find_values_to_profile (histogram_values *values)
 	  break;
 
  	case HIST_TYPE_INDIR_CALL:
- 	  hist->n_counters = 3;
+ 	  hist->n_counters = GCOV_ICALL_TOPN_NCOUNTS;
 	  break;
 
 	case HIST_TYPE_AVERAGE:
@@ -101,6 +101,7 @@
 #include "reload.h"
 #include "sbitmap.h"
 #include "alloc-pool.h"
+#include "arena.h"
 #include "fibheap.h"
 #include "hashtab.h"
 #include "regs.h"
@@ -385,6 +386,10 @@ static alloc_pool shared_hash_pool;
 /* Alloc pool for struct value_chain_def.  */
 static alloc_pool value_chain_pool;
 
+/* Arena for the ENTRY_VALUE locations added to the cselib values of
+   incoming parameters.  */
+static function_arena entry_value_arena;
+
 /* Changed variables, notes will be emitted for them.  */
 static htab_t changed_variables;
 
@@ -8474,8 +8479,7 @@ vt_add_function_parameter (tree parm)
 	{
 	  cselib_val *val = CSELIB_VAL_PTR (dv_as_value (dv)), *val2;
 	  struct elt_loc_list *el;
-	  el = (struct elt_loc_list *)
-	    ggc_alloc_cleared_atomic (sizeof (*el));
+	  el = ARENA_CNEW (entry_value_arena, struct elt_loc_list);
 	  el->next = val->locs;
 	  el->loc = gen_rtx_ENTRY_VALUE (GET_MODE (incoming));
 	  ENTRY_VALUE_EXP (el->loc) = incoming;
@@ -8491,8 +8495,7 @@ vt_add_function_parameter (tree parm)
 	      struct elt_loc_list *el2;
 
 	      preserve_value (val2);
-	      el2 = (struct elt_loc_list *)
-		ggc_alloc_cleared_atomic (sizeof (*el2));
+	      el2 = ARENA_CNEW (entry_value_arena, struct elt_loc_list);
 	      el2->next = val2->locs;
 	      el2->loc = dv_as_value (dv);
 	      el2->setting_insn = get_insns ();
@@ -8509,8 +8512,7 @@ vt_add_function_parameter (tree parm)
 	      if (val)
 		{
 		  preserve_value (val);
-		  el = (struct elt_loc_list *)
-		    ggc_alloc_cleared_atomic (sizeof (*el));
+		  el = ARENA_CNEW (entry_value_arena, struct elt_loc_list);
 		  el->next = val->locs;
 		  el->loc = gen_rtx_ENTRY_VALUE (indmode);
 		  ENTRY_VALUE_EXP (el->loc) = mem;
@@ -8527,8 +8529,7 @@ vt_add_function_parameter (tree parm)
 		      struct elt_loc_list *el2;
 
 		      preserve_value (val2);
-		      el2 = (struct elt_loc_list *)
-			ggc_alloc_cleared_atomic (sizeof (*el2));
+		      el2 = ARENA_CNEW (entry_value_arena, struct elt_loc_list);
 		      el2->next = val2->locs;
 		      el2->loc = val->val_rtx;
 		      el2->setting_insn = get_insns ();
@@ -8688,6 +8689,8 @@ vt_initialize (void)
       value_chain_pool = create_alloc_pool ("value_chain_def pool",
 					    sizeof (struct value_chain_def),
 					    1024);
+      if (!entry_value_arena)
+	entry_value_arena = create_function_arena ("var-tracking entry values");
       value_chains = htab_create (32, value_chain_htab_hash,
 				  value_chain_htab_eq, NULL);
     }
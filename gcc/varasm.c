@@ -53,6 +53,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "basic-block.h"
 #include "tree-iterator.h"
 #include "pointer-set.h"
+#include "params.h"
 
 #ifdef XCOFF_DEBUGGING_INFO
 #include "xcoffout.h"		/* Needed for external data
@@ -1743,6 +1744,65 @@ assemble_string (const char *p, int size)
     }
 }
 
+/* Assemble SIZE bytes of binary data at P.  This is the same as
+   assemble_string, but faster and more compact on data that are not
+   mostly text.  */
+
+void
+assemble_bytes (const unsigned char *p, unsigned HOST_WIDE_INT size)
+{
+#if defined (ASCII_DATA_ASM_OP) && defined (ESCAPES)
+  /* ASM_OUTPUT_ASCII looks for NUL-terminated strings and prints the
+     other characters one at a time.  Escape them through the same
+     table, a line at a time, instead.  */
+  char line[sizeof ASCII_DATA_ASM_OP + 4 * 64 + 3];
+  unsigned HOST_WIDE_INT pos, n, i;
+  unsigned int ch;
+  char *q;
+  int escape;
+
+  for (pos = 0; pos < size; pos += n)
+    {
+      n = MIN (size - pos, (unsigned HOST_WIDE_INT) 64);
+      q = line + sizeof ASCII_DATA_ASM_OP - 1;
+      memcpy (line, ASCII_DATA_ASM_OP, q - line);
+      *q++ = '"';
+      for (i = 0; i < n; i++)
+	{
+	  ch = p[pos + i];
+	  switch (escape = ESCAPES[ch])
+	    {
+	    case 0:
+	      *q++ = ch;
+	      break;
+	    case 1:
+	      *q++ = '\\';
+	      *q++ = '0' + (ch >> 6);
+	      *q++ = '0' + ((ch >> 3) & 7);
+	      *q++ = '0' + (ch & 7);
+	      break;
+	    default:
+	      *q++ = '\\';
+	      *q++ = escape;
+	      break;
+	    }
+	}
+      *q++ = '"';
+      *q++ = '\n';
+      fwrite (line, 1, q - line, asm_out_file);
+    }
+#else
+  while (size > 0)
+    {
+      int thissize = MIN (size, (unsigned HOST_WIDE_INT) 2000);
+
+      assemble_string ((const char *) p, thissize);
+      p += thissize;
+      size -= thissize;
+    }
+#endif
+}
+
 
 /* A noswitch_section_callback for lcomm_section.  */
 
@@ -4400,6 +4460,142 @@ static unsigned HOST_WIDE_INT
   output_constructor (tree, unsigned HOST_WIDE_INT, unsigned int,
 		      oc_outer_state *);
 
+/* Encode the constant EXP, of SIZE bytes, into BUF, which the caller
+   has cleared.  Only arrays, strings, and integer and floating point
+   scalars are handled; return false for anything else.  */
+
+static bool
+encode_constant_bytes (tree exp, unsigned char *buf,
+		       unsigned HOST_WIDE_INT size)
+{
+  tree type = TREE_TYPE (exp);
+  tree min_index = NULL_TREE;
+  unsigned HOST_WIDE_INT cnt, pos, eltsize;
+  HOST_WIDE_INT index, lo_index, hi_index;
+  constructor_elt *ce;
+  tree val;
+
+  switch (TREE_CODE (exp))
+    {
+    case INTEGER_CST:
+    case REAL_CST:
+      if (!(INTEGRAL_TYPE_P (type) || SCALAR_FLOAT_TYPE_P (type))
+	  || (unsigned HOST_WIDE_INT) int_size_in_bytes (type) != size
+	  || TYPE_PRECISION (type) > GET_MODE_BITSIZE (TYPE_MODE (type))
+	  || (SCALAR_FLOAT_TYPE_P (type)
+	      && TYPE_PRECISION (type) != GET_MODE_BITSIZE (TYPE_MODE (type))))
+	return false;
+      return (unsigned HOST_WIDE_INT) native_encode_expr (exp, buf, size)
+	     == size;
+
+    case STRING_CST:
+      memcpy (buf, TREE_STRING_POINTER (exp),
+	      MIN ((unsigned HOST_WIDE_INT) TREE_STRING_LENGTH (exp), size));
+      return true;
+
+    case CONSTRUCTOR:
+      if (TREE_CODE (type) != ARRAY_TYPE)
+	return false;
+      eltsize = int_size_in_bytes (TREE_TYPE (type));
+      if ((HOST_WIDE_INT) eltsize <= 0)
+	return false;
+      if (TYPE_DOMAIN (type) != NULL_TREE)
+	min_index = TYPE_MIN_VALUE (TYPE_DOMAIN (type));
+      if (min_index != NULL_TREE && !host_integerp (min_index, 0))
+	return false;
+
+      index = 0;
+      FOR_EACH_VEC_ELT (constructor_elt, CONSTRUCTOR_ELTS (exp), cnt, ce)
+	{
+	  if (ce->index == NULL_TREE)
+	    lo_index = hi_index = index;
+	  else if (TREE_CODE (ce->index) == RANGE_EXPR)
+	    {
+	      if (!host_integerp (TREE_OPERAND (ce->index, 0), 0)
+		  || !host_integerp (TREE_OPERAND (ce->index, 1), 0))
+		return false;
+	      lo_index = tree_low_cst (TREE_OPERAND (ce->index, 0), 0);
+	      hi_index = tree_low_cst (TREE_OPERAND (ce->index, 1), 0);
+	    }
+	  else if (host_integerp (ce->index, 0))
+	    lo_index = hi_index = tree_low_cst (ce->index, 0);
+	  else
+	    return false;
+
+	  if (ce->index != NULL_TREE && min_index != NULL_TREE)
+	    {
+	      lo_index -= tree_low_cst (min_index, 0);
+	      hi_index -= tree_low_cst (min_index, 0);
+	    }
+	  if (lo_index < 0
+	      || hi_index < lo_index
+	      || (unsigned HOST_WIDE_INT) hi_index >= size / eltsize)
+	    return false;
+
+	  val = ce->value;
+	  if (val != NULL_TREE)
+	    STRIP_NOPS (val);
+	  for (index = lo_index; index <= hi_index; index++)
+	    {
+	      pos = index * eltsize;
+	      if (val == NULL_TREE)
+		continue;
+	      if (!encode_constant_bytes (val, buf + pos, eltsize))
+		return false;
+	    }
+	}
+      return true;
+
+    default:
+      return false;
+    }
+}
+
+/* Output the array constructor EXP, of SIZE bytes, as runs of bytes
+   and zeros, if it is made of constants that encode_constant_bytes can
+   handle.  Return false otherwise.  */
+
+static bool
+output_constant_bytes (tree exp, unsigned HOST_WIDE_INT size)
+{
+  unsigned char *buf;
+  unsigned HOST_WIDE_INT pos, start, zeros;
+
+  if (BITS_PER_UNIT != 8 || CHAR_BIT != 8)
+    return false;
+
+  buf = XCNEWVEC (unsigned char, size);
+  if (!encode_constant_bytes (exp, buf, size))
+    {
+      free (buf);
+      return false;
+    }
+
+  /* Skip the long runs of zeros rather than spelling them out.  */
+  start = pos = 0;
+  while (pos < size)
+    {
+      if (buf[pos] != 0)
+	{
+	  pos++;
+	  continue;
+	}
+      for (zeros = pos; zeros < size && buf[zeros] == 0; zeros++)
+	continue;
+      if (zeros - pos >= 32 || zeros == size)
+	{
+	  assemble_bytes (buf + start, pos - start);
+	  assemble_zeros (zeros - pos);
+	  start = zeros;
+	}
+      pos = zeros;
+    }
+  assemble_bytes (buf + start, pos - start);
+
+  free (buf);
+  return true;
+}
+
 /* Output assembler code for constant EXP to FILE, with no label.
    This includes the pseudo-op such as ".int" or ".byte", and a newline.
    Assumes output_addressed_constants has been done on EXP already.
@@ -4542,7 +4738,11 @@ output_constant (tree exp, unsigned HOST_WIDE_INT size, unsigned int align)
       switch (TREE_CODE (exp))
 	{
 	case CONSTRUCTOR:
-	    output_constructor (exp, size, align, NULL);
+	  if (code == ARRAY_TYPE
+	      && size >= (unsigned) PARAM_VALUE (PARAM_MIN_BYTE_RUN_CONSTANT_SIZE)
+	      && output_constant_bytes (exp, size))
+	    return;
+	  output_constructor (exp, size, align, NULL);
 	  return;
 	case STRING_CST:
 	  thissize = MIN ((unsigned HOST_WIDE_INT)TREE_STRING_LENGTH (exp),
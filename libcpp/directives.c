@@ -613,6 +613,7 @@ do_undef (cpp_reader *pfile)
 	  if (CPP_OPTION (pfile, warn_unused_macros))
 	    _cpp_warn_if_unused_macro (pfile, node, NULL);
 
+	  _cpp_expansion_cache_forget (pfile, node);
 	  _cpp_free_definition (node);
 	}
     }
@@ -638,6 +639,7 @@ undefine_macros (cpp_reader *pfile ATTRIBUTE_UNUSED, cpp_hashnode *h,
 void
 cpp_undef_all (cpp_reader *pfile)
 {
+  _cpp_expansion_cache_forget (pfile, NULL);
   cpp_forall_identifiers (pfile, undefine_macros, NULL);
 }
 
@@ -1572,6 +1574,7 @@ do_pragma_poison (cpp_reader *pfile)
       if (hp->type == NT_MACRO)
 	cpp_error (pfile, CPP_DL_WARNING, "poisoning existing macro \"%s\"",
 		   NODE_NAME (hp));
+      _cpp_expansion_cache_forget (pfile, hp);
       _cpp_free_definition (hp);
       hp->flags |= NODE_POISONED | NODE_DIAGNOSTIC;
     }
@@ -2385,6 +2388,7 @@ cpp_pop_definition (cpp_reader *pfile, struct def_pragma_macro *c)
       if (CPP_OPTION (pfile, warn_unused_macros))
 	_cpp_warn_if_unused_macro (pfile, node, NULL);
     }
+  _cpp_expansion_cache_forget (pfile, node);
   if (node->type != NT_VOID)
     _cpp_free_definition (node);
 
@@ -38,6 +38,9 @@ cpp_diagnostic (cpp_reader * pfile, int level, int reason,
   source_location src_loc;
   bool ret;
 
+  if (pfile->expansion_record != NULL)
+    _cpp_expansion_cache_taint (pfile);
+
   if (CPP_OPTION (pfile, traditional))
     {
       if (pfile->state.in_directive)
@@ -141,6 +144,9 @@ cpp_diagnostic_with_line (cpp_reader * pfile, int level, int reason,
 {
   bool ret;
   
+  if (pfile->expansion_record != NULL)
+    _cpp_expansion_cache_taint (pfile);
+
   if (!pfile->cb.error)
     abort ();
   ret = pfile->cb.error (pfile, level, reason, src_loc, column, _(msgid), ap);
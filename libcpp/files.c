@@ -283,16 +283,18 @@ pch_open_file (cpp_reader *pfile, _cpp_file *file, bool *invalid_pch)
   char *pchname;
   struct stat st;
   bool valid = false;
+  _cpp_file *f;
 
   /* No PCH on <stdin> or if not requested.  */
   if (file->name[0] == '\0' || !pfile->cb.valid_pch)
     return false;
 
   /* If the file is not included as first include from either the toplevel
-     file or the command-line it is not a valid use of PCH.  */
-  if (pfile->all_files
-      && pfile->all_files->next_file)
-    return false;
+     file or the command-line it is not a valid use of PCH.  Files read
+     from earlier PCH files, which were not stacked, do not count.  */
+  for (f = pfile->all_files; f && f->next_file; f = f->next_file)
+    if (f->stack_count)
+      return false;
 
   flen = strlen (path);
   len = flen + sizeof (extension);
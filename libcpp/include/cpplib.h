@@ -456,6 +456,11 @@ struct cpp_options
 
   /* True disables tokenization outside of preprocessing directives. */
   bool directives_only;
+
+  /* Nonzero means to cache the expansions of the arguments of
+     function-like macros, and reuse them when a macro is invoked
+     again with the same arguments.  */
+  unsigned char expansion_cache;
 };
 
 /* Callback for header lookup for HEADER, which is the name of a
@@ -580,6 +585,7 @@ struct cpp_dir
 #define NODE_USED	(1 << 7)	/* Dumped with -dU.  */
 #define NODE_CONDITIONAL (1 << 8)	/* Conditional macro */
 #define NODE_WARN_OPERATOR (1 << 9)	/* Warn about C++ named operator.  */
+#define NODE_EXPANSION_CACHED (1 << 10)	/* Seen by a cached expansion.  */
 
 /* Different flavors of hash node.  */
 enum node_type
@@ -651,8 +657,8 @@ struct GTY(()) cpp_hashnode {
 					   then index into directive table.
 					   Otherwise, a NODE_OPERATOR.  */
   unsigned char rid_code;		/* Rid code - for front ends.  */
-  ENUM_BITFIELD(node_type) type : 6;	/* CPP node type.  */
-  unsigned int flags : 10;		/* CPP flags.  */
+  ENUM_BITFIELD(node_type) type : 5;	/* CPP node type.  */
+  unsigned int flags : 11;		/* CPP flags.  */
 
   union _cpp_hashnode_value GTY ((desc ("CPP_HASHNODE_VALUE_IDX (%1)"))) value;
 };
@@ -959,6 +965,8 @@ extern void cpp_forall_identifiers (cpp_reader *, cpp_cb, void *);
 /* In macro.c */
 extern void cpp_scan_nooutput (cpp_reader *);
 extern int  cpp_sys_macro_p (cpp_reader *);
+extern void cpp_get_expansion_cache_stats (cpp_reader *, unsigned long *,
+					   unsigned long *, unsigned long *);
 extern unsigned char *cpp_quote_string (unsigned char *, const unsigned char *,
 					unsigned int);
 
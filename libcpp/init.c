@@ -24,6 +24,7 @@ along with this program; see the file COPYING3.  If not see
 #include "system.h"
 #include "cpplib.h"
 #include "internal.h"
+#include "hashtab.h"
 #include "mkdeps.h"
 #include "localedir.h"
 #include "filenames.h"
@@ -271,8 +272,11 @@ cpp_destroy (cpp_reader *pfile)
 
   if (pfile->deps)
     deps_free (pfile->deps);
+  if (pfile->pch_macros)
+    htab_delete (pfile->pch_macros);
   obstack_free (&pfile->buffer_ob, 0);
 
+  _cpp_destroy_expansion_cache (pfile);
   _cpp_destroy_hashtable (pfile);
   _cpp_cleanup_files (pfile);
   _cpp_destroy_iconv (pfile);
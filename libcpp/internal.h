@@ -491,6 +491,11 @@ struct cpp_reader
      of precompiled headers.  */
   struct cpp_savedstate *savedstate;
 
+  /* The definitions of the macros right after the last precompiled
+     header was read, for checking a precompiled header built on top
+     of that one.  */
+  struct htab *pch_macros;
+
   /* Next value of __COUNTER__ macro. */
   unsigned int counter;
 
@@ -499,6 +504,11 @@ struct cpp_reader
 
   /* List of saved macros by push_macro.  */
   struct def_pragma_macro *pushed_macros;
+
+  /* The cache of the expansions of the arguments of function-like
+     macros, and the innermost expansion being recorded into it.  */
+  struct _cpp_expansion_cache *expansion_cache;
+  struct _cpp_expansion_record *expansion_record;
 };
 
 /* Character classes.  Based on the more primitive macros in safe-ctype.h.
@@ -561,6 +571,9 @@ extern int _cpp_warn_if_unused_macro (cpp_reader *, cpp_hashnode *, void *);
 extern void _cpp_push_token_context (cpp_reader *, cpp_hashnode *,
 				     const cpp_token *, unsigned int);
 extern void _cpp_backup_tokens_direct (cpp_reader *, unsigned int);
+extern void _cpp_expansion_cache_forget (cpp_reader *, cpp_hashnode *);
+extern void _cpp_expansion_cache_taint (cpp_reader *);
+extern void _cpp_destroy_expansion_cache (cpp_reader *);
 
 /* In identifiers.c */
 extern void _cpp_init_hashtable (cpp_reader *, hash_table *);
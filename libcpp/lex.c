@@ -264,6 +264,88 @@ search_line_acc_char (const uchar *s, const uchar *end ATTRIBUTE_UNUSED)
     }
 }
 
+/* The lexer has three more loops worth speeding up in the same way:
+   the ones skipping the characters of an identifier, the horizontal
+   whitespace between tokens and the body of a block comment.  The
+   ifdefs below provide
+
+     const uchar *skip_idnum_fast (const uchar *s);
+     const uchar *skip_hspace_fast (const uchar *s);
+     const uchar *search_comment_fast (const uchar *s);
+
+   which return a pointer to the first character at or after S which
+   is not ISIDNUM; which is neither a space nor a tab; and which is a
+   '/' or a '\n', respectively.  As for search_line_fast, the newline
+   at the end of every line stops all three.  */
+
+static const uchar * skip_idnum_scalar (const uchar *) ATTRIBUTE_UNUSED;
+static const uchar * skip_hspace_scalar (const uchar *) ATTRIBUTE_UNUSED;
+static const uchar * search_comment_acc_char (const uchar *)
+  ATTRIBUTE_UNUSED;
+
+static const uchar *
+skip_idnum_scalar (const uchar *s)
+{
+  while (ISIDNUM (*s))
+    s++;
+  return s;
+}
+
+static const uchar *
+skip_hspace_scalar (const uchar *s)
+{
+  while (*s == ' ' || *s == '\t')
+    s++;
+  return s;
+}
+
+/* Comment bodies are long enough to be worth searching a word at a
+   time, like search_line_acc_char does.  */
+
+static const uchar *
+search_comment_acc_char (const uchar *s)
+{
+  const word_type repl_sl = acc_char_replicate ('/');
+  const word_type repl_nl = acc_char_replicate ('\n');
+
+  unsigned int misalign;
+  const word_type *p;
+  word_type val, t;
+
+  p = (word_type *)((uintptr_t)s & -sizeof(word_type));
+  val = *p;
+  misalign = (uintptr_t)s & (sizeof(word_type) - 1);
+  if (misalign)
+    val = acc_char_mask_misalign (val, misalign);
+
+  while (1)
+    {
+      t  = acc_char_cmp (val, repl_sl);
+      t |= acc_char_cmp (val, repl_nl);
+
+      /* acc_char_index knows only about the characters of
+	 search_line_acc_char, so look for the index here.  */
+      if (__builtin_expect (t != 0, 0))
+	{
+	  unsigned int i;
+
+	  for (i = 0; i < sizeof(word_type); ++i)
+	    {
+	      uchar c;
+	      if (WORDS_BIGENDIAN)
+		c = (val >> (sizeof(word_type) - i - 1) * 8) & 0xff;
+	      else
+		c = (val >> i * 8) & 0xff;
+
+	      if (c == '/' || c == '\n')
+		return (const uchar *)p + i;
+	    }
+	}
+
+      val = *++p;
+    }
+}
+
 /* Disable on Solaris 2/x86 until the following problems can be properly
    autoconfed:
 
@@ -470,6 +552,204 @@ search_line_sse42 (const uchar *s, const uchar *end)
 #define search_line_sse42 search_line_sse2
 #endif
 
+/* Replicated character data for the SSE2 versions of the other fast
+   paths: the bounds of the ranges of identifier characters, exclusive
+   and in signed comparisons, the bit turning upper case letters into
+   lower case ones, which is also a space, and the other characters
+   searched for.  */
+static const char skip_chars[8][16] __attribute__((aligned(16))) = {
+  { 'a' - 1, 'a' - 1, 'a' - 1, 'a' - 1, 'a' - 1, 'a' - 1, 'a' - 1, 'a' - 1,
+    'a' - 1, 'a' - 1, 'a' - 1, 'a' - 1, 'a' - 1, 'a' - 1, 'a' - 1, 'a' - 1 },
+  { 'z' + 1, 'z' + 1, 'z' + 1, 'z' + 1, 'z' + 1, 'z' + 1, 'z' + 1, 'z' + 1,
+    'z' + 1, 'z' + 1, 'z' + 1, 'z' + 1, 'z' + 1, 'z' + 1, 'z' + 1, 'z' + 1 },
+  { '0' - 1, '0' - 1, '0' - 1, '0' - 1, '0' - 1, '0' - 1, '0' - 1, '0' - 1,
+    '0' - 1, '0' - 1, '0' - 1, '0' - 1, '0' - 1, '0' - 1, '0' - 1, '0' - 1 },
+  { '9' + 1, '9' + 1, '9' + 1, '9' + 1, '9' + 1, '9' + 1, '9' + 1, '9' + 1,
+    '9' + 1, '9' + 1, '9' + 1, '9' + 1, '9' + 1, '9' + 1, '9' + 1, '9' + 1 },
+  { 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20 },
+  { '_', '_', '_', '_', '_', '_', '_', '_',
+    '_', '_', '_', '_', '_', '_', '_', '_' },
+  { '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t',
+    '\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t' },
+  { '/', '/', '/', '/', '/', '/', '/', '/',
+    '/', '/', '/', '/', '/', '/', '/', '/' },
+};
+
+/* SSE2 versions of the other fast paths.  They use the same aligned
+   loads as search_line_sse2, so that they never read past the end of
+   the page holding the character which stops them.  */
+
+static const uchar *
+#ifndef __SSE2__
+__attribute__((__target__("sse2")))
+#endif
+skip_idnum_sse2 (const uchar *s)
+{
+  typedef char v16qi __attribute__ ((__vector_size__ (16)));
+
+  const v16qi lo_alpha = *(const v16qi *)skip_chars[0];
+  const v16qi hi_alpha = *(const v16qi *)skip_chars[1];
+  const v16qi lo_digit = *(const v16qi *)skip_chars[2];
+  const v16qi hi_digit = *(const v16qi *)skip_chars[3];
+  const v16qi case_bit = *(const v16qi *)skip_chars[4];
+  const v16qi repl_us = *(const v16qi *)skip_chars[5];
+
+  unsigned int misalign, found, mask;
+  const v16qi *p;
+  v16qi data, lower, t;
+
+  misalign = (uintptr_t)s & 15;
+  p = (const v16qi *)((uintptr_t)s & -16);
+  data = *p;
+  mask = -1u << misalign;
+
+  goto start;
+  do
+    {
+      data = *++p;
+      mask = -1;
+
+    start:
+      /* Letters are found in lower case.  Characters above 0x7f
+	 compare as negative, so are never in any range.  */
+      lower = data | case_bit;
+      t  = __builtin_ia32_pcmpgtb128 (lower, lo_alpha)
+	   & __builtin_ia32_pcmpgtb128 (hi_alpha, lower);
+      t |= __builtin_ia32_pcmpgtb128 (data, lo_digit)
+	   & __builtin_ia32_pcmpgtb128 (hi_digit, data);
+      t |= __builtin_ia32_pcmpeqb128 (data, repl_us);
+      found = ~__builtin_ia32_pmovmskb128 (t) & 0xffff;
+      found &= mask;
+    }
+  while (!found);
+
+  found = __builtin_ctz(found);
+  return (const uchar *)p + found;
+}
+
+static const uchar *
+#ifndef __SSE2__
+__attribute__((__target__("sse2")))
+#endif
+skip_hspace_sse2 (const uchar *s)
+{
+  typedef char v16qi __attribute__ ((__vector_size__ (16)));
+
+  const v16qi repl_sp = *(const v16qi *)skip_chars[4];
+  const v16qi repl_tab = *(const v16qi *)skip_chars[6];
+
+  unsigned int misalign, found, mask;
+  const v16qi *p;
+  v16qi data, t;
+
+  misalign = (uintptr_t)s & 15;
+  p = (const v16qi *)((uintptr_t)s & -16);
+  data = *p;
+  mask = -1u << misalign;
+
+  goto start;
+  do
+    {
+      data = *++p;
+      mask = -1;
+
+    start:
+      t  = __builtin_ia32_pcmpeqb128 (data, repl_sp);
+      t |= __builtin_ia32_pcmpeqb128 (data, repl_tab);
+      found = ~__builtin_ia32_pmovmskb128 (t) & 0xffff;
+      found &= mask;
+    }
+  while (!found);
+
+  found = __builtin_ctz(found);
+  return (const uchar *)p + found;
+}
+
+static const uchar *
+#ifndef __SSE2__
+__attribute__((__target__("sse2")))
+#endif
+search_comment_sse2 (const uchar *s)
+{
+  typedef char v16qi __attribute__ ((__vector_size__ (16)));
+
+  const v16qi repl_nl = *(const v16qi *)repl_chars[0];
+  const v16qi repl_sl = *(const v16qi *)skip_chars[7];
+
+  unsigned int misalign, found, mask;
+  const v16qi *p;
+  v16qi data, t;
+
+  misalign = (uintptr_t)s & 15;
+  p = (const v16qi *)((uintptr_t)s & -16);
+  data = *p;
+  mask = -1u << misalign;
+
+  goto start;
+  do
+    {
+      data = *++p;
+      mask = -1;
+
+    start:
+      t  = __builtin_ia32_pcmpeqb128 (data, repl_nl);
+      t |= __builtin_ia32_pcmpeqb128 (data, repl_sl);
+      found = __builtin_ia32_pmovmskb128 (t);
+      found &= mask;
+    }
+  while (!found);
+
+  found = __builtin_ctz(found);
+  return (const uchar *)p + found;
+}
+
+#ifdef HAVE_SSE4
+/* An SSE 4.2 version of skip_idnum_fast, which tests the ranges of
+   identifier characters with a single PCMPESTRM.  The lengths are
+   explicit, as a NUL before S in the aligned data would otherwise end
+   the string being tested.  */
+
+static const uchar *
+#ifndef __SSE4_2__
+__attribute__((__target__("sse4.2")))
+#endif
+skip_idnum_sse42 (const uchar *s)
+{
+  typedef char v16qi __attribute__ ((__vector_size__ (16)));
+  static const v16qi ranges = { 'a', 'z', 'A', 'Z', '0', '9', '_', '_' };
+
+  unsigned int misalign, found, mask;
+  const v16qi *p;
+  v16qi data, t;
+
+  misalign = (uintptr_t)s & 15;
+  p = (const v16qi *)((uintptr_t)s & -16);
+  data = *p;
+  mask = -1u << misalign;
+
+  goto start;
+  do
+    {
+      data = *++p;
+      mask = -1;
+
+    start:
+      /* Unsigned bytes, ranges, negative polarity, byte mask.  */
+      t = __builtin_ia32_pcmpestrm128 (ranges, 8, data, 16, 0x54);
+      found = __builtin_ia32_pmovmskb128 (t);
+      found &= mask;
+    }
+  while (!found);
+
+  found = __builtin_ctz(found);
+  return (const uchar *)p + found;
+}
+
+#else
+#define skip_idnum_sse42 skip_idnum_sse2
+#endif
+
 /* Check the CPU capabilities.  */
 
 #include "../gcc/config/i386/cpuid.h"
@@ -477,6 +757,11 @@ search_line_sse42 (const uchar *s, const uchar *end)
 typedef const uchar * (*search_line_fast_type) (const uchar *, const uchar *);
 static search_line_fast_type search_line_fast;
 
+typedef const uchar * (*skip_fast_type) (const uchar *);
+static skip_fast_type skip_idnum_fast;
+static skip_fast_type skip_hspace_fast;
+static skip_fast_type search_comment_fast;
+
 static void __attribute__((constructor))
 init_vectorized_lexer (void)
 {
@@ -510,6 +795,27 @@ init_vectorized_lexer (void)
     }
 
   search_line_fast = impl;
+
+  /* The MMX version of search_line_fast is not worth having for the
+     other fast paths.  */
+  if (impl == search_line_sse42)
+    {
+      skip_idnum_fast = skip_idnum_sse42;
+      skip_hspace_fast = skip_hspace_sse2;
+      search_comment_fast = search_comment_sse2;
+    }
+  else if (impl == search_line_sse2)
+    {
+      skip_idnum_fast = skip_idnum_sse2;
+      skip_hspace_fast = skip_hspace_sse2;
+      search_comment_fast = search_comment_sse2;
+    }
+  else
+    {
+      skip_idnum_fast = skip_idnum_scalar;
+      skip_hspace_fast = skip_hspace_scalar;
+      search_comment_fast = search_comment_acc_char;
+    }
 }
 
 #elif (GCC_VERSION >= 4005) && defined(__ALTIVEC__)
@@ -628,6 +934,10 @@ search_line_fast (const uchar *s, const uchar *end ATTRIBUTE_UNUSED)
   }
 }
 
+#define skip_idnum_fast  skip_idnum_scalar
+#define skip_hspace_fast  skip_hspace_scalar
+#define search_comment_fast  search_comment_acc_char
+
 #else
 
 /* We only have one accellerated alternative.  Use a direct call so that
@@ -635,6 +945,10 @@ search_line_fast (const uchar *s, const uchar *end ATTRIBUTE_UNUSED)
 
 #define search_line_fast  search_line_acc_char
 
+#define skip_idnum_fast  skip_idnum_scalar
+#define skip_hspace_fast  skip_hspace_scalar
+#define search_comment_fast  search_comment_acc_char
+
 #endif
 
 /* Returns with a logical line that contains no escaped newlines or
@@ -891,7 +1205,9 @@ _cpp_skip_block_comment (cpp_reader *pfile)
   for (;;)
     {
       /* People like decorating comments with '*', so check for '/'
-	 instead for efficiency.  */
+	 instead for efficiency.  Nothing else but the newline matters
+	 in a comment, so skip straight to the next of them.  */
+      cur = search_comment_fast (cur);
       c = *cur++;
 
       if (c == '/')
@@ -958,9 +1274,13 @@ skip_whitespace (cpp_reader *pfile, cppchar_t c)
 
   do
     {
-      /* Horizontal space always OK.  */
+      /* Horizontal space always OK.  Skip indentation and the like
+	 in one go.  */
       if (c == ' ' || c == '\t')
-	;
+	{
+	  if (*buffer->cur == ' ' || *buffer->cur == '\t')
+	    buffer->cur = skip_hspace_fast (buffer->cur);
+	}
       /* Just \f \v or \0 left.  */
       else if (c == '\0')
 	saw_NUL = true;
@@ -1127,11 +1447,13 @@ lex_identifier (cpp_reader *pfile, const uchar *base, bool starts_ucn,
 
   cur = pfile->buffer->cur;
   if (! starts_ucn)
-    while (ISIDNUM (*cur))
-      {
-	hash = HT_HASHSTEP (hash, *cur);
-	cur++;
-      }
+    {
+      const uchar *p = cur;
+
+      cur = skip_idnum_fast (cur);
+      while (p < cur)
+	hash = HT_HASHSTEP (hash, *p++);
+    }
   pfile->buffer->cur = cur;
   if (starts_ucn || forms_identifier_p (pfile, false, nst))
     {
@@ -28,6 +28,8 @@ along with this program; see the file COPYING3.  If not see
 #include "system.h"
 #include "cpplib.h"
 #include "internal.h"
+#include "obstack.h"
+#include "hashtab.h"
 
 typedef struct macro_arg macro_arg;
 struct macro_arg
@@ -898,6 +900,7 @@ enter_macro_context (cpp_reader *pfile, cpp_hashnode *node,
 
       if (pragma_buff)
 	{
+	  _cpp_expansion_cache_taint (pfile);
 	  if (!pfile->state.in_directive)
 	    _cpp_push_token_context (pfile, NULL,
 				     padding_token (pfile, result), 1);
@@ -918,10 +921,830 @@ enter_macro_context (cpp_reader *pfile, cpp_hashnode *node,
       return 1;
     }
 
-  /* Handle built-in macros and the _Pragma operator.  */
+  /* Handle built-in macros and the _Pragma operator.  Their expansion
+     cannot be cached.  */
+  _cpp_expansion_cache_taint (pfile);
   return builtin_macro (pfile, node);
 }
 
+/* The expansion cache.  Pre-expanding the arguments of function-like
+   macros is where much of the time goes in headers using the
+   preprocessor for metaprogramming, which invoke the same macros
+   with the same arguments over and over again.  With
+   -fmacro-expansion-cache, replace_args records the replacement list
+   it builds, with its arguments substituted, and reuses it when the
+   macro is invoked again with the same argument tokens.
+
+   The result depends on the macros the argument tokens expand to,
+   and on which of them are disabled, so an entry also records every
+   identifier looked up while expanding the arguments, with whether
+   it was disabled at the start of the expansion.  The entry is only
+   reused if all of them are still disabled or enabled as they were,
+   and it is dropped when any of them is defined or undefined.
+   Expansions which use builtin macros, #pragma or conditional macros,
+   or which issue a diagnostic, are not recorded.  */
+
+/* An identifier looked up while recording an expansion.  */
+struct expansion_use
+{
+  cpp_hashnode *node;
+
+  /* Whether its macro was disabled when the expansion started.  */
+  bool disabled;
+};
+
+/* An expansion being recorded.  */
+struct _cpp_expansion_record
+{
+  struct _cpp_expansion_record *prev;
+
+  /* The context the expansion started in.  */
+  cpp_context *base;
+
+  /* True if the expansion cannot be recorded.  */
+  bool tainted;
+
+  /* The location of the last token lexed, and of the current line,
+     when the expansion started.  */
+  source_location last_loc;
+  source_location line;
+
+  /* The identifiers looked up so far.  */
+  struct expansion_use *uses;
+  unsigned int nuses;
+  unsigned int uses_alloc;
+};
+
+/* The ways a token of a cached replacement list is rebuilt when the
+   expansion is reused.  Most tokens are reused as they are, but those
+   of the arguments must be those of the current invocation, and the
+   temporary identifiers created while expanding must be placed where
+   the current invocation would place them: the location of an
+   identifier is seen by the compiler proper when it names a
+   function-like macro which is not invoked.  */
+enum expansion_fixup_kind
+{
+  /* The token of argument ARG at position POS.  */
+  EXPANSION_FIXUP_ARG,
+
+  /* A temporary identifier at the location of the last token lexed.  */
+  EXPANSION_FIXUP_LAST,
+
+  /* A temporary identifier at column POS of the current line, like
+     the result of a paste.  */
+  EXPANSION_FIXUP_COLUMN
+};
+
+struct expansion_fixup
+{
+  /* The index of the token in the replacement list.  */
+  unsigned int index;
+  enum expansion_fixup_kind kind;
+  unsigned int arg, pos;
+};
+
+/* An expansion in the cache, or the key of one being looked up.  */
+struct expansion_entry
+{
+  hashval_t hash;
+
+  /* The macro, the lexer state it was invoked in, and its arguments,
+     with ARGS[I].FIRST null for an omitted variable argument.  */
+  cpp_hashnode *node;
+  unsigned int state;
+  macro_arg *args;
+
+  /* The replacement list, and how to rebuild its tokens.  */
+  const cpp_token **tokens;
+  unsigned int count;
+  struct expansion_fixup *fixups;
+  unsigned int nfixups;
+
+  /* If an EXPANSION_FIXUP_LAST token could also have been pasted, the
+     column of the last token lexed, or -1.  The expansion is reused
+     only if that token is at the same column again.  */
+  int last_column;
+
+  /* Pairs of positions in the arguments which held the same token,
+     as the argument and position of each, which must still hold the
+     same token for the expansion to be reused.  */
+  unsigned int *aliases;
+  unsigned int naliases;
+
+  /* The identifiers the expansion depends on.  */
+  struct expansion_use *uses;
+  unsigned int nuses;
+};
+
+/* The cache proper.  */
+struct _cpp_expansion_cache
+{
+  htab_t entries;
+
+  /* Where the tokens of the entries are copied.  Entries which are
+     dropped leave their tokens behind, as they may still be in a
+     context; the number of tokens copied is limited instead.  */
+  struct obstack tokens;
+  unsigned long nentries;
+  unsigned long ntokens;
+
+  /* The identifier whose entries _cpp_expansion_cache_forget drops.  */
+  cpp_hashnode *forgetting;
+
+  /* Statistics.  */
+  unsigned long lookups;
+  unsigned long hits;
+  unsigned long forgotten;
+};
+
+/* The limits on the number of entries in the cache, and on the number
+   of tokens copied for them since the start of the compilation.  */
+#define EXPANSION_CACHE_MAX_ENTRIES (1 << 18)
+#define EXPANSION_CACHE_MAX_TOKENS (1 << 20)
+
+static hashval_t
+expansion_entry_hash (const void *p)
+{
+  return ((const struct expansion_entry *) p)->hash;
+}
+
+/* Return true if the argument tokens A and B are identical.  */
+static bool
+expansion_tokens_eq (const cpp_token *a, const cpp_token *b)
+{
+  if (a->type != b->type || a->flags != b->flags)
+    return false;
+
+  switch (cpp_token_val_index ((cpp_token *) a))
+    {
+    case CPP_TOKEN_FLD_NODE:
+      return a->val.node.node == b->val.node.node;
+    case CPP_TOKEN_FLD_STR:
+      return (a->val.str.len == b->val.str.len
+	      && !memcmp (a->val.str.text, b->val.str.text, a->val.str.len));
+    case CPP_TOKEN_FLD_SOURCE:
+      if (a->val.source == NULL || b->val.source == NULL)
+	return a->val.source == b->val.source;
+      return a->val.source->flags == b->val.source->flags;
+    case CPP_TOKEN_FLD_ARG_NO:
+      return a->val.macro_arg.arg_no == b->val.macro_arg.arg_no;
+    case CPP_TOKEN_FLD_TOKEN_NO:
+      return a->val.token_no == b->val.token_no;
+    default:
+      return true;
+    }
+}
+
+static int
+expansion_entry_eq (const void *p1, const void *p2)
+{
+  const struct expansion_entry *entry = (const struct expansion_entry *) p1;
+  const struct expansion_entry *key = (const struct expansion_entry *) p2;
+  unsigned int i, j, paramc;
+
+  if (entry->node != key->node || entry->state != key->state)
+    return 0;
+
+  paramc = entry->node->value.macro->paramc;
+  for (i = 0; i < paramc; i++)
+    {
+      const macro_arg *a = &entry->args[i], *b = &key->args[i];
+
+      if ((a->first == NULL) != (b->first == NULL) || a->count != b->count)
+	return 0;
+      if (a->first != NULL)
+	for (j = 0; j < a->count; j++)
+	  if (!expansion_tokens_eq (a->first[j], b->first[j]))
+	    return 0;
+    }
+
+  return 1;
+}
+
+static void
+expansion_entry_free (void *p)
+{
+  struct expansion_entry *entry = (struct expansion_entry *) p;
+
+  free (entry->args);
+  free (entry->tokens);
+  free (entry->fixups);
+  free (entry->aliases);
+  free (entry->uses);
+  free (entry);
+}
+
+#define EXPANSION_HASH(h, v) (((h) ^ (hashval_t) (v)) * 0x01000193)
+
+/* Compute into KEY the key of the invocation of the macro of NODE with
+   ARGS.  Return false if the invocation cannot be cached.  */
+static bool
+expansion_key (cpp_reader *pfile, cpp_hashnode *node, macro_arg *args,
+	       struct expansion_entry *key)
+{
+  unsigned int i, j, paramc = node->value.macro->paramc;
+  hashval_t hash;
+
+  key->node = node;
+  key->args = args;
+  key->state = (pfile->state.in_directive
+		| pfile->state.directive_wants_padding << 1
+		| (pfile->state.prevent_expansion != 0) << 2
+		| pfile->state.in_deferred_pragma << 3
+		| (cpp_in_system_header (pfile) != 0) << 4);
+
+  /* The arguments are hashed for every invocation, so this uses a
+     cheap hash function, and the hash values of the identifiers.  */
+  hash = EXPANSION_HASH (node->ident.hash_value, key->state);
+  for (i = 0; i < paramc; i++)
+    {
+      if (args[i].first == NULL)
+	{
+	  hash = EXPANSION_HASH (hash, 0xffffffff);
+	  continue;
+	}
+
+      hash = EXPANSION_HASH (hash, args[i].count);
+      for (j = 0; j < args[i].count; j++)
+	{
+	  const cpp_token *token = args[i].first[j];
+
+	  hash = EXPANSION_HASH (hash, token->type | token->flags << CHAR_BIT);
+	  switch (cpp_token_val_index ((cpp_token *) token))
+	    {
+	    case CPP_TOKEN_FLD_NODE:
+	      hash = EXPANSION_HASH (hash,
+				     token->val.node.node->ident.hash_value);
+	      break;
+	    case CPP_TOKEN_FLD_STR:
+	      {
+		unsigned int k;
+
+		for (k = 0; k < token->val.str.len; k++)
+		  hash = EXPANSION_HASH (hash, token->val.str.text[k]);
+	      }
+	      break;
+	    case CPP_TOKEN_FLD_PRAGMA:
+	      return false;
+	    default:
+	      break;
+	    }
+	}
+    }
+  key->hash = hash;
+  return true;
+}
+
+/* Return true if the macro of NODE was disabled by a context pushed
+   since BASE.  */
+static bool
+expansion_pushed_since (cpp_reader *pfile, cpp_context *base,
+			cpp_hashnode *node)
+{
+  cpp_context *context;
+
+  for (context = pfile->context; context != base; context = context->prev)
+    if (context->macro == node)
+      return true;
+  return false;
+}
+
+/* Add to RECORD the NUSES identifiers of USES, whose disabled state is
+   relative to the current context.  */
+static void
+expansion_record_uses (cpp_reader *pfile, struct _cpp_expansion_record *record,
+		       const struct expansion_use *uses, unsigned int nuses)
+{
+  unsigned int i;
+
+  for (i = 0; i < nuses; i++)
+    {
+      struct expansion_use use;
+
+      use.node = uses[i].node;
+      use.disabled = (uses[i].disabled
+		      && !expansion_pushed_since (pfile, record->base,
+						  use.node));
+      if (record->nuses > 0
+	  && record->uses[record->nuses - 1].node == use.node
+	  && record->uses[record->nuses - 1].disabled == use.disabled)
+	continue;
+
+      if (record->nuses == record->uses_alloc)
+	{
+	  record->uses_alloc = record->uses_alloc * 2 + 16;
+	  record->uses = XRESIZEVEC (struct expansion_use, record->uses,
+				     record->uses_alloc);
+	}
+      record->uses[record->nuses++] = use;
+    }
+}
+
+/* Called by cpp_get_token when the identifier NODE is looked up while
+   an expansion is being recorded.  */
+static void
+expansion_record_lookup (cpp_reader *pfile, cpp_hashnode *node)
+{
+  struct expansion_use use;
+
+  use.node = node;
+  use.disabled = (node->flags & NODE_DISABLED) != 0;
+  expansion_record_uses (pfile, pfile->expansion_record, &use, 1);
+}
+
+/* Mark the expansions being recorded as impossible to cache.  */
+void
+_cpp_expansion_cache_taint (cpp_reader *pfile)
+{
+  struct _cpp_expansion_record *record;
+
+  for (record = pfile->expansion_record; record; record = record->prev)
+    record->tainted = true;
+}
+
+/* Return a copy of TOKEN which lives as long as the cache, unless it
+   does already, as the tokens of the definition of MACRO do.  */
+static const cpp_token *
+expansion_copy_token (cpp_reader *pfile, const cpp_token *token,
+		      const cpp_macro *macro)
+{
+  struct _cpp_expansion_cache *cache = pfile->expansion_cache;
+  cpp_token *copy;
+
+  if (token == &pfile->avoid_paste
+      || (token >= macro->exp.tokens
+	  && token < macro->exp.tokens + macro->count))
+    return token;
+
+  copy = XOBNEW (&cache->tokens, cpp_token);
+  cache->ntokens++;
+  *copy = *token;
+  if (token->type == CPP_PADDING && token->val.source != NULL)
+    copy->val.source = (cpp_token *) expansion_copy_token (pfile,
+							  token->val.source,
+							  macro);
+  return copy;
+}
+
+/* Order the identifiers of an expansion, for qsort.  */
+static int
+expansion_use_cmp (const void *p1, const void *p2)
+{
+  const struct expansion_use *a = (const struct expansion_use *) p1;
+  const struct expansion_use *b = (const struct expansion_use *) p2;
+
+  if (a->node != b->node)
+    return a->node < b->node ? -1 : 1;
+  return (int) a->disabled - (int) b->disabled;
+}
+
+/* Look up the invocation of KEY in the cache.  If it is there, push its
+   replacement list and return true.  */
+static bool
+expansion_cache_lookup (cpp_reader *pfile, struct expansion_entry *key)
+{
+  struct _cpp_expansion_cache *cache = pfile->expansion_cache;
+  struct expansion_entry *entry;
+  source_location last_loc;
+  const cpp_token **tokens;
+  _cpp_buff *buff;
+  unsigned int i;
+
+  cache->lookups++;
+  entry = (struct expansion_entry *) htab_find_with_hash (cache->entries,
+							  key, key->hash);
+  if (entry == NULL)
+    return false;
+
+  for (i = 0; i < entry->nuses; i++)
+    if (((entry->uses[i].node->flags & NODE_DISABLED) != 0)
+	!= entry->uses[i].disabled)
+      return false;
+
+  for (i = 0; i < entry->naliases; i++)
+    {
+      const unsigned int *alias = &entry->aliases[i * 4];
+
+      if (key->args[alias[0]].first[alias[1]]
+	  != key->args[alias[2]].first[alias[3]])
+	return false;
+    }
+
+  last_loc = pfile->cur_token[-1].src_loc;
+  if (entry->last_column >= 0
+      && last_loc != pfile->line_table->highest_line + entry->last_column)
+    return false;
+
+  cache->hits++;
+  if (pfile->expansion_record)
+    expansion_record_uses (pfile, pfile->expansion_record,
+			   entry->uses, entry->nuses);
+
+  buff = _cpp_get_buff (pfile, entry->count * sizeof (cpp_token *));
+  tokens = (const cpp_token **) buff->base;
+  memcpy (tokens, entry->tokens, entry->count * sizeof (cpp_token *));
+  for (i = 0; i < entry->nfixups; i++)
+    {
+      const struct expansion_fixup *fixup = &entry->fixups[i];
+      cpp_token *token;
+
+      if (fixup->kind == EXPANSION_FIXUP_ARG)
+	{
+	  tokens[fixup->index] = key->args[fixup->arg].first[fixup->pos];
+	  continue;
+	}
+
+      token = _cpp_temp_token (pfile);
+      *token = *entry->tokens[fixup->index];
+      if (fixup->kind == EXPANSION_FIXUP_LAST)
+	token->src_loc = last_loc;
+      else
+	LINEMAP_POSITION_FOR_COLUMN (token->src_loc, pfile->line_table,
+				     fixup->pos);
+      tokens[fixup->index] = token;
+    }
+
+  push_ptoken_context (pfile, key->node, buff, tokens, entry->count);
+  return true;
+}
+
+/* Start recording the expansion into RECORD, and return true, unless
+   the cache is full.  The expansions nested in one being recorded are
+   always recorded, as it depends on the identifiers they use.  */
+static bool
+expansion_record_start (cpp_reader *pfile,
+			struct _cpp_expansion_record *record)
+{
+  struct _cpp_expansion_cache *cache = pfile->expansion_cache;
+
+  if (pfile->expansion_record == NULL
+      && (cache->nentries >= EXPANSION_CACHE_MAX_ENTRIES
+	  || cache->ntokens >= EXPANSION_CACHE_MAX_TOKENS))
+    return false;
+
+  record->prev = pfile->expansion_record;
+  record->base = pfile->context;
+  record->tainted = false;
+  record->last_loc = pfile->cur_token[-1].src_loc;
+  record->line = pfile->line_table->highest_line;
+  record->uses = NULL;
+  record->nuses = record->uses_alloc = 0;
+  pfile->expansion_record = record;
+  return true;
+}
+
+/* Order pointers to the tokens of the arguments of a macro by token,
+   for qsort and bsearch.  */
+static int
+expansion_position_cmp (const void *p1, const void *p2)
+{
+  const cpp_token *a = **(const cpp_token **const *) p1;
+  const cpp_token *b = **(const cpp_token **const *) p2;
+
+  if (a != b)
+    return a < b ? -1 : 1;
+  return 0;
+}
+
+/* Store in *ARG and *POS the argument among the PARAMC ARGS and the
+   position in it of P.  */
+static void
+expansion_position (const macro_arg *args, unsigned int paramc,
+		    const cpp_token **p, unsigned int *arg, unsigned int *pos)
+{
+  unsigned int i;
+
+  for (i = 0; i < paramc; i++)
+    if (args[i].first && p >= args[i].first
+	&& p < args[i].first + args[i].count)
+      {
+	*arg = i;
+	*pos = p - args[i].first;
+	return;
+      }
+  abort ();
+}
+
+/* Return true if TOKEN is in the token runs of PFILE, as the tokens
+   lexed and the temporary tokens are.  */
+static bool
+expansion_run_token_p (cpp_reader *pfile, const cpp_token *token)
+{
+  tokenrun *run;
+
+  for (run = pfile->cur_run; run; run = run->prev)
+    if (token >= run->base && token < run->limit)
+      return true;
+  for (run = pfile->cur_run->next; run; run = run->next)
+    if (token >= run->base && token < run->limit)
+      return true;
+  return false;
+}
+
+/* Add to ENTRY, recorded into RECORD, the fixups rebuilding the COUNT
+   tokens of the replacement list at FIRST, and copy the other tokens.
+   Return false if the tokens cannot be rebuilt.  */
+static bool
+expansion_record_tokens (cpp_reader *pfile,
+			 struct _cpp_expansion_record *record,
+			 struct expansion_entry *entry,
+			 const macro_arg *args,
+			 const cpp_token **first, unsigned int count)
+{
+  const cpp_macro *macro = entry->node->value.macro;
+  unsigned int i, j, paramc = macro->paramc, npositions = 0;
+  unsigned int fixups_alloc = 0, aliases_alloc = 0;
+  source_location columns = pfile->line_table->max_column_hint;
+  const cpp_token ***positions;
+  bool ok = true;
+
+  /* Sort the positions of the tokens of the arguments by token, noting
+     the positions which hold the same token.  */
+  for (i = 0; i < paramc; i++)
+    if (args[i].first)
+      npositions += args[i].count;
+  positions = XNEWVEC (const cpp_token **, npositions);
+  npositions = 0;
+  for (i = 0; i < paramc; i++)
+    for (j = 0; args[i].first && j < args[i].count; j++)
+      positions[npositions++] = &args[i].first[j];
+  qsort (positions, npositions, sizeof (const cpp_token **),
+	 expansion_position_cmp);
+  for (i = 1; i < npositions; i++)
+    if (*positions[i] == *positions[i - 1])
+      {
+	unsigned int *alias;
+
+	if (entry->naliases == aliases_alloc)
+	  {
+	    aliases_alloc = aliases_alloc * 2 + 4;
+	    entry->aliases = XRESIZEVEC (unsigned int, entry->aliases,
+					 aliases_alloc * 4);
+	  }
+	alias = &entry->aliases[entry->naliases++ * 4];
+	expansion_position (args, paramc, positions[i - 1],
+			    &alias[0], &alias[1]);
+	expansion_position (args, paramc, positions[i], &alias[2], &alias[3]);
+      }
+
+  entry->tokens = XNEWVEC (const cpp_token *, count);
+  entry->count = count;
+  entry->last_column = -1;
+  for (i = 0; ok && i < count; i++)
+    {
+      const cpp_token *token = first[i];
+      const cpp_token **key = &token, ***p;
+      struct expansion_fixup fixup;
+
+      p = (const cpp_token ***) bsearch (&key, positions, npositions,
+					 sizeof (const cpp_token **),
+					 expansion_position_cmp);
+      if (p)
+	{
+	  entry->tokens[i] = NULL;
+	  fixup.kind = EXPANSION_FIXUP_ARG;
+	  expansion_position (args, paramc, *p, &fixup.arg, &fixup.pos);
+	}
+      else
+	{
+	  entry->tokens[i] = expansion_copy_token (pfile, token, macro);
+	  if (token->type != CPP_NAME || (token->flags & NO_EXPAND))
+	    continue;
+
+	  /* A temporary token is at the location of the last token
+	     lexed, or of the previous temporary token, which can be a
+	     pasted one on the current line.  */
+	  fixup.arg = fixup.pos = 0;
+	  if (token->src_loc == record->last_loc)
+	    {
+	      fixup.kind = EXPANSION_FIXUP_LAST;
+	      if (record->last_loc >= record->line
+		  && record->last_loc - record->line < columns)
+		entry->last_column = record->last_loc - record->line;
+	    }
+	  else if (token->src_loc >= record->line
+		   && token->src_loc - record->line < columns)
+	    {
+	      fixup.kind = EXPANSION_FIXUP_COLUMN;
+	      fixup.pos = token->src_loc - record->line;
+	    }
+	  else
+	    continue;
+
+	  if (!expansion_run_token_p (pfile, token))
+	    {
+	      ok = false;
+	      break;
+	    }
+	}
+
+      fixup.index = i;
+      if (entry->nfixups == fixups_alloc)
+	{
+	  fixups_alloc = fixups_alloc * 2 + 8;
+	  entry->fixups = XRESIZEVEC (struct expansion_fixup, entry->fixups,
+				      fixups_alloc);
+	}
+      entry->fixups[entry->nfixups++] = fixup;
+    }
+
+  free (positions);
+  return ok;
+}
+
+/* Stop recording into RECORD the expansion of KEY, whose replacement
+   list is the COUNT tokens at FIRST, and enter it in the cache unless
+   it cannot be cached.  */
+static void
+expansion_record_finish (cpp_reader *pfile,
+			 struct _cpp_expansion_record *record,
+			 struct expansion_entry *key,
+			 const cpp_token **first, unsigned int count)
+{
+  struct _cpp_expansion_cache *cache = pfile->expansion_cache;
+  const cpp_macro *macro = key->node->value.macro;
+  struct expansion_entry *entry;
+  unsigned int i, j;
+  void **slot;
+
+  /* The entry depends on the macro itself too.  */
+  if (!record->tainted)
+    {
+      expansion_record_lookup (pfile, key->node);
+      qsort (record->uses, record->nuses, sizeof (struct expansion_use),
+	     expansion_use_cmp);
+      for (i = j = 0; i < record->nuses; i++)
+	if (j == 0
+	    || record->uses[j - 1].node != record->uses[i].node
+	    || record->uses[j - 1].disabled != record->uses[i].disabled)
+	  record->uses[j++] = record->uses[i];
+      record->nuses = j;
+    }
+
+  pfile->expansion_record = record->prev;
+  if (record->prev)
+    {
+      if (record->tainted)
+	record->prev->tainted = true;
+      else
+	expansion_record_uses (pfile, record->prev,
+			       record->uses, record->nuses);
+    }
+
+  /* Pasting a token on a long line can start a new line map, and the
+     columns of the pasted tokens cannot be recomputed then.  */
+  if (record->tainted
+      || pfile->line_table->highest_line != record->line
+      || cache->nentries >= EXPANSION_CACHE_MAX_ENTRIES
+      || cache->ntokens >= EXPANSION_CACHE_MAX_TOKENS)
+    {
+      free (record->uses);
+      return;
+    }
+
+  entry = XCNEW (struct expansion_entry);
+  entry->hash = key->hash;
+  entry->node = key->node;
+  entry->state = key->state;
+  entry->args = XCNEWVEC (macro_arg, macro->paramc);
+  entry->uses = record->uses;
+  entry->nuses = record->nuses;
+  if (!expansion_record_tokens (pfile, record, entry, key->args,
+				first, count))
+    {
+      expansion_entry_free (entry);
+      return;
+    }
+
+  for (i = 0; i < macro->paramc; i++)
+    {
+      const cpp_token **tokens = NULL;
+
+      if (key->args[i].first)
+	{
+	  tokens = XOBNEWVEC (&cache->tokens, const cpp_token *,
+			      key->args[i].count);
+	  for (j = 0; j < key->args[i].count; j++)
+	    tokens[j] = expansion_copy_token (pfile, key->args[i].first[j],
+					      macro);
+	}
+      entry->args[i].first = tokens;
+      entry->args[i].count = key->args[i].count;
+    }
+
+  for (i = 0; i < entry->nuses; i++)
+    entry->uses[i].node->flags |= NODE_EXPANSION_CACHED;
+
+  slot = htab_find_slot_with_hash (cache->entries, key, key->hash, INSERT);
+  if (*slot)
+    expansion_entry_free (*slot);
+  else
+    cache->nentries++;
+  *slot = entry;
+}
+
+/* Callback for htab_traverse: drop the entry in SLOT if it depends on
+   the identifier DATA.  */
+static int
+expansion_cache_forget_1 (void **slot, void *data)
+{
+  struct expansion_entry *entry = (struct expansion_entry *) *slot;
+  cpp_reader *pfile = (cpp_reader *) data;
+  cpp_hashnode *node = pfile->expansion_cache->forgetting;
+  unsigned int i;
+
+  for (i = 0; i < entry->nuses; i++)
+    if (entry->uses[i].node == node)
+      {
+	htab_clear_slot (pfile->expansion_cache->entries, slot);
+	pfile->expansion_cache->nentries--;
+	pfile->expansion_cache->forgotten++;
+	break;
+      }
+  return 1;
+}
+
+/* Drop the expansions in the cache which depend on NODE, which is
+   about to be defined or undefined, or all of them if NODE is null.  */
+void
+_cpp_expansion_cache_forget (cpp_reader *pfile, cpp_hashnode *node)
+{
+  struct _cpp_expansion_cache *cache = pfile->expansion_cache;
+
+  if (cache == NULL)
+    return;
+
+  if (node == NULL)
+    {
+      cache->forgotten += cache->nentries;
+      cache->nentries = 0;
+      htab_empty (cache->entries);
+    }
+  else if (node->flags & NODE_EXPANSION_CACHED)
+    {
+      cache->forgetting = node;
+      htab_traverse_noresize (cache->entries, expansion_cache_forget_1,
+			      pfile);
+      node->flags &= ~NODE_EXPANSION_CACHED;
+    }
+}
+
+/* Free the expansion cache of PFILE.  */
+void
+_cpp_destroy_expansion_cache (cpp_reader *pfile)
+{
+  struct _cpp_expansion_cache *cache = pfile->expansion_cache;
+
+  if (cache == NULL)
+    return;
+
+  htab_delete (cache->entries);
+  obstack_free (&cache->tokens, 0);
+  free (cache);
+  pfile->expansion_cache = NULL;
+}
+
+/* Return in *LOOKUPS, *HITS and *FORGOTTEN the number of invocations
+   looked up in the expansion cache, the number found there and the
+   number of entries dropped because a macro they depend on changed.  */
+void
+cpp_get_expansion_cache_stats (cpp_reader *pfile, unsigned long *lookups,
+			       unsigned long *hits, unsigned long *forgotten)
+{
+  struct _cpp_expansion_cache *cache = pfile->expansion_cache;
+
+  *lookups = cache ? cache->lookups : 0;
+  *hits = cache ? cache->hits : 0;
+  *forgotten = cache ? cache->forgotten : 0;
+}
+
+/* Return the expansion cache of PFILE, creating it if needed, or NULL
+   if expansions cannot be cached.  */
+static struct _cpp_expansion_cache *
+expansion_cache (cpp_reader *pfile)
+{
+  struct _cpp_expansion_cache *cache = pfile->expansion_cache;
+
+  /* The callbacks must see every use of a macro.  */
+  if (!CPP_OPTION (pfile, expansion_cache)
+      || pfile->cb.used || pfile->cb.used_define)
+    return NULL;
+
+  if (cache == NULL)
+    {
+      cache = XCNEW (struct _cpp_expansion_cache);
+      cache->entries = htab_create_alloc (1024, expansion_entry_hash,
+					  expansion_entry_eq,
+					  expansion_entry_free,
+					  xcalloc, free);
+      _obstack_begin (&cache->tokens, 0, 0,
+		      (void *(*) (long)) xmalloc,
+		      (void (*) (void *)) free);
+      pfile->expansion_cache = cache;
+    }
+  return cache;
+}
+
 /* Replace the parameters in a function-like macro of NODE with the
    actual ARGS, and place the result in a newly pushed token context.
    Expand each argument before replacing, unless it is operated upon
@@ -935,6 +1758,18 @@ replace_args (cpp_reader *pfile, cpp_hashnode *node, cpp_macro *macro, macro_arg
   macro_arg *arg;
   _cpp_buff *buff;
   unsigned int count;
+  struct _cpp_expansion_record record;
+  struct expansion_entry key;
+  bool cache_p = false;
+
+  /* Reuse the replacement list of a previous identical invocation, or
+     record this one.  */
+  if (expansion_cache (pfile) && expansion_key (pfile, node, args, &key))
+    {
+      if (expansion_cache_lookup (pfile, &key))
+	return;
+      cache_p = expansion_record_start (pfile, &record);
+    }
 
   /* First, fully macro-expand arguments, calculating the number of
      tokens in the final expansion as we go.  The ordering of the if
@@ -1067,6 +1902,9 @@ replace_args (cpp_reader *pfile, cpp_hashnode *node, cpp_macro *macro, macro_arg
     if (args[i].expanded)
       free (args[i].expanded);
 
+  if (cache_p)
+    expansion_record_finish (pfile, &record, &key, first, dest - first);
+
   push_ptoken_context (pfile, node, buff, first, dest - first);
 }
 
@@ -1269,6 +2107,9 @@ cpp_get_token (cpp_reader *pfile)
 
       node = result->val.node.node;
 
+      if (pfile->expansion_record && !(result->flags & NO_EXPAND))
+	expansion_record_lookup (pfile, node);
+
       if (node->type != NT_MACRO || (result->flags & NO_EXPAND))
 	break;
 
@@ -1286,6 +2127,7 @@ cpp_get_token (cpp_reader *pfile)
 	     first.  */
 	  if ((node->flags & NODE_CONDITIONAL) != 0)
 	    {
+	      _cpp_expansion_cache_taint (pfile);
 	      if (pfile->cb.macro_to_expand)
 		{
 		  bool whitespace_after;
@@ -1917,6 +2759,7 @@ _cpp_create_definition (cpp_reader *pfile, cpp_hashnode *node)
 	}
     }
 
+  _cpp_expansion_cache_forget (pfile, node);
   if (node->type != NT_VOID)
     _cpp_free_definition (node);
 
@@ -188,6 +188,67 @@ cpp_string_eq (const void *a_p, const void *b_p)
 	  && memcmp (a->text, b->text, a->len) == 0);
 }
 
+/* Free a cpp string allocated by save_pch_macro.  */
+
+static void
+free_cpp_string (void *a_p)
+{
+  struct cpp_string *a = (struct cpp_string *) a_p;
+  free ((void *) a->text);
+  free (a);
+}
+
+/* Save the definition of this macro into the hash table SS_P.  */
+
+static int
+save_pch_macro (cpp_reader *pfile, cpp_hashnode *hn, void *ss_p)
+{
+  htab_t definedhash = (htab_t) ss_p;
+
+  if (hn->type == NT_MACRO && !(hn->flags & NODE_BUILTIN))
+    {
+      const unsigned char *defn = cpp_macro_definition (pfile, hn);
+      struct cpp_string news;
+      void **slot;
+
+      news.len = ustrlen (defn);
+      news.text = defn;
+      slot = htab_find_slot (definedhash, &news, INSERT);
+      if (*slot == NULL)
+	{
+	  struct cpp_string *sp;
+	  unsigned char *text;
+
+	  sp = XNEW (struct cpp_string);
+	  *slot = sp;
+
+	  sp->len = news.len;
+	  sp->text = text = XNEWVEC (unsigned char, news.len);
+	  memcpy (text, defn, news.len);
+	}
+    }
+
+  return 1;
+}
+
+/* Return true if HN is a macro that is still defined as it was right
+   after the last precompiled header was read.  */
+
+static bool
+pch_macro_unchanged (cpp_reader *r, cpp_hashnode *hn)
+{
+  struct cpp_string news;
+
+  if (r->pch_macros == NULL
+      || hn->type != NT_MACRO
+      || (hn->flags & NODE_BUILTIN))
+    return false;
+
+  news.text = cpp_macro_definition (r, hn);
+  news.len = ustrlen (news.text);
+  return htab_find (r->pch_macros, &news) != NULL;
+}
+
 /* Save the current definitions of the cpp_reader for dependency
    checking purposes.  When writing a precompiled header, this should
    be called at the same point in the compilation as cpp_valid_state
@@ -676,6 +737,15 @@ cpp_valid_state (cpp_reader *r, const char *name, int fd)
  	first += ustrlen (first) + 1;
       else if (cmp > 0)
  	++i;
+      else if (pch_macro_unchanged (r, nl.defs[i]))
+	{
+	  /* The macro comes from the precompiled header that was read
+	     last.  The caller only gets here for a precompiled header
+	     that was built on top of that one, which saw the same
+	     definition.  */
+	  first += ustrlen (first) + 1;
+	  ++i;
+	}
       else
 	{
 	  if (CPP_OPTION (r, warn_invalid_pch))
@@ -818,6 +888,9 @@ cpp_read_state (cpp_reader *r, const char *name, FILE *f,
   struct lexer_state old_state;
   unsigned int counter;
 
+  /* The expansion cache refers to the old hashtable entries too.  */
+  _cpp_expansion_cache_forget (r, NULL);
+
   /* Restore spec_nodes, which will be full of references to the old
      hashtable entries and so will now be invalid.  */
   {
@@ -885,6 +958,14 @@ cpp_read_state (cpp_reader *r, const char *name, FILE *f,
   /* Read pushed macros. */
   if (! _cpp_restore_pushed_macros (r, f))
     goto error;
+
+  /* Remember how the macros are defined now, for a precompiled header
+     built on top of this one.  */
+  if (r->pch_macros)
+    htab_delete (r->pch_macros);
+  r->pch_macros = htab_create (100, cpp_string_hash, cpp_string_eq,
+			       free_cpp_string);
+  cpp_forall_identifiers (r, save_pch_macro, r->pch_macros);
   return 0;
 
  error:
@@ -0,0 +1,55 @@
+/* { dg-do run } */
+/* { dg-options "-ftree-parallelize-loops=4 -O2 -ffast-math" } */
+
+extern void abort (void);
+
+#define N 512
+
+double d[N][N];
+int f[N][N];
+
+/* Sums over both loops of a nest, with the outer loop parallelized;
+   small trip counts run serially.  */
+
+double __attribute__((noinline))
+foo (int n)
+{
+  double s = 1.0;
+  int i, j;
+  for (i = 0; i < n; i++)
+    for (j = 0; j < n; j++)
+      s += d[i][j];
+  return s;
+}
+
+int __attribute__((noinline))
+bar (int n)
+{
+  int s = 0, i, j;
+  for (i = 0; i < n; i++)
+    for (j = 0; j < N; j++)
+      s ^= f[i][j];
+  return s;
+}
+
+int
+main (void)
+{
+  int i, j, n, s;
+  for (i = 0; i < N; i++)
+    for (j = 0; j < N; j++)
+      {
+	d[i][j] = 1.0;
+	f[i][j] = i * N + j;
+      }
+  for (n = 0; n <= N; n += 31)
+    {
+      s = 0;
+      for (i = 0; i < n; i++)
+	for (j = 0; j < N; j++)
+	  s ^= i * N + j;
+      if (foo (n) != 1.0 + n * n || bar (n) != s)
+	abort ();
+    }
+  return 0;
+}